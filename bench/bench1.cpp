@@ -0,0 +1,115 @@
+/**
+ *  @file bench1.cpp
+ *  @brief Benchmark of the virtual MathParser against the inlined core
+ *  @details Calculates the same expressions through the MathParser interface
+ *  (setVariableDouble() and calculateExpression() for every row, and one
+ *  calculateBatch()) and through the CompiledFunction of pssmathcore.h in the
+ *  loop of this program. Built with `make bench` against the static library.
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "pssmathparser.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+#define ROWS 1000000
+
+// Nanoseconds per row since the start
+double nsPerRow(const chrono::steady_clock::time_point &a_start)
+{
+    chrono::duration<double, nano> elapsed =
+            chrono::steady_clock::now() - a_start;
+    return elapsed.count() / ROWS;
+}
+
+int main()
+{
+    const string expressions[] = {
+        "2*sin(2*pi*f*t+phi)",
+        "Io*(exp(qe*V/(kBJ*(ToK+TC)))-1)",
+        "a*(b+c*(d-e*(f+g*(h-i))))"
+    };
+    cout << "Rows: " << ROWS << ", time in ns per row" << endl << endl;
+    cout << setw(36) << left << "expression" << right
+         << setw(10) << "virtual" << setw(10) << "batch"
+         << setw(10) << "inlined" << endl;
+
+    MathParser *mp = MathParser::makeMathParser();
+    bool failed = false;
+    for (const string &expression : expressions) {
+        mp->setMath(expression);
+        uint16_t numVariables = mp->getVariableSize();
+        vector<string> names;
+        vector<vector<double>> columns(numVariables);
+        vector<const double *> columnPointers;
+        for (uint16_t j = 0; j < numVariables; j++) {
+            names.push_back(mp->getVariableName(j));
+            for (size_t i = 0; i < ROWS; i++)
+                columns[j].push_back(0.5 + 1.0e-6 * double(i + j));
+            columnPointers.push_back(columns[j].data());
+        }
+        vector<double> virtualResults(ROWS), batchResults(ROWS),
+                inlinedResults(ROWS);
+
+        // Virtual calls for every row
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < ROWS; i++) {
+            for (uint16_t j = 0; j < numVariables; j++)
+                mp->setVariableDouble(names[j], columns[j][i]);
+            virtualResults[i] = mp->calculateExpression();
+        }
+        double virtualTime = nsPerRow(start);
+
+        // One virtual call for all rows
+        start = chrono::steady_clock::now();
+        mp->calculateBatch(columnPointers.data(), batchResults.data(), ROWS);
+        double batchTime = nsPerRow(start);
+
+        // Core inlined in this loop
+        CompiledFunction function = mp->compiledFunction();
+        vector<double> variables(numVariables);
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < ROWS; i++) {
+            for (uint16_t j = 0; j < numVariables; j++)
+                variables[j] = columns[j][i];
+            inlinedResults[i] = function(variables.data());
+        }
+        double inlinedTime = nsPerRow(start);
+
+        if (virtualResults != batchResults || virtualResults != inlinedResults)
+            failed = true;
+        cout << setw(36) << left << expression << right << fixed
+             << setprecision(1) << setw(10) << virtualTime
+             << setw(10) << batchTime << setw(10) << inlinedTime << endl;
+        mp->clear();
+    }
+    delete mp;
+
+    if (failed) {
+        cout << endl << "Error: results differ" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+/**
+ *  @file bench2.cpp
+ *  @brief Benchmark of the parallel batch on 1 to N threads
+ *  @details Calculates the same expressions with calculateBatchParallel() on
+ *  thread pools of 1, 2, 4, ... threads up to the number of cores and prints
+ *  the speedup against one thread. The optional argument is the highest
+ *  number of threads. Built with `make bench` against the static library.
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "pssmathparser.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+#define ROWS 4000000
+
+// Nanoseconds per row since the start
+double nsPerRow(const chrono::steady_clock::time_point &a_start)
+{
+    chrono::duration<double, nano> elapsed =
+            chrono::steady_clock::now() - a_start;
+    return elapsed.count() / ROWS;
+}
+
+int main(int argc, char *argv[])
+{
+    const string expressions[] = {
+        "2*sin(2*pi*f*t+phi)",
+        "Io*(exp(qe*V/(kBJ*(ToK+TC)))-1)",
+        "a*(b+c*(d-e*(f+g*(h-i))))"
+    };
+    unsigned maxThreads = thread::hardware_concurrency();
+    if (argc > 1)
+        maxThreads = static_cast<unsigned>(atoi(argv[1]));
+    if (maxThreads == 0)
+        maxThreads = 1;
+    vector<unsigned> threadCounts;
+    for (unsigned n = 1; n < maxThreads; n *= 2)
+        threadCounts.push_back(n);
+    threadCounts.push_back(maxThreads);
+
+    cout << "Rows: " << ROWS << ", time in ns per row, speedup against one "
+         << "thread" << endl << endl;
+    cout << setw(36) << left << "expression" << right << setw(10) << "threads"
+         << setw(10) << "time" << setw(10) << "speedup"
+         << setw(12) << "efficiency" << endl;
+
+    MathParser *mp = MathParser::makeMathParser();
+    bool failed = false;
+    for (const string &expression : expressions) {
+        mp->setMath(expression);
+        uint16_t numVariables = mp->getVariableSize();
+        vector<vector<double>> columns(numVariables);
+        vector<const double *> columnPointers;
+        for (uint16_t j = 0; j < numVariables; j++) {
+            for (size_t i = 0; i < ROWS; i++)
+                columns[j].push_back(0.5 + 1.0e-6 * double(i + j));
+            columnPointers.push_back(columns[j].data());
+        }
+        vector<double> expected(ROWS), results(ROWS);
+        mp->calculateBatch(columnPointers.data(), expected.data(), ROWS);
+
+        double oneThread = 0.0;
+        for (unsigned threads : threadCounts) {
+            ThreadPool pool(threads);
+            // First run starts the workers and brings the columns in cache
+            mp->calculateBatchParallel(columnPointers.data(), results.data(),
+                                       ROWS, &pool);
+            auto start = chrono::steady_clock::now();
+            mp->calculateBatchParallel(columnPointers.data(), results.data(),
+                                       ROWS, &pool);
+            double time = nsPerRow(start);
+            if (threads == 1)
+                oneThread = time;
+            if (results != expected)
+                failed = true;
+            cout << setw(36) << left << expression << right << fixed
+                 << setw(10) << threads << setprecision(2) << setw(10) << time
+                 << setw(10) << oneThread / time
+                 << setw(12) << oneThread / time / threads << endl;
+        }
+        mp->clear();
+    }
+    delete mp;
+
+    if (failed) {
+        cout << endl << "Error: results differ" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,228 @@
+/**
+ *  @file ../bin/aot7.h
+ *  @brief Generated by pssmathaot from input7.txt
+ **/
+
+#ifndef AOT7_H
+#define AOT7_H
+
+#include <math.h>
+#include <stddef.h>
+
+namespace aot {
+
+/**
+ * @brief sin(x)*cos(y)+tan(x/y)
+ * @details Columns of the variables: 0 x, 1 y
+ */
+inline void expression1(const double *const *variables,
+                        double *results,
+                        const size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        const double s0 = variables[0][i];
+        const double s2 = sin(s0);
+        const double s1 = variables[1][i];
+        const double s3 = cos(s1);
+        const double s4 = s2 * s3;
+        const double s5 = s0 / s1;
+        const double s6 = tan(s5);
+        const double s7 = s4 + s6;
+        results[i] = s7;
+    }
+}
+
+/**
+ * @brief sqrt(a^(2)+b^(2))
+ * @details Columns of the variables: 0 a, 1 b
+ */
+inline void expression2(const double *const *variables,
+                        double *results,
+                        const size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        const double s0 = variables[0][i];
+        const double s2 = 0x1p+1;
+        const double s3 = pow(s0, s2);
+        const double s1 = variables[1][i];
+        const double s4 = 0x1p+1;
+        const double s5 = pow(s1, s4);
+        const double s6 = s3 + s5;
+        const double s7 = sqrt(s6);
+        results[i] = s7;
+    }
+}
+
+/**
+ * @brief cos(2*pi*3*t)*exp(-pi*t^(2))
+ * @details Columns of the variables: 0 t
+ */
+inline void expression3(const double *const *variables,
+                        double *results,
+                        const size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        const double s0 = variables[0][i];
+        const double s2 = 0x1p+1;
+        const double s3 = pow(s0, s2);
+        const double s4 = 0x1.921fb54442d18p+1;
+        const double s5 = s3 * s4;
+        const double s1 = 0x0p+0;
+        const double s6 = s1 - s5;
+        const double s7 = exp(s6);
+        const double s8 = 0x1p+1;
+        const double s9 = s8 * s4;
+        const double s10 = 0x1.8p+1;
+        const double s11 = s9 * s10;
+        const double s12 = s11 * s0;
+        const double s13 = cos(s12);
+        const double s14 = s7 * s13;
+        results[i] = s14;
+    }
+}
+
+/**
+ * @brief 2*sin(2*pi*f*t+phi)
+ * @details Columns of the variables: 0 f, 1 t, 2 phi
+ */
+inline void expression4(const double *const *variables,
+                        double *results,
+                        const size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        const double s3 = 0x1p+1;
+        const double s4 = 0x1.921fb54442d18p+1;
+        const double s5 = s3 * s4;
+        const double s0 = variables[0][i];
+        const double s6 = s5 * s0;
+        const double s1 = variables[1][i];
+        const double s7 = s1 * s6;
+        const double s2 = variables[2][i];
+        const double s8 = s2 + s7;
+        const double s9 = sin(s8);
+        const double s10 = 0x1p+1;
+        const double s11 = s9 * s10;
+        results[i] = s11;
+    }
+}
+
+/**
+ * @brief a*(b+c*(d-e*(f+g*(h-i*(j+k*(l-m*(n+o*(p-q*(r+s*(u-v*(w+z)))))))))))
+ * @details Columns of the variables: 0 a, 1 b, 2 c, 3 d, 4 e, 5 f, 6 g, 7 h, 8 i, 9 j, 10 k, 11 l, 12 m, 13 n, 14 o, 15 p, 16 q, 17 r, 18 s, 19 u, 20 v, 21 w, 22 z
+ */
+inline void expression5(const double *const *variables,
+                        double *results,
+                        const size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        const double s21 = variables[21][i];
+        const double s22 = variables[22][i];
+        const double s23 = s21 + s22;
+        const double s20 = variables[20][i];
+        const double s24 = s23 * s20;
+        const double s19 = variables[19][i];
+        const double s25 = s19 - s24;
+        const double s18 = variables[18][i];
+        const double s26 = s18 * s25;
+        const double s17 = variables[17][i];
+        const double s27 = s26 + s17;
+        const double s16 = variables[16][i];
+        const double s28 = s27 * s16;
+        const double s15 = variables[15][i];
+        const double s29 = s15 - s28;
+        const double s14 = variables[14][i];
+        const double s30 = s14 * s29;
+        const double s13 = variables[13][i];
+        const double s31 = s13 + s30;
+        const double s12 = variables[12][i];
+        const double s32 = s31 * s12;
+        const double s11 = variables[11][i];
+        const double s33 = s11 - s32;
+        const double s10 = variables[10][i];
+        const double s34 = s10 * s33;
+        const double s9 = variables[9][i];
+        const double s35 = s9 + s34;
+        const double s8 = variables[8][i];
+        const double s36 = s35 * s8;
+        const double s7 = variables[7][i];
+        const double s37 = s7 - s36;
+        const double s6 = variables[6][i];
+        const double s38 = s37 * s6;
+        const double s5 = variables[5][i];
+        const double s39 = s5 + s38;
+        const double s4 = variables[4][i];
+        const double s40 = s39 * s4;
+        const double s3 = variables[3][i];
+        const double s41 = s3 - s40;
+        const double s2 = variables[2][i];
+        const double s42 = s41 * s2;
+        const double s1 = variables[1][i];
+        const double s43 = s1 + s42;
+        const double s0 = variables[0][i];
+        const double s44 = s43 * s0;
+        results[i] = s44;
+    }
+}
+
+/**
+ * @brief kBJ*(ToK+TC)/qe-kBeV*(ToK+TC)
+ * @details Columns of the variables: 0 TC
+ */
+inline void expression6(const double *const *variables,
+                        double *results,
+                        const size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        const double s1 = 0x1.1126666666666p+8;
+        const double s0 = variables[0][i];
+        const double s2 = s1 + s0;
+        const double s3 = 0x1.0b0e674035e1ap-76;
+        const double s4 = s2 * s3;
+        const double s5 = 0x1.7a4da25c77015p-63;
+        const double s6 = s4 / s5;
+        const double s7 = s1 + s0;
+        const double s8 = 0x1.696fe129c056ep-14;
+        const double s9 = s7 * s8;
+        const double s10 = s6 - s9;
+        results[i] = s10;
+    }
+}
+
+/**
+ * @brief x
+ * @details Columns of the variables: 0 x
+ */
+inline void expression7(const double *const *variables,
+                        double *results,
+                        const size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        const double s0 = variables[0][i];
+        results[i] = s0;
+    }
+}
+
+/**
+ * @brief 3.5e-3*x^(-2)/(x-y)
+ * @details Columns of the variables: 0 x, 1 y
+ */
+inline void expression8(const double *const *variables,
+                        double *results,
+                        const size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        const double s0 = variables[0][i];
+        const double s2 = -0x1p+1;
+        const double s3 = pow(s0, s2);
+        const double s4 = 0x1.cac083126e979p-9;
+        const double s5 = s3 * s4;
+        const double s1 = variables[1][i];
+        const double s6 = s0 - s1;
+        const double s7 = s5 / s6;
+        results[i] = s7;
+    }
+}
+
+}
+
+#endif // AOT7_H
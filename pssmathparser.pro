@@ -26,13 +26,57 @@ DEFINES += QT_DEPRECATED_WARNINGS
 # disables all the APIs deprecated before Qt 6.0.0
 # DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
 
-SOURCES += $$PWD/src/pssmathparser.cpp
+SOURCES += $$PWD/src/pssmathparser.cpp \
+           $$PWD/src/pssmathnative.cpp \
+           $$PWD/src/pssmathjit.cpp \
+           $$PWD/src/pssmathcodegen.cpp \
+           $$PWD/src/pssmathcompiler.cpp \
+           $$PWD/src/pssmaththreadpool.cpp \
+           $$PWD/src/pssmathschedule.cpp \
+           $$PWD/src/pssmathjobs.cpp \
+           $$PWD/src/pssmathhandle.cpp \
+           $$PWD/src/pssmathprocess.cpp \
+           $$PWD/src/pssmathcache.cpp \
+           $$PWD/src/pssmathshare.cpp \
+           $$PWD/src/pssmathincremental.cpp \
+           $$PWD/src/pssmathgraph.cpp \
+           $$PWD/src/pssmathlink.cpp \
+           $$PWD/src/pssmathedit.cpp \
+           $$PWD/src/pssmathmemo.cpp \
+           $$PWD/src/pssmathtable.cpp \
+           $$PWD/src/pssmathchebyshev.cpp \
+           $$PWD/src/pssmathimage.cpp
+
+unix: LIBS += -ldl -pthread
+linux: LIBS += -lrt
+CONFIG += thread
 
 # This so you can call .h files like: #include "pssmathparser.h"
 INCLUDEPATH += $$PWD/src
 
 HEADERS += $$PWD/src/pssmathparser_global.h \
-           $$PWD/src/pssmathparser.h
+           $$PWD/src/pssmathparser.h \
+           $$PWD/src/pssmathnative.h \
+           $$PWD/src/pssmathjit.h \
+           $$PWD/src/pssmathcodegen.h \
+           $$PWD/src/pssmathcompiler.h \
+           $$PWD/src/pssmathliteral.h \
+           $$PWD/src/pssmathcore.h \
+           $$PWD/src/pssmaththreadpool.h \
+           $$PWD/src/pssmathschedule.h \
+           $$PWD/src/pssmathjobs.h \
+           $$PWD/src/pssmathhandle.h \
+           $$PWD/src/pssmathprocess.h \
+           $$PWD/src/pssmathcache.h \
+           $$PWD/src/pssmathshare.h \
+           $$PWD/src/pssmathincremental.h \
+           $$PWD/src/pssmathgraph.h \
+           $$PWD/src/pssmathlink.h \
+           $$PWD/src/pssmathedit.h \
+           $$PWD/src/pssmathmemo.h \
+           $$PWD/src/pssmathtable.h \
+           $$PWD/src/pssmathchebyshev.h \
+           $$PWD/src/pssmathimage.h
 
 # CONFIG(debug, debug|release) evaluates to true if CONFIG contains
 # "debug" but not "release", or if it contains both "debug" and "release"
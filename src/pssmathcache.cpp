@@ -0,0 +1,168 @@
+/**
+ *  @file pssmathcache.cpp
+ *  @brief Cache of compiled expressions of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathcache.h"
+
+using namespace PssMathParser;
+
+/**
+ * @brief Constructor of an empty cache
+ * @param a_capacity Most entries, at least one
+ */
+ProgramCache::ProgramCache(const size_t a_capacity):
+    m_capacity(max<size_t>(1, a_capacity)),
+    m_hits(0),
+    m_misses(0),
+    m_evictions(0)
+{
+}
+
+/**
+ * @brief The cache of the process, 1024 entries until setCapacity()
+ */
+ProgramCache &ProgramCache::instance()
+{
+    static ProgramCache cache;
+    return cache;
+}
+
+/**
+ * @brief The expression as the parser reads it
+ * @details Removes the spaces and the tabs like setExpression() and collapses
+ * the runs of signs like expressionToReversePolish(): `--` and `++` give `+`,
+ * `-+` and `+-` give `-`.
+ * @param a_expression The infix expression
+ * @return **string** The key of the expression
+ */
+string ProgramCache::normalize(const string &a_expression)
+{
+    string key;
+    key.reserve(a_expression.size());
+    for (char c : a_expression) {
+        if (c == ' ' || c == '\t')
+            continue;
+        if ((c == '+' || c == '-') && key.empty() == false
+                && (key.back() == '+' || key.back() == '-')) {
+            key.back() = key.back() == c ? '+' : '-';
+            continue;
+        }
+        key.push_back(c);
+    }
+    return key;
+}
+
+/**
+ * @brief The compiled expression from the cache or from the parser
+ * @param a_expression The infix expression
+ * @return **CompiledExpression** The shared program and the variable names, or
+ * the error, as MathParser::compile()
+ */
+CompiledExpression ProgramCache::compile(const string &a_expression)
+{
+    const string key = normalize(a_expression);
+    {
+        lock_guard<mutex> lock(m_mutex);
+        auto found = m_index.find(key);
+        if (found != m_index.end()) {
+            m_hits++;
+            m_entries.splice(m_entries.begin(), m_entries, found->second);
+            return found->second->compiled;
+        }
+        m_misses++;
+    }
+
+    MathExpression parser;
+    CompiledExpression compiled = parser.compile(key);
+
+    lock_guard<mutex> lock(m_mutex);
+    auto found = m_index.find(key);
+    if (found != m_index.end()) {
+        // Another thread compiled it meanwhile, share its program
+        m_entries.splice(m_entries.begin(), m_entries, found->second);
+        return found->second->compiled;
+    }
+    m_entries.push_front(Entry{key, compiled});
+    m_index[key] = m_entries.begin();
+    evict();
+    return compiled;
+}
+
+/**
+ * @brief Changes the most entries, evicts the least recently used if needed
+ * @param a_capacity Most entries, at least one
+ */
+void ProgramCache::setCapacity(const size_t a_capacity)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_capacity = max<size_t>(1, a_capacity);
+    evict();
+}
+
+/**
+ * @brief Getter of the most entries
+ */
+size_t ProgramCache::capacity() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_capacity;
+}
+
+/**
+ * @brief Copy of the counters
+ */
+ProgramCache::Statistics ProgramCache::statistics() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    Statistics statistics;
+    statistics.hits = m_hits;
+    statistics.misses = m_misses;
+    statistics.evictions = m_evictions;
+    statistics.size = m_entries.size();
+    return statistics;
+}
+
+/**
+ * @brief Removes all the entries and resets the counters
+ * @details The programs stay alive while somebody uses them.
+ */
+void ProgramCache::clear()
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_entries.clear();
+    m_index.clear();
+    m_hits = 0;
+    m_misses = 0;
+    m_evictions = 0;
+}
+
+/**
+ * @brief Removes the least recently used entries over the capacity
+ * @details Called with m_mutex locked.
+ */
+void ProgramCache::evict()
+{
+    while (m_entries.size() > m_capacity) {
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+        m_evictions++;
+    }
+}
@@ -0,0 +1,98 @@
+/**
+ *  @file pssmathcache.h
+ *  @brief Headers for the cache of compiled expressions of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHCACHE_H
+#define PSSMATHCACHE_H
+
+#include "pssmathparser.h"
+#include <list>
+#include <mutex>
+
+namespace PssMathParser {
+
+/**
+ * @brief Least recently used cache of compiled expressions
+ * @details The key is the expression text normalized as the parser does it:
+ * without spaces and tabs and with the runs of signs collapsed, so `x - -y`
+ * and `x+y` are the same entry. A hit returns the shared immutable Program of
+ * the entry, a miss compiles the expression with its own parser and adds it.
+ * Expressions with errors are kept too, with their error numbers. When the
+ * cache is full the least recently used entry is evicted.
+ *
+ * All the methods can be called from many threads. The expressions are
+ * compiled outside of the lock, so a miss doesn't stop the hits of other
+ * threads.
+ *
+ * ```c++
+ * CompiledExpression compiled = ProgramCache::instance().compile(formula);
+ * EvaluationContext context(compiled.program);
+ * ```
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC ProgramCache {
+public:
+    /**
+     * @brief Counters of the cache
+     */
+    struct Statistics {
+        size_t hits; /**< Lookups that found the expression */
+        size_t misses; /**< Lookups that compiled the expression */
+        size_t evictions; /**< Entries removed to make space */
+        size_t size; /**< Entries in the cache */
+    };
+
+    explicit ProgramCache(const size_t a_capacity = 1024);
+
+    ProgramCache(const ProgramCache &) = delete;
+    ProgramCache &operator=(const ProgramCache &) = delete;
+
+    static ProgramCache &instance();
+    static string normalize(const string &a_expression);
+
+    CompiledExpression compile(const string &a_expression);
+    void setCapacity(const size_t a_capacity);
+    size_t capacity() const;
+    Statistics statistics() const;
+    void clear();
+
+private:
+    /**
+     * @brief One cached expression
+     */
+    struct Entry {
+        string key; /**< The normalized expression */
+        CompiledExpression compiled; /**< The program or the error */
+    };
+
+    void evict();
+
+    mutable mutex m_mutex; /**< Guards all the members below */
+    list<Entry> m_entries; /**< The most recently used first */
+    unordered_map<string, list<Entry>::iterator> m_index; /**< Key to entry */
+    size_t m_capacity; /**< Most entries */
+    size_t m_hits; /**< Lookups that found the expression */
+    size_t m_misses; /**< Lookups that compiled the expression */
+    size_t m_evictions; /**< Entries removed to make space */
+};
+
+}
+
+#endif // PSSMATHCACHE_H
@@ -0,0 +1,561 @@
+/**
+ *  @file pssmathchebyshev.cpp
+ *  @brief Chebyshev approximation of an expression
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathchebyshev.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace PssMathParser;
+
+namespace {
+
+/** @brief Largest number of variables */
+const uint32_t MaxVariables = 4;
+/** @brief Largest degree in one variable */
+const uint32_t MaxDegree = 1024;
+/** @brief Largest number of points where the error is measured */
+const size_t MaxCheckPoints = size_t(1) << 20;
+/** @brief Rows calculated together by calculateBatch() */
+const size_t Lanes = 8;
+
+/**
+ * @brief Number of terms of a series, more than a_maxSize if it is too big
+ */
+size_t termSize(const uint32_t a_degree,
+                const uint32_t a_variableSize,
+                const size_t a_maxSize)
+{
+    size_t size = 1;
+    for (uint32_t v = 0; v < a_variableSize && size <= a_maxSize; v++)
+        size *= size_t(a_degree) + 1;
+    return size;
+}
+
+/**
+ * @brief Multiplies every variable of a tensor by a matrix
+ * @details The tensor has a_variableSize indices, the first one the most
+ * significant, each of a_in values. Every index is replaced by one of a_out
+ * values: out[.., i, ..] = sum of a_matrix[i * a_in + j] * in[.., j, ..].
+ * @param a_values The tensor, replaced by the result
+ * @param a_variableSize Number of indices
+ * @param a_in Values of an index before
+ * @param a_out Values of an index after
+ * @param a_matrix Matrix of a_out rows and a_in columns
+ */
+void transform(vector<double> &a_values,
+               const uint32_t a_variableSize,
+               const size_t a_in,
+               const size_t a_out,
+               const vector<double> &a_matrix)
+{
+    size_t outer = 1;
+    size_t inner = a_values.size() / a_in;
+    for (uint32_t v = 0; v < a_variableSize; v++) {
+        vector<double> result(outer * a_out * inner, 0.0);
+        for (size_t o = 0; o < outer; o++) {
+            for (size_t i = 0; i < a_out; i++) {
+                double *row = &result[(o * a_out + i) * inner];
+                for (size_t j = 0; j < a_in; j++) {
+                    const double m = a_matrix[i * a_in + j];
+                    const double *in = &a_values[(o * a_in + j) * inner];
+                    for (size_t r = 0; r < inner; r++)
+                        row[r] += m * in[r];
+                }
+            }
+        }
+        a_values.swap(result);
+        outer *= a_out;
+        inner /= a_in;
+    }
+}
+
+/**
+ * @brief Calculates the program on every point of a grid
+ * @details The grid is the product of the points a_t in every variable,
+ * mapped from [-1, 1] to the bounds. The last variable changes fastest.
+ */
+vector<double> sample(EvaluationContext &a_context,
+                      const vector<double> &a_t,
+                      const vector<double> &a_scale,
+                      const vector<double> &a_shift)
+{
+    const uint32_t variableSize = uint32_t(a_scale.size());
+    const size_t size = termSize(uint32_t(a_t.size() - 1), variableSize,
+                                 SIZE_MAX);
+    vector<double> values(size);
+    vector<size_t> index(variableSize, 0);
+    double variables[MaxVariables];
+    for (size_t p = 0; p < size; p++) {
+        for (uint32_t v = 0; v < variableSize; v++)
+            variables[v] = (a_t[index[v]] - a_shift[v]) / a_scale[v];
+        values[p] = a_context.calculate(variables);
+        for (uint32_t v = variableSize; v-- > 0; ) {
+            if (++index[v] < a_t.size())
+                break;
+            index[v] = 0;
+        }
+    }
+    return values;
+}
+
+/**
+ * @brief Points in one variable of the largest grid that measures the error
+ * @return **size_t** Largest m with m^a_variableSize at most 2^20
+ */
+size_t checkPointSize(const uint32_t a_variableSize)
+{
+    size_t m = 1;
+    for (;;) {
+        size_t points = 1;
+        for (uint32_t v = 0; v < a_variableSize; v++)
+            points *= m + 1;
+        if (points > MaxCheckPoints)
+            return m;
+        m++;
+    }
+}
+
+/**
+ * @brief Largest error of a series against the program
+ * @details The series and the program are calculated on a grid that includes
+ * the bounds, with at least 65 and 2n+1 points for n nodes in one variable,
+ * but at most checkPointSize() points. build() doesn't fit a degree that the
+ * grid can't check.
+ * @param a_context Context of the program
+ * @param a_coefficients The terms of the series
+ * @param a_degree Degree of the series in every variable
+ * @param a_scale Scale of every variable to [-1, 1]
+ * @param a_shift Shift of every variable to [-1, 1]
+ * @return **double** Largest absolute error, infinity if the program or the
+ * series isn't finite
+ */
+double measure(EvaluationContext &a_context,
+               const vector<double> &a_coefficients,
+               const uint32_t a_degree,
+               const vector<double> &a_scale,
+               const vector<double> &a_shift)
+{
+    const uint32_t variableSize = uint32_t(a_scale.size());
+    const size_t n = size_t(a_degree) + 1;
+    const size_t m = min(max<size_t>(2 * n + 1, 65),
+                         checkPointSize(variableSize));
+    vector<double> grid(m);
+    vector<double> polynomials(m * n);
+    for (size_t i = 0; i < m; i++) {
+        grid[i] = -1.0 + 2.0 * double(i) / double(m - 1);
+        double previous = 1.0;
+        double current = grid[i];
+        polynomials[i * n] = 1.0;
+        for (size_t k = 1; k < n; k++) {
+            polynomials[i * n + k] = current;
+            double next = 2.0 * grid[i] * current - previous;
+            previous = current;
+            current = next;
+        }
+    }
+    vector<double> approximated = a_coefficients;
+    transform(approximated, variableSize, n, m, polynomials);
+    vector<double> exact = sample(a_context, grid, a_scale, a_shift);
+    double error = 0.0;
+    for (size_t p = 0; p < exact.size(); p++) {
+        double e = fabs(approximated[p] - exact[p]);
+        error = max(error, isfinite(e) ? e : HUGE_VAL);
+    }
+    return error;
+}
+
+/**
+ * @brief Drops the terms of a series over a lower degree
+ * @details The sum of the dropped terms is at most the sum of the absolute
+ * values of their coefficients, so the error grows by at most this much.
+ * @param a_coefficients The terms, replaced by the kept terms
+ * @param a_variableSize Number of variables
+ * @param a_degree Degree of the series
+ * @param a_slack Largest sum of the dropped coefficients
+ * @return **uint32_t** Degree of the kept terms
+ */
+uint32_t truncate(vector<double> &a_coefficients,
+                  const uint32_t a_variableSize,
+                  const uint32_t a_degree,
+                  const double a_slack)
+{
+    // Sum of the coefficients by the largest degree of their variables
+    const size_t n = size_t(a_degree) + 1;
+    vector<double> sums(n, 0.0);
+    vector<size_t> index(a_variableSize, 0);
+    for (size_t p = 0; p < a_coefficients.size(); p++) {
+        sums[*max_element(index.begin(), index.end())] +=
+                fabs(a_coefficients[p]);
+        for (uint32_t v = a_variableSize; v-- > 0; ) {
+            if (++index[v] < n)
+                break;
+            index[v] = 0;
+        }
+    }
+    uint32_t degree = a_degree;
+    double dropped = 0.0;
+    while (degree > 0 && dropped + sums[degree] <= a_slack)
+        dropped += sums[degree--];
+    if (degree == a_degree)
+        return degree;
+
+    const size_t kept = size_t(degree) + 1;
+    vector<double> coefficients;
+    coefficients.reserve(termSize(degree, a_variableSize, SIZE_MAX));
+    fill(index.begin(), index.end(), 0);
+    for (size_t p = 0; p < a_coefficients.size(); p++) {
+        if (*max_element(index.begin(), index.end()) < kept)
+            coefficients.push_back(a_coefficients[p]);
+        for (uint32_t v = a_variableSize; v-- > 0; ) {
+            if (++index[v] < n)
+                break;
+            index[v] = 0;
+        }
+    }
+    a_coefficients.swap(coefficients);
+    return degree;
+}
+
+}
+
+/**
+ * @brief Constructor of the series that is 0
+ */
+ChebyshevFunction::ChebyshevFunction():
+    m_variableSize(0),
+    m_degree(0),
+    m_coefficients(1, 0.0),
+    m_maxError(0.0)
+{
+}
+
+/**
+ * @brief Fits the series of the program over the bounds of its variables
+ * @details The degree doubles from 4 until the largest absolute error is at
+ * most a_maxError, or until the series would have more than a_maxSize terms.
+ * In the second case the series of the largest degree is kept, with its error
+ * in maxError(), and the call returns false. In the first case the terms of
+ * the higher degrees are dropped while the sum of their coefficients fits in
+ * the rest of the target. The error is measured on a grid of at most 2^20
+ * points with at least 2n+1 points for n nodes in every variable, so the
+ * degree is at most 256 for 2 variables, 32 for 3 and 8 for 4.
+ * @param a_program Program of at most 4 variables
+ * @param a_lower Lower bound of every variable, in the order of the program
+ * @param a_upper Upper bound of every variable, in the order of the program
+ * @param a_maxError Target of the largest absolute error
+ * @param a_maxSize Largest number of terms
+ * @return **true** The error of the series is at most a_maxError
+ * @return **false** The series can't be fitted or is less accurate, see
+ * errorString()
+ */
+bool ChebyshevFunction::build(const shared_ptr<const Program> &a_program,
+                              const vector<double> &a_lower,
+                              const vector<double> &a_upper,
+                              const double a_maxError,
+                              const size_t a_maxSize)
+{
+    m_errorString.clear();
+    if (a_program == nullptr) {
+        m_errorString = "There is no program";
+        return false;
+    }
+    const uint32_t variableSize = a_program->variableSize();
+    if (variableSize > MaxVariables) {
+        m_errorString = "The program has " + to_string(variableSize)
+                + " variables, a series has at most "
+                + to_string(MaxVariables);
+        return false;
+    }
+    if (a_lower.size() != variableSize || a_upper.size() != variableSize) {
+        m_errorString = "The program has " + to_string(variableSize)
+                + " variables, the bounds are of a different number";
+        return false;
+    }
+    vector<double> scale(variableSize);
+    vector<double> shift(variableSize);
+    for (uint32_t v = 0; v < variableSize; v++) {
+        if (isfinite(a_lower[v]) == false || isfinite(a_upper[v]) == false
+                || !(a_lower[v] < a_upper[v])) {
+            m_errorString = "The bounds of the variable " + to_string(v)
+                    + " aren't a finite interval";
+            return false;
+        }
+        scale[v] = 2.0 / (a_upper[v] - a_lower[v]);
+        shift[v] = -(a_upper[v] + a_lower[v]) / (a_upper[v] - a_lower[v]);
+    }
+    if (!(a_maxError > 0.0)) {
+        m_errorString = "The error must be more than 0";
+        return false;
+    }
+
+    EvaluationContext context(a_program);
+    if (variableSize == 0) {
+        m_variableSize = 0;
+        m_degree = 0;
+        m_scale.clear();
+        m_shift.clear();
+        m_coefficients.assign(1, context.calculate());
+        m_maxError = 0.0;
+        return true;
+    }
+    vector<double> coefficients;
+    uint32_t degree = 0;
+    double maxError = HUGE_VAL;
+    const size_t checkPoints = checkPointSize(variableSize);
+    for (uint32_t d = 4; d <= MaxDegree; d *= 2) {
+        if (termSize(d, variableSize, a_maxSize) > a_maxSize)
+            break;
+        // The error of a higher degree can't be measured between the nodes
+        if (2 * (size_t(d) + 1) + 1 > checkPoints)
+            break;
+
+        // Coefficients from the values at the nodes, by the cosine transform
+        const size_t n = size_t(d) + 1;
+        vector<double> nodes(n);
+        vector<double> cosines(n * n);
+        for (size_t j = 0; j < n; j++)
+            nodes[j] = cos(M_PI * (double(j) + 0.5) / double(n));
+        for (size_t k = 0; k < n; k++) {
+            for (size_t j = 0; j < n; j++) {
+                cosines[k * n + j] = (k == 0 ? 1.0 : 2.0) / double(n)
+                        * cos(M_PI * double(k) * (double(j) + 0.5)
+                              / double(n));
+            }
+        }
+        vector<double> fitted = sample(context, nodes, scale, shift);
+        transform(fitted, variableSize, n, n, cosines);
+
+        double error = measure(context, fitted, d, scale, shift);
+
+        coefficients.swap(fitted);
+        degree = d;
+        maxError = error;
+        if (error <= a_maxError)
+            break;
+    }
+    if (coefficients.empty()) {
+        m_errorString = "A series of degree 4 has more than "
+                + to_string(a_maxSize) + " terms";
+        return false;
+    }
+
+    // The terms that the target doesn't need are dropped
+    if (maxError <= a_maxError) {
+        vector<double> truncated = coefficients;
+        uint32_t truncatedDegree = truncate(truncated, variableSize, degree,
+                                            a_maxError - maxError);
+        if (truncatedDegree < degree) {
+            double error = measure(context, truncated, truncatedDegree,
+                                   scale, shift);
+            if (error <= a_maxError) {
+                coefficients.swap(truncated);
+                degree = truncatedDegree;
+                maxError = error;
+            }
+        }
+    }
+
+    m_variableSize = variableSize;
+    m_degree = degree;
+    m_scale.swap(scale);
+    m_shift.swap(shift);
+    m_coefficients.swap(coefficients);
+    m_maxError = maxError;
+    if (maxError <= a_maxError)
+        return true;
+    if (isfinite(maxError) == false)
+        m_errorString = "The program isn't finite in the bounds";
+    else
+        m_errorString = "The error " + to_string(maxError)
+                + " is over the target with the degree " + to_string(degree);
+    return false;
+}
+
+/**
+ * @brief Value of the series at the variables
+ * @param a_variables Array of variableSize() values, ordered as the variables
+ * of the program
+ * @return **double** The value
+ */
+double ChebyshevFunction::calculate(const double *a_variables) const
+{
+    if (m_variableSize == 0)
+        return m_coefficients[0];
+    double t[MaxVariables];
+    for (uint32_t v = 0; v < m_variableSize; v++) {
+        double x = a_variables[v] * m_scale[v] + m_shift[v];
+        t[v] = x < -1.0 ? -1.0 : (x > 1.0 ? 1.0 : x);
+    }
+    return clenshaw(t, 0, 0);
+}
+
+/**
+ * @brief Same as calculate(a_variables)
+ */
+double ChebyshevFunction::operator()(const double *a_variables) const
+{
+    return calculate(a_variables);
+}
+
+/**
+ * @brief Calculates a_size rows of the variables
+ * @details The rows are calculated 8 at a time, every step of the Clenshaw
+ * recurrence is a loop over the 8 rows that the compiler vectorizes.
+ * @param a_variables Array of variableSize() columns of a_size values
+ * @param a_results Array of a_size results
+ * @param a_size Number of rows
+ */
+void ChebyshevFunction::calculateBatch(const double *const *a_variables,
+                                       double *a_results,
+                                       const size_t a_size) const
+{
+    if (m_variableSize == 0) {
+        fill(a_results, a_results + a_size, m_coefficients[0]);
+        return;
+    }
+    double t[MaxVariables * Lanes];
+    double results[Lanes];
+    for (size_t row = 0; row < a_size; row += Lanes) {
+        const size_t count = min(Lanes, a_size - row);
+        for (uint32_t v = 0; v < m_variableSize; v++) {
+            double *tv = t + v * Lanes;
+            for (size_t l = 0; l < count; l++) {
+                double x = a_variables[v][row + l] * m_scale[v] + m_shift[v];
+                tv[l] = x < -1.0 ? -1.0 : (x > 1.0 ? 1.0 : x);
+            }
+            for (size_t l = count; l < Lanes; l++)
+                tv[l] = 0.0;
+        }
+        clenshawBlock(t, 0, 0, results);
+        copy(results, results + count, a_results + row);
+    }
+}
+
+/**
+ * @brief Number of variables of the series
+ */
+uint32_t ChebyshevFunction::variableSize() const
+{
+    return m_variableSize;
+}
+
+/**
+ * @brief Degree of the series in every variable
+ */
+uint32_t ChebyshevFunction::degree() const
+{
+    return m_degree;
+}
+
+/**
+ * @brief Largest absolute error of the series measured by build()
+ */
+double ChebyshevFunction::maxError() const
+{
+    return m_maxError;
+}
+
+/**
+ * @brief Number of the terms of the series
+ */
+size_t ChebyshevFunction::size() const
+{
+    return m_coefficients.size();
+}
+
+/**
+ * @brief Description of the error of the last build()
+ */
+const string ChebyshevFunction::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * @brief Sums the series of one variable by the Clenshaw recurrence
+ * @details The coefficients of the series in a_variable are the sums of the
+ * series in the next variables, the last variable has the stored ones.
+ * @param a_t The variables mapped to [-1, 1]
+ * @param a_variable Index of the variable
+ * @param a_base Index of the coefficients of the previous variables
+ * @return **double** The sum
+ */
+double ChebyshevFunction::clenshaw(const double *a_t,
+                                   const uint32_t a_variable,
+                                   const size_t a_base) const
+{
+    const size_t n = size_t(m_degree) + 1;
+    const bool last = a_variable + 1 == m_variableSize;
+    const double t = a_t[a_variable];
+    double b1 = 0.0;
+    double b2 = 0.0;
+    for (size_t k = n - 1; k > 0; k--) {
+        const size_t index = a_base * n + k;
+        double c = last ? m_coefficients[index]
+                        : clenshaw(a_t, a_variable + 1, index);
+        double b0 = c + 2.0 * t * b1 - b2;
+        b2 = b1;
+        b1 = b0;
+    }
+    double c = last ? m_coefficients[a_base * n]
+                    : clenshaw(a_t, a_variable + 1, a_base * n);
+    return c + t * b1 - b2;
+}
+
+/**
+ * @brief Sums the series of one variable for 8 rows
+ * @details Same as clenshaw() for the arrays of 8 values.
+ * @param a_t The variables mapped to [-1, 1], 8 values of every variable
+ * @param a_variable Index of the variable
+ * @param a_base Index of the coefficients of the previous variables
+ * @param a_results Array of the 8 sums
+ */
+void ChebyshevFunction::clenshawBlock(const double *a_t,
+                                      const uint32_t a_variable,
+                                      const size_t a_base,
+                                      double *a_results) const
+{
+    const size_t n = size_t(m_degree) + 1;
+    const bool last = a_variable + 1 == m_variableSize;
+    const double *t = a_t + a_variable * Lanes;
+    double b1[Lanes] = { 0.0 };
+    double b2[Lanes] = { 0.0 };
+    double c[Lanes];
+    for (size_t k = n - 1; k > 0; k--) {
+        const size_t index = a_base * n + k;
+        if (last)
+            fill(c, c + Lanes, m_coefficients[index]);
+        else
+            clenshawBlock(a_t, a_variable + 1, index, c);
+        for (size_t l = 0; l < Lanes; l++) {
+            double b0 = c[l] + 2.0 * t[l] * b1[l] - b2[l];
+            b2[l] = b1[l];
+            b1[l] = b0;
+        }
+    }
+    if (last)
+        fill(c, c + Lanes, m_coefficients[a_base * n]);
+    else
+        clenshawBlock(a_t, a_variable + 1, a_base * n, c);
+    for (size_t l = 0; l < Lanes; l++)
+        a_results[l] = c[l] + t[l] * b1[l] - b2[l];
+}
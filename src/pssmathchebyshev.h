@@ -0,0 +1,97 @@
+/**
+ *  @file pssmathchebyshev.h
+ *  @brief Headers for the Chebyshev approximation of an expression
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHCHEBYSHEV_H
+#define PSSMATHCHEBYSHEV_H
+
+#include "pssmathparser_global.h"
+#include "pssmathcore.h"
+#include <string>
+
+namespace PssMathParser {
+
+/**
+ * @brief Chebyshev expansion of a program over the bounds of its variables
+ * @details build() fits the tensor product of Chebyshev series of one degree
+ * in every variable, from the values of the program at the Chebyshev nodes.
+ * The degree starts at 4 and doubles until the largest absolute error against
+ * the program, on a grid finer than the nodes, is below the target. The grid
+ * has at most 2^20 points, which limits the degree to 256 for 2 variables, 32
+ * for 3 and 8 for 4. A program of up to 4 variables can be approximated; a
+ * TableFunction is usually smaller and faster for one variable with steep
+ * parts.
+ *
+ * calculate() and calculateBatch() sum the series by the Clenshaw recurrence,
+ * the batch for 8 rows at a time in loops that the compiler vectorizes.
+ * Outside the bounds the value at the nearest bound is returned.
+ *
+ * ```c++
+ * parser.setMath("Io*(exp(V/(kBJ*(ToK+TC)/qe))-1)"); // variables TC and V
+ * ChebyshevFunction chebyshev;
+ * chebyshev.build(parser.program(), { -40.0, 0.0 }, { 125.0, 0.7 }, 1.0e-9);
+ * double variables[2] = { 25.0, 0.5 };
+ * double value = chebyshev.calculate(variables); // chebyshev.maxError()
+ * ```
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC ChebyshevFunction {
+public:
+    ChebyshevFunction();
+
+    bool build(const shared_ptr<const Program> &a_program,
+               const vector<double> &a_lower,
+               const vector<double> &a_upper,
+               const double a_maxError,
+               const size_t a_maxSize = 1 << 16);
+
+    double calculate(const double *a_variables) const;
+    double operator()(const double *a_variables) const;
+    void calculateBatch(const double *const *a_variables,
+                        double *a_results,
+                        const size_t a_size) const;
+
+    uint32_t variableSize() const;
+    uint32_t degree() const;
+    double maxError() const;
+    size_t size() const;
+    const string errorString() const;
+
+private:
+    double clenshaw(const double *a_t,
+                    const uint32_t a_variable,
+                    const size_t a_base) const;
+    void clenshawBlock(const double *a_t,
+                       const uint32_t a_variable,
+                       const size_t a_base,
+                       double *a_results) const;
+
+    uint32_t m_variableSize; /**< Number of variables */
+    uint32_t m_degree; /**< Degree in every variable */
+    vector<double> m_scale; /**< Scale of a variable to [-1, 1] */
+    vector<double> m_shift; /**< Shift of a variable to [-1, 1] */
+    vector<double> m_coefficients; /**< (degree + 1)^variables terms */
+    double m_maxError; /**< Largest measured error */
+    string m_errorString; /**< Error of build() */
+};
+
+}
+
+#endif // PSSMATHCHEBYSHEV_H
@@ -0,0 +1,224 @@
+/**
+ *  @file pssmathcodegen.cpp
+ *  @brief Source code for the C source generator of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathcodegen.h"
+#include <stdio.h>
+
+using namespace PssMathParser;
+
+namespace {
+
+/**
+ * @brief Replaces every %u in the format with the number
+ */
+string formatIndex(const string &a_format, const uint32_t a_index)
+{
+    string str;
+    for (size_t i = 0; i < a_format.size(); i++) {
+        if (a_format[i] == '%' && i + 1 < a_format.size()
+                && a_format[i+1] == 'u') {
+            str += to_string(a_index);
+            i++;
+        }
+        else {
+            str += a_format[i];
+        }
+    }
+    return str;
+}
+
+}
+
+/**
+ * @brief Constructor, finds the C names of all called functions
+ * @details The object keeps references to the given vectors, so it must not
+ * outlive them.
+ * @param a_instructions The compiled program
+ * @param a_values Slots of the program, constants are read from here
+ * @param a_variableSize Number of variables (the first slots)
+ * @param a_resultSlot Slot of the result, UINT32_MAX if the result is zero
+ */
+CodeGenerator::CodeGenerator(const vector<Instruction> &a_instructions,
+                             const vector<double> &a_values,
+                             const uint32_t a_variableSize,
+                             const uint32_t a_resultSlot):
+    m_instructions(a_instructions),
+    m_values(a_values),
+    m_variableSize(a_variableSize),
+    m_resultSlot(a_resultSlot)
+{
+    for (const Instruction &ins : m_instructions) {
+        const string name = MathExpression::operatorName(ins, true);
+        if (ins.code != OpCode::CallOneArg && ins.code != OpCode::CallTwoArg) {
+            m_functionNames.push_back(name);
+            continue;
+        }
+        if (name.empty() && m_errorString.empty())
+            m_errorString = string("The program calls a function that has no "
+                                   "name in the operatorMap");
+        m_functionNames.push_back(name);
+    }
+}
+
+/**
+ * @brief Tells if the program can be translated
+ * @return **true** All functions have C names
+ * @return **false** See errorString()
+ */
+bool CodeGenerator::isValid() const
+{
+    return m_errorString.empty();
+}
+
+/**
+ * @brief Getter of the error string
+ * @return **string** Empty if the program can be translated
+ */
+const string &CodeGenerator::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * @brief Writes the statements that calculate the program
+ * @details Each statement is one line that starts with a_indent. After the
+ * statements the result is in the local named by result().
+ * @param a_variableFormat How to read the variable, `%u` is its index
+ * @param a_indent Indentation of every line
+ * @param a_constantFormat How to read the constant, `%u` is its slot. If it
+ * is empty the constant is written as a literal
+ * @return **string** The C statements
+ */
+string CodeGenerator::statements(const string &a_variableFormat,
+                                 const string &a_indent,
+                                 const string &a_constantFormat) const
+{
+    string str;
+    vector<bool> defined(m_values.size(), false);
+    // Declares the variable or constant slot before its first use
+    auto define = [&](uint32_t a_slot) {
+        if (defined[a_slot])
+            return;
+        defined[a_slot] = true;
+        str += a_indent + "const double " + slotName(a_slot) + " = ";
+        if (a_slot < m_variableSize)
+            str += formatIndex(a_variableFormat, a_slot);
+        else if (a_constantFormat.empty() == false)
+            str += formatIndex(a_constantFormat, a_slot);
+        else
+            str += literal(m_values[a_slot]);
+        str += ";\n";
+    };
+    for (size_t i = 0; i < m_instructions.size(); i++) {
+        const Instruction &ins = m_instructions[i];
+        define(ins.arg1);
+        if (ins.code != OpCode::CallOneArg)
+            define(ins.arg2);
+        string arg1 = slotName(ins.arg1);
+        string arg2 = slotName(ins.arg2);
+        string value;
+        switch (ins.code) {
+        case OpCode::Add: value = arg1 + " + " + arg2; break;
+        case OpCode::Subtract: value = arg1 + " - " + arg2; break;
+        case OpCode::Multiply: value = arg1 + " * " + arg2; break;
+        case OpCode::Divide: value = arg1 + " / " + arg2; break;
+        case OpCode::CallOneArg:
+            value = m_functionNames[i] + "(" + arg1 + ")";
+            break;
+        case OpCode::CallTwoArg:
+            value = m_functionNames[i] + "(" + arg1 + ", " + arg2 + ")";
+            break;
+        }
+        defined[ins.result] = true;
+        str += a_indent + "const double " + slotName(ins.result) + " = "
+                + value + ";\n";
+    }
+    if (m_resultSlot != UINT32_MAX)
+        define(m_resultSlot);
+    return str;
+}
+
+/**
+ * @brief Writes the statements that copy generated locals to the slots
+ * @param a_valuesName Name of the slot array
+ * @param a_indent Indentation of every line
+ * @return **string** The C statements
+ */
+string CodeGenerator::storeGenerated(const string &a_valuesName,
+                                     const string &a_indent) const
+{
+    string str;
+    for (const Instruction &ins : m_instructions) {
+        str += a_indent + a_valuesName + "[" + to_string(ins.result) + "] = "
+                + slotName(ins.result) + ";\n";
+    }
+    return str;
+}
+
+/**
+ * @brief Getter of the C expression with the result
+ * @return **string** Name of the local with the result, or 0.0
+ */
+string CodeGenerator::result() const
+{
+    if (m_resultSlot == UINT32_MAX)
+        return string("0.0");
+    return slotName(m_resultSlot);
+}
+
+/**
+ * @brief Writes the double as exact C literal
+ * @details Hexadecimal floating point keeps all the bits of the value.
+ * @param a_value The value
+ * @return **string** The C literal
+ */
+string CodeGenerator::literal(const double a_value)
+{
+    if (isnan(a_value))
+        return string("NAN");
+    if (isinf(a_value))
+        return a_value > 0 ? string("INFINITY") : string("(-INFINITY)");
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%a", a_value);
+    return string(buffer);
+}
+
+/**
+ * @brief Makes the text safe to put inside a C comment
+ * @param a_text The text, usually the expression
+ * @return **string** The text where no `*` is followed by `/`
+ */
+string CodeGenerator::comment(const string &a_text)
+{
+    string str = a_text;
+    for (size_t i = str.find("*/"); i != string::npos; i = str.find("*/"))
+        str.insert(i + 1, " ");
+    return str;
+}
+
+/**
+ * @brief Name of the local that holds the slot
+ */
+string CodeGenerator::slotName(const uint32_t a_slot) const
+{
+    return string("s") + to_string(a_slot);
+}
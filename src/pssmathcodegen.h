@@ -0,0 +1,71 @@
+/**
+ *  @file pssmathcodegen.h
+ *  @brief Headers for the C source generator of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHCODEGEN_H
+#define PSSMATHCODEGEN_H
+
+#include "pssmathparser.h"
+
+namespace PssMathParser {
+
+/**
+ * @brief Translates the compiled program to C source
+ * @details Every slot becomes a local `const double sN`. Variables are read
+ * with the given format (for example `values[%u]` or `variables[%u][i]`, where
+ * `%u` is replaced with the index of the variable), constants are written as
+ * exact hexadecimal literals or read with their own format, and functions are
+ * called by their math.h names.
+ * The generated statements are valid C and C++.
+ */
+class CodeGenerator {
+public:
+    CodeGenerator(const vector<Instruction> &a_instructions,
+                  const vector<double> &a_values,
+                  const uint32_t a_variableSize,
+                  const uint32_t a_resultSlot);
+
+    bool isValid() const;
+    const string &errorString() const;
+    string statements(const string &a_variableFormat,
+                      const string &a_indent,
+                      const string &a_constantFormat = string()) const;
+    string storeGenerated(const string &a_valuesName,
+                          const string &a_indent) const;
+    string result() const;
+
+    static string literal(const double a_value);
+    static string comment(const string &a_text);
+
+private:
+    string slotName(const uint32_t a_slot) const;
+
+    const vector<Instruction> &m_instructions; /**< The program */
+    const vector<double> &m_values; /**< Values of the constants */
+    uint32_t m_variableSize; /**< Number of variables (first slots) */
+    uint32_t m_resultSlot; /**< Slot of the result */
+    vector<string> m_functionNames; /**< math.h name of each instruction */
+    string m_errorString; /**< Why the program can't be translated */
+};
+
+}
+
+#endif // PSSMATHCODEGEN_H
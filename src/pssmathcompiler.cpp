@@ -0,0 +1,440 @@
+/**
+ *  @file pssmathcompiler.cpp
+ *  @brief Source code for the system compiler backend of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathcompiler.h"
+#include "pssmathcodegen.h"
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <stdio.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PSSMATHPARSER_COMPILER_DLOPEN 1
+#include <dlfcn.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define PSSMATHPARSER_COMPILER_DLOPEN 0
+#endif
+
+using namespace PssMathParser;
+
+namespace {
+
+mutex settingsMutex; /**< Guards the settings below */
+string compilerSetting; /**< Compiler command, empty for default */
+string flagsSetting; /**< Compiler flags, empty for default */
+string cacheDirectorySetting; /**< Cache directory, empty for default */
+atomic<uint64_t> temporaryCounter(0); /**< Numbers the temporary files */
+
+/**
+ * @brief 64 bit FNV-1a hash of the string
+ */
+uint64_t hashString(const string &a_str)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : a_str) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Reads the whole file, returns false if it doesn't exist
+ */
+bool readFile(const string &a_path, string &a_content)
+{
+    ifstream file(a_path, ios::binary);
+    if (file.is_open() == false)
+        return false;
+    ostringstream s;
+    s << file.rdbuf();
+    a_content = s.str();
+    return true;
+}
+
+#if PSSMATHPARSER_COMPILER_DLOPEN == 1
+/**
+ * @brief Creates the directory and all its parents
+ */
+bool makeDirectory(const string &a_path)
+{
+    for (size_t i = 1; i <= a_path.size(); i++) {
+        if (i == a_path.size() || a_path[i] == '/') {
+            string dir = a_path.substr(0, i);
+            struct stat st;
+            if (stat(dir.data(), &st) != 0
+                    && mkdir(dir.data(), 0700) != 0 && errno != EEXIST)
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Tests if only the user can put files in the directory
+ * @details The shared objects of the directory are loaded into the process,
+ * so a directory made by another user, or writable by others, could hold
+ * their code.
+ */
+bool isPrivateDirectory(const string &a_path)
+{
+    struct stat st;
+    return stat(a_path.data(), &st) == 0 && S_ISDIR(st.st_mode)
+            && st.st_uid == geteuid()
+            && (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+#endif
+
+}
+
+/**
+ * @brief Constructor, the object holds no code until compile()
+ */
+CompilerFunction::CompilerFunction():
+    m_handle(nullptr)
+{
+}
+
+/**
+ * @brief Destructor, unloads the shared object
+ */
+CompilerFunction::~CompilerFunction()
+{
+    release();
+}
+
+/**
+ * @brief Tells if the backend can be used on this system
+ * @details This only checks that shared objects can be loaded. If there is no
+ * compiler installed compile() fails and the interpreter is used.
+ * @return **true** The system has dlopen
+ * @return **false** Only the interpreter can be used
+ */
+bool CompilerFunction::isSupported()
+{
+    return PSSMATHPARSER_COMPILER_DLOPEN == 1;
+}
+
+/**
+ * @brief Sets the compiler command
+ * @param a_compiler Command, empty for the default ($CC or cc)
+ */
+void CompilerFunction::setCompiler(const string &a_compiler)
+{
+    lock_guard<mutex> lock(settingsMutex);
+    compilerSetting = a_compiler;
+}
+
+/**
+ * @brief Getter of the compiler command
+ * @return **string** The command used to compile
+ */
+const string CompilerFunction::compiler()
+{
+    lock_guard<mutex> lock(settingsMutex);
+    if (compilerSetting.empty() == false)
+        return compilerSetting;
+    const char *env = getenv("CC");
+    if (env != nullptr && env[0] != '\0')
+        return string(env);
+    return string("cc");
+}
+
+/**
+ * @brief Sets the compiler flags
+ * @param a_flags Flags, empty for the default
+ */
+void CompilerFunction::setFlags(const string &a_flags)
+{
+    lock_guard<mutex> lock(settingsMutex);
+    flagsSetting = a_flags;
+}
+
+/**
+ * @brief Getter of the compiler flags
+ * @return **string** Flags, `-shared -fPIC` are always added
+ */
+const string CompilerFunction::flags()
+{
+    lock_guard<mutex> lock(settingsMutex);
+    if (flagsSetting.empty() == false)
+        return flagsSetting;
+    return string("-O3 -march=native -ffp-contract=off -fno-builtin-pow");
+}
+
+/**
+ * @brief Sets the directory for the compiled shared objects
+ * @param a_directory Path, empty for the default
+ */
+void CompilerFunction::setCacheDirectory(const string &a_directory)
+{
+    lock_guard<mutex> lock(settingsMutex);
+    cacheDirectorySetting = a_directory;
+}
+
+/**
+ * @brief Getter of the cache directory
+ * @details Default is $PSSMATHPARSER_CACHE, $XDG_CACHE_HOME/pssmathparser or
+ * ~/.cache/pssmathparser. Without a home it is a directory of the user id in
+ * $TMPDIR or /tmp. compile() uses only a directory of the user that others
+ * can't write to.
+ * @return **string** Path of the directory
+ */
+const string CompilerFunction::cacheDirectory()
+{
+    lock_guard<mutex> lock(settingsMutex);
+    if (cacheDirectorySetting.empty() == false)
+        return cacheDirectorySetting;
+    const char *env = getenv("PSSMATHPARSER_CACHE");
+    if (env != nullptr && env[0] != '\0')
+        return string(env);
+    env = getenv("XDG_CACHE_HOME");
+    if (env != nullptr && env[0] == '/')
+        return string(env) + "/pssmathparser";
+    env = getenv("HOME");
+    if (env != nullptr && env[0] == '/')
+        return string(env) + "/.cache/pssmathparser";
+    string directory("/tmp");
+    env = getenv("TMPDIR");
+    if (env != nullptr && env[0] != '\0')
+        directory = env;
+#if PSSMATHPARSER_COMPILER_DLOPEN == 1
+    return directory + "/pssmathparser-cache-" + to_string(geteuid());
+#else
+    return directory + "/pssmathparser-cache";
+#endif
+}
+
+/**
+ * @brief Getter of the backend
+ * @return EvaluationBackend Always EvaluationBackend::SystemCompiler
+ */
+EvaluationBackend CompilerFunction::backend() const
+{
+    return EvaluationBackend::SystemCompiler;
+}
+
+/**
+ * @brief Writes the C source of the program
+ * @details The source defines `double pssmathparser_scalar(double *values)`
+ * and `void pssmathparser_batch(double *values, const double *const
+ * *variables, double *results, size_t size)` with the same meaning as the
+ * entries of the NativeFunction.
+ * @param a_instructions The compiled program
+ * @param a_values Slots of the program
+ * @param a_variableSize Number of variables (the first slots)
+ * @param a_resultSlot Slot of the result, UINT32_MAX if the result is zero
+ * @param a_expression Expression written in the comment on top
+ * @return **string** The source or empty string if it can't be translated
+ */
+string CompilerFunction::sourceCode(const vector<Instruction> &a_instructions,
+                                    const vector<double> &a_values,
+                                    const uint32_t a_variableSize,
+                                    const uint32_t a_resultSlot,
+                                    const string &a_expression)
+{
+    CodeGenerator generator(a_instructions, a_values,
+                            a_variableSize, a_resultSlot);
+    if (generator.isValid() == false)
+        return string();
+
+    string str;
+    str += "/* Generated by PssMathParser from: "
+            + CodeGenerator::comment(a_expression) + " */\n";
+    str += "#include <math.h>\n";
+    str += "#include <stddef.h>\n\n";
+    str += "double pssmathparser_scalar(double *values)\n{\n";
+    str += generator.statements("values[%u]", "    ", "values[%u]");
+    str += generator.storeGenerated("values", "    ");
+    str += "    return " + generator.result() + ";\n}\n\n";
+    str += "void pssmathparser_batch(double *values,\n"
+           "                         const double *const *variables,\n"
+           "                         double *results,\n"
+           "                         size_t size)\n{\n";
+    str += "    size_t i;\n";
+    str += "    for (i = 0; i < size; i++) {\n";
+    str += generator.statements("variables[%u][i]", "        ",
+                                "values[%u]");
+    str += "        results[i] = " + generator.result() + ";\n";
+    str += "    }\n";
+    str += "    if (size > 0) {\n";
+    for (uint32_t v = 0; v < a_variableSize; v++) {
+        str += "        values[" + to_string(v) + "] = variables["
+                + to_string(v) + "][size - 1];\n";
+    }
+    str += "    }\n}\n";
+    return str;
+}
+
+/**
+ * @brief Compiles the program with the system compiler and loads it
+ * @details If the cache directory already has the shared object for the same
+ * source and compiler command, it is loaded without compiling.
+ * @param a_instructions The compiled program
+ * @param a_values Slots of the program, the code reads the constants from
+ * the slots it is called with
+ * @param a_variableSize Number of variables (the first slots)
+ * @param a_resultSlot Slot of the result, UINT32_MAX if the result is zero
+ * @param a_expression Expression written in the comment of the source
+ * @return **true** Code is ready
+ * @return **false** See errorString()
+ */
+bool CompilerFunction::compile(const vector<Instruction> &a_instructions,
+                               const vector<double> &a_values,
+                               const uint32_t a_variableSize,
+                               const uint32_t a_resultSlot,
+                               const string &a_expression)
+{
+    release();
+    m_errorString.clear();
+#if PSSMATHPARSER_COMPILER_DLOPEN == 1
+    string source = sourceCode(a_instructions, a_values,
+                               a_variableSize, a_resultSlot, a_expression);
+    if (source.empty()) {
+        m_errorString = string("The program can't be translated to C");
+        return false;
+    }
+    string command = compiler() + " " + flags() + " -shared -fPIC";
+    string directory = cacheDirectory();
+    if (directory.find('\'') != string::npos
+            || makeDirectory(directory) == false) {
+        m_errorString = string("Can't use the cache directory '")
+                + directory + "'";
+        return false;
+    }
+    if (isPrivateDirectory(directory) == false) {
+        m_errorString = string("The cache directory '") + directory
+                + "' isn't owned by the user or others can write to it";
+        return false;
+    }
+
+    char hash[32];
+    snprintf(hash, sizeof(hash), "%016llx",
+             (unsigned long long)hashString(source + '\0' + command));
+    string base = directory + "/pss_" + hash;
+    string libraryPath = base + ".so";
+    string sourcePath = base + ".c";
+
+    // Compile only if the cached object isn't built from the same source
+    string cached;
+    struct stat st;
+    if (readFile(sourcePath, cached) == false || cached != source
+            || stat(libraryPath.data(), &st) != 0) {
+        // Temporary files are renamed, so other processes never see them
+        // half written. The counter keeps the threads of this process apart
+        string suffix = string(".") + to_string(getpid()) + "."
+                + to_string(temporaryCounter.fetch_add(1)) + ".tmp";
+        string temporarySource = base + suffix + ".c";
+        string temporaryLibrary = base + suffix + ".so";
+        {
+            ofstream file(temporarySource, ios::binary);
+            file << source;
+            if (file.good() == false) {
+                m_errorString = string("Can't write '") + temporarySource
+                        + "'";
+                return false;
+            }
+        }
+        string line = command + " -o '" + temporaryLibrary + "' '"
+                + temporarySource + "' -lm 2>&1";
+        string output;
+        FILE *pipe = popen(line.data(), "r");
+        int status = -1;
+        if (pipe != nullptr) {
+            char buffer[256];
+            while (fgets(buffer, sizeof(buffer), pipe) != nullptr)
+                output += buffer;
+            status = pclose(pipe);
+        }
+        if (status != 0) {
+            unlink(temporarySource.data());
+            unlink(temporaryLibrary.data());
+            m_errorString = string("Compilation failed: ") + line + "\n"
+                    + output;
+            return false;
+        }
+        rename(temporaryLibrary.data(), libraryPath.data());
+        rename(temporarySource.data(), sourcePath.data());
+    }
+
+    m_handle = dlopen(libraryPath.data(), RTLD_NOW | RTLD_LOCAL);
+    if (m_handle == nullptr) {
+        m_errorString = string("dlopen failed: ") + dlerror();
+        return false;
+    }
+    m_scalarEntry = reinterpret_cast<ScalarEntry>(
+                dlsym(m_handle, "pssmathparser_scalar"));
+    m_batchEntry = reinterpret_cast<BatchEntry>(
+                dlsym(m_handle, "pssmathparser_batch"));
+    if (isCompiled() == false) {
+        m_errorString = string("The shared object has no entry points");
+        release();
+        return false;
+    }
+    m_libraryPath = libraryPath;
+    return true;
+#else
+    (void)a_instructions;
+    (void)a_values;
+    (void)a_variableSize;
+    (void)a_resultSlot;
+    (void)a_expression;
+    m_errorString = string("The system can't load shared objects");
+    return false;
+#endif
+}
+
+/**
+ * @brief Unloads the shared object, the cached file stays
+ */
+void CompilerFunction::release()
+{
+#if PSSMATHPARSER_COMPILER_DLOPEN == 1
+    if (m_handle != nullptr)
+        dlclose(m_handle);
+#endif
+    m_handle = nullptr;
+    m_scalarEntry = nullptr;
+    m_batchEntry = nullptr;
+    m_libraryPath.clear();
+}
+
+/**
+ * @brief Getter of the path of the loaded shared object
+ * @return **string** Path or empty string
+ */
+const string &CompilerFunction::libraryPath() const
+{
+    return m_libraryPath;
+}
+
+/**
+ * @brief Getter of the error string
+ * @return **string** Why the last compile() failed
+ */
+const string &CompilerFunction::errorString() const
+{
+    return m_errorString;
+}
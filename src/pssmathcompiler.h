@@ -0,0 +1,83 @@
+/**
+ *  @file pssmathcompiler.h
+ *  @brief Headers for the system compiler backend of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHCOMPILER_H
+#define PSSMATHCOMPILER_H
+
+#include "pssmathnative.h"
+
+namespace PssMathParser {
+
+/**
+ * @brief Compiled program built by the system C compiler
+ * @details The program is translated to C source with the CodeGenerator and
+ * compiled by the installed compiler (`cc` by default) into a shared object
+ * that is loaded with dlopen. Compiling takes about 100 ms, so the shared
+ * objects are cached in a directory. The file name is the hash of the source
+ * and of the compiler command, and the source is kept next to it to rule out
+ * hash collisions.
+ *
+ * The default flags are `-O3 -march=native -ffp-contract=off
+ * -fno-builtin-pow`. The last two stop the compiler from fusing multiply and
+ * add and from replacing pow() with multiplications, so the results are the
+ * same as from the interpreter. The code reads the constants from the slots,
+ * so changing them with setVariableDouble() needs no new compilation and the
+ * programs that differ only in their constants share one shared object.
+ */
+class CompilerFunction : public NativeFunction {
+public:
+    CompilerFunction();
+    ~CompilerFunction();
+
+    static bool isSupported();
+    static void setCompiler(const string &a_compiler);
+    static const string compiler();
+    static void setFlags(const string &a_flags);
+    static const string flags();
+    static void setCacheDirectory(const string &a_directory);
+    static const string cacheDirectory();
+
+    EvaluationBackend backend() const;
+    bool compile(const vector<Instruction> &a_instructions,
+                 const vector<double> &a_values,
+                 const uint32_t a_variableSize,
+                 const uint32_t a_resultSlot,
+                 const string &a_expression = string());
+    void release();
+    const string &libraryPath() const;
+    const string &errorString() const;
+
+    static string sourceCode(const vector<Instruction> &a_instructions,
+                             const vector<double> &a_values,
+                             const uint32_t a_variableSize,
+                             const uint32_t a_resultSlot,
+                             const string &a_expression);
+
+private:
+    void *m_handle; /**< Handle from dlopen */
+    string m_libraryPath; /**< Path of the loaded shared object */
+    string m_errorString; /**< Why the compilation failed */
+};
+
+}
+
+#endif // PSSMATHCOMPILER_H
@@ -0,0 +1,494 @@
+/**
+ *  @file pssmathcore.h
+ *  @brief Header only evaluation core of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHCORE_H
+#define PSSMATHCORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+namespace PssMathParser {
+
+using namespace std;
+
+/**
+ * @brief Enum defines the instruction set of the compiled program
+ */
+enum class OpCode : uint8_t {
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    CallOneArg,
+    CallTwoArg
+};
+
+/** @brief Pointer to a function of the type: double func(double) */
+typedef double (*DDFunction)(const double);
+/** @brief Pointer to a function of the type: double func(double, double) */
+typedef double (*DDDFunction)(const double, const double);
+
+/**
+ * @brief One step of the compiled program
+ * @details Instruction is the flat form of a Generator. Instead of pointers to
+ * the Arguments it holds indices (slots) into the value array of the compiled
+ * program, so it can be run by the interpreter or translated to machine code.
+ */
+struct Instruction {
+    OpCode code; /**< What the instruction does */
+    uint32_t arg1; /**< Slot of the first argument */
+    uint32_t arg2; /**< Slot of the second argument */
+    uint32_t result; /**< Slot of the generated argument */
+    DDFunction ddFunction; /**< Function for OpCode::CallOneArg */
+    DDDFunction dddFunction; /**< Function for OpCode::CallTwoArg */
+};
+
+/**
+ * @brief The instructions of a compiled program, shared and never changed
+ * @details Programs with the same canonical instructions share one stream,
+ * see InstructionPool.
+ */
+typedef shared_ptr<const vector<Instruction>> InstructionStream;
+
+/** @brief Native code that calculates the program once */
+typedef double (*NativeScalarEntry)(double *a_values);
+/** @brief Native code that calculates the program for a_size rows */
+typedef void (*NativeBatchEntry)(double *a_values,
+                                 const double *const *a_variables,
+                                 double *a_results,
+                                 size_t a_size);
+
+/**
+ * @brief The compiled program, immutable and shared between threads
+ * @details The Program holds what the compilation produced: the instructions,
+ * the initial values of the slots (variables, constants and space for the
+ * generated arguments) and the entry points of the native code if a native
+ * backend was used. Nothing in it changes after construction, so one Program
+ * can be calculated by many threads, each with its own EvaluationContext:
+ *
+ * ```c++
+ * mp->setMath("x*sin(y)");
+ * shared_ptr<const Program> program = mp->program();
+ * // In every thread, no parsing
+ * EvaluationContext context(program);
+ * context.setVariable(0, x);
+ * context.setVariable(1, y);
+ * double result = context.calculate();
+ * ```
+ */
+class Program final {
+public:
+    Program();
+    Program(const vector<Instruction> &a_instructions,
+            const vector<double> &a_values,
+            const uint32_t a_variableSize,
+            const uint32_t a_resultSlot,
+            const shared_ptr<const void> &a_native = nullptr,
+            const NativeScalarEntry a_scalarEntry = nullptr,
+            const NativeBatchEntry a_batchEntry = nullptr);
+    Program(const InstructionStream &a_instructions,
+            const vector<double> &a_values,
+            const uint32_t a_variableSize,
+            const uint32_t a_resultSlot,
+            const shared_ptr<const void> &a_native = nullptr,
+            const NativeScalarEntry a_scalarEntry = nullptr,
+            const NativeBatchEntry a_batchEntry = nullptr);
+
+    static double run(const Instruction *a_instructions,
+                      const size_t a_size,
+                      double *a_values,
+                      const uint32_t a_resultSlot);
+    static const shared_ptr<const Program> &empty();
+
+    const vector<Instruction> &instructions() const;
+    const InstructionStream &instructionStream() const;
+    const vector<double> &values() const;
+    uint32_t variableSize() const;
+    uint32_t resultSlot() const;
+    bool isNative() const;
+    NativeScalarEntry scalarEntry() const;
+    NativeBatchEntry batchEntry() const;
+
+private:
+    Program(const Program &) = delete;
+    Program &operator=(const Program &) = delete;
+
+    const InstructionStream m_instructions; /**< The compiled program */
+    const vector<double> m_values; /**< Initial slots, the variables first */
+    const uint32_t m_variableSize; /**< Number of variables */
+    const uint32_t m_resultSlot; /**< Slot of the result, UINT32_MAX is 0 */
+    const shared_ptr<const void> m_native; /**< Keeps the native code */
+    const NativeScalarEntry m_scalarEntry; /**< Native code or nullptr */
+    const NativeBatchEntry m_batchEntry; /**< Native code or nullptr */
+};
+
+/**
+ * @brief Variables and temporaries for calculating a shared Program
+ * @details The context is the only thing written during the calculation: it
+ * holds the slots (one double per variable, constant and generated argument),
+ * copied from the Program on construction. Creating it doesn't parse or
+ * compile anything. A context must not be used by two threads at once, but
+ * any number of contexts can share one Program.
+ *
+ * Everything is defined in this header and nothing is virtual, so the
+ * calculation can be inlined into the loop of the caller and optimized with it
+ * (also with LTO when linking the static library).
+ */
+class EvaluationContext final {
+public:
+    EvaluationContext();
+    explicit EvaluationContext(const shared_ptr<const Program> &a_program);
+
+    const shared_ptr<const Program> &program() const;
+    uint32_t variableSize() const;
+    void setVariable(const uint32_t a_index, const double a_value);
+    double variable(const uint32_t a_index) const;
+    double calculate();
+    double calculate(const double *a_variables);
+    double operator()(const double *a_variables);
+    void calculateBatch(const double *const *a_variables,
+                        double *a_results,
+                        const size_t a_size);
+
+private:
+    shared_ptr<const Program> m_program; /**< The shared program */
+    vector<double> m_values; /**< Slots of this context */
+};
+
+/**
+ * @brief The context that copies the program out of the MathParser
+ * @details Kept as the name used by MathParser::compiledFunction().
+ */
+typedef EvaluationContext CompiledFunction;
+
+/**
+ * @brief Constructor of an empty program, it always gives zero
+ */
+inline Program::Program():
+    m_instructions(make_shared<const vector<Instruction>>()),
+    m_variableSize(0),
+    m_resultSlot(UINT32_MAX),
+    m_scalarEntry(nullptr),
+    m_batchEntry(nullptr)
+{
+}
+
+/**
+ * @brief Constructor, copies the compiled program
+ * @param a_instructions The compiled program
+ * @param a_values Initial slots of the program with the constants
+ * @param a_variableSize Number of variables (the first slots)
+ * @param a_resultSlot Slot of the result, UINT32_MAX if the result is zero
+ * @param a_native Owner of the native code, released with the last Program
+ * @param a_scalarEntry Native code of the calculation or nullptr
+ * @param a_batchEntry Native code of the batch calculation or nullptr
+ */
+inline Program::Program(const vector<Instruction> &a_instructions,
+                        const vector<double> &a_values,
+                        const uint32_t a_variableSize,
+                        const uint32_t a_resultSlot,
+                        const shared_ptr<const void> &a_native,
+                        const NativeScalarEntry a_scalarEntry,
+                        const NativeBatchEntry a_batchEntry):
+    m_instructions(make_shared<const vector<Instruction>>(a_instructions)),
+    m_values(a_values),
+    m_variableSize(a_variableSize),
+    m_resultSlot(a_resultSlot),
+    m_native(a_native),
+    m_scalarEntry(a_scalarEntry),
+    m_batchEntry(a_batchEntry)
+{
+}
+
+/**
+ * @brief Constructor, shares the instructions of the compiled program
+ * @details Only the initial slots are copied, so programs made from the same
+ * InstructionStream keep one copy of the instructions.
+ * @param a_instructions The compiled program, not nullptr
+ * @param a_values Initial slots of the program with the constants
+ * @param a_variableSize Number of variables (the first slots)
+ * @param a_resultSlot Slot of the result, UINT32_MAX if the result is zero
+ * @param a_native Owner of the native code, released with the last Program
+ * @param a_scalarEntry Native code of the calculation or nullptr
+ * @param a_batchEntry Native code of the batch calculation or nullptr
+ */
+inline Program::Program(const InstructionStream &a_instructions,
+                        const vector<double> &a_values,
+                        const uint32_t a_variableSize,
+                        const uint32_t a_resultSlot,
+                        const shared_ptr<const void> &a_native,
+                        const NativeScalarEntry a_scalarEntry,
+                        const NativeBatchEntry a_batchEntry):
+    m_instructions(a_instructions),
+    m_values(a_values),
+    m_variableSize(a_variableSize),
+    m_resultSlot(a_resultSlot),
+    m_native(a_native),
+    m_scalarEntry(a_scalarEntry),
+    m_batchEntry(a_batchEntry)
+{
+}
+
+/**
+ * @brief Interpreter of the compiled program
+ * @param a_instructions Array of the instructions
+ * @param a_size Number of instructions
+ * @param a_values The slots of the program
+ * @param a_resultSlot Slot of the result, UINT32_MAX if the result is zero
+ * @return **double** Value of the result slot
+ */
+inline double Program::run(const Instruction *a_instructions,
+                           const size_t a_size,
+                           double *a_values,
+                           const uint32_t a_resultSlot)
+{
+    for (size_t i = 0; i < a_size; i++) {
+        const Instruction &ins = a_instructions[i];
+        switch (ins.code) {
+        case OpCode::Add:
+            a_values[ins.result] = a_values[ins.arg1] + a_values[ins.arg2];
+            break;
+        case OpCode::Subtract:
+            a_values[ins.result] = a_values[ins.arg1] - a_values[ins.arg2];
+            break;
+        case OpCode::Multiply:
+            a_values[ins.result] = a_values[ins.arg1] * a_values[ins.arg2];
+            break;
+        case OpCode::Divide:
+            a_values[ins.result] = a_values[ins.arg1] / a_values[ins.arg2];
+            break;
+        case OpCode::CallOneArg:
+            a_values[ins.result] = ins.ddFunction(a_values[ins.arg1]);
+            break;
+        case OpCode::CallTwoArg:
+            a_values[ins.result] = ins.dddFunction(a_values[ins.arg1],
+                                                   a_values[ins.arg2]);
+            break;
+        }
+    }
+    if (a_resultSlot == UINT32_MAX)
+        return 0.0;
+    return a_values[a_resultSlot];
+}
+
+/**
+ * @brief The shared empty program
+ */
+inline const shared_ptr<const Program> &Program::empty()
+{
+    static const shared_ptr<const Program> program(new Program);
+    return program;
+}
+
+/**
+ * @brief Getter of the instructions
+ */
+inline const vector<Instruction> &Program::instructions() const
+{
+    return *m_instructions;
+}
+
+/**
+ * @brief Getter of the shared instructions
+ */
+inline const InstructionStream &Program::instructionStream() const
+{
+    return m_instructions;
+}
+
+/**
+ * @brief Getter of the initial slots
+ */
+inline const vector<double> &Program::values() const
+{
+    return m_values;
+}
+
+/**
+ * @brief Return the number of variables
+ */
+inline uint32_t Program::variableSize() const
+{
+    return m_variableSize;
+}
+
+/**
+ * @brief Getter of the slot of the result, UINT32_MAX if the result is zero
+ */
+inline uint32_t Program::resultSlot() const
+{
+    return m_resultSlot;
+}
+
+/**
+ * @brief Tells if the program is calculated by native code
+ */
+inline bool Program::isNative() const
+{
+    return m_scalarEntry != nullptr && m_batchEntry != nullptr;
+}
+
+/**
+ * @brief Getter of the native scalar entry, nullptr for the interpreter
+ */
+inline NativeScalarEntry Program::scalarEntry() const
+{
+    return m_scalarEntry;
+}
+
+/**
+ * @brief Getter of the native batch entry, nullptr for the interpreter
+ */
+inline NativeBatchEntry Program::batchEntry() const
+{
+    return m_batchEntry;
+}
+
+/**
+ * @brief Constructor of a context of the empty program
+ */
+inline EvaluationContext::EvaluationContext():
+    m_program(Program::empty())
+{
+}
+
+/**
+ * @brief Constructor, copies the initial slots of the program
+ * @param a_program The shared program, nullptr is the empty program
+ */
+inline EvaluationContext::EvaluationContext(
+        const shared_ptr<const Program> &a_program):
+    m_program(a_program ? a_program : Program::empty()),
+    m_values(m_program->values())
+{
+}
+
+/**
+ * @brief Getter of the shared program
+ */
+inline const shared_ptr<const Program> &EvaluationContext::program() const
+{
+    return m_program;
+}
+
+/**
+ * @brief Return the number of variables
+ */
+inline uint32_t EvaluationContext::variableSize() const
+{
+    return m_program->variableSize();
+}
+
+/**
+ * @brief Sets the variable of this context
+ * @param a_index Index of the variable as in MathParser::getVariableName()
+ * @param a_value The value
+ */
+inline void EvaluationContext::setVariable(const uint32_t a_index,
+                                           const double a_value)
+{
+    if (a_index < m_program->variableSize())
+        m_values[a_index] = a_value;
+}
+
+/**
+ * @brief Getter of the variable of this context
+ * @param a_index Index of the variable as in MathParser::getVariableName()
+ * @return **double** The value or zero if there is no such variable
+ */
+inline double EvaluationContext::variable(const uint32_t a_index) const
+{
+    if (a_index < m_program->variableSize())
+        return m_values[a_index];
+    return 0.0;
+}
+
+/**
+ * @brief Calculates the program with the variables of this context
+ * @return **double** The result
+ */
+inline double EvaluationContext::calculate()
+{
+    const Program &program = *m_program;
+    if (program.scalarEntry() != nullptr)
+        return program.scalarEntry()(m_values.data());
+    return Program::run(program.instructions().data(),
+                        program.instructions().size(),
+                        m_values.data(), program.resultSlot());
+}
+
+/**
+ * @brief Sets all the variables and calculates the program
+ * @param a_variables Array of variableSize() values, ordered as
+ * MathParser::getVariableName()
+ * @return **double** The result
+ */
+inline double EvaluationContext::calculate(const double *a_variables)
+{
+    const uint32_t variableSize = m_program->variableSize();
+    for (uint32_t i = 0; i < variableSize; i++) {
+        m_values[i] = a_variables[i];
+    }
+    return calculate();
+}
+
+/**
+ * @brief Same as calculate(a_variables)
+ */
+inline double EvaluationContext::operator()(const double *a_variables)
+{
+    return calculate(a_variables);
+}
+
+/**
+ * @brief Calculates the program for many sets of variables
+ * @details Same as MathParser::calculateBatch(). After the call the variables
+ * of the context keep the values of the last row.
+ * @param a_variables Array of variableSize() columns of a_size values
+ * @param a_results Array of a_size values for the results
+ * @param a_size Number of rows
+ */
+inline void EvaluationContext::calculateBatch(const double *const *a_variables,
+                                              double *a_results,
+                                              const size_t a_size)
+{
+    const Program &program = *m_program;
+    if (program.batchEntry() != nullptr) {
+        program.batchEntry()(m_values.data(), a_variables, a_results, a_size);
+        return;
+    }
+    const uint32_t variableSize = program.variableSize();
+    for (size_t i = 0; i < a_size; i++) {
+        for (uint32_t j = 0; j < variableSize; j++) {
+            m_values[j] = a_variables[j][i];
+        }
+        a_results[i] = Program::run(program.instructions().data(),
+                                    program.instructions().size(),
+                                    m_values.data(), program.resultSlot());
+    }
+}
+
+}
+
+#endif // PSSMATHCORE_H
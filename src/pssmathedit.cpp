@@ -0,0 +1,379 @@
+/**
+ *  @file pssmathedit.cpp
+ *  @brief Recompiling an expression after edits of its text
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathedit.h"
+
+using namespace PssMathParser;
+
+namespace {
+
+/**
+ * @brief Name of letters only, the parser reads digits as numbers
+ * @param a_index Number of the name
+ * @return **string** a, b, ..., z, ba, bb, ...
+ */
+string letters(size_t a_index)
+{
+    string name;
+    do {
+        name.insert(name.begin(), char('a' + a_index % 26));
+        a_index /= 26;
+    } while (a_index > 0);
+    return name;
+}
+
+/**
+ * @brief Tells if the parentheses of the text are in pairs
+ */
+bool isBalanced(const string &a_text)
+{
+    size_t depth = 0;
+    for (char c : a_text) {
+        if (c == '(')
+            depth++;
+        else if (c == ')' && depth-- == 0)
+            return false;
+    }
+    return depth == 0;
+}
+
+}
+
+/**
+ * @brief Constructor without an expression
+ */
+ExpressionEditor::ExpressionEditor():
+    m_root(NoGroup),
+    m_nextId(0),
+    m_statistics({ 0, 0, 0 })
+{
+    fail("The expression is empty");
+}
+
+/**
+ * @brief Compiles the whole expression
+ * @details The indices of the variables are the ones of the order of
+ * appearance, like in a MathExpression.
+ * @param a_expression The infix expression
+ * @return **true** The expression is compiled
+ * @return **false** The expression has an error, see errorString()
+ */
+bool ExpressionEditor::setText(const string &a_expression)
+{
+    m_text = a_expression;
+    m_variableNames.clear();
+    m_statistics.compiledGroups = 0;
+    m_statistics.compiledLength = 0;
+    return rebuild();
+}
+
+/**
+ * @brief Replaces a part of the text and compiles the changed groups
+ * @details The text is changed also if the new expression has an error, the
+ * next edits fix it.
+ * @param a_position Position of the first replaced character
+ * @param a_length Number of replaced characters, 0 to insert
+ * @param a_replacement The new characters, empty to erase
+ * @return **true** The new expression is compiled
+ * @return **false** The new expression has an error or the range isn't in the
+ * text, see errorString()
+ */
+bool ExpressionEditor::edit(const size_t a_position, const size_t a_length,
+                            const string &a_replacement)
+{
+    if (a_position > m_text.size() || a_length > m_text.size() - a_position)
+        return fail("The edit is outside of the text");
+    const size_t end = a_position + a_length;
+    m_text.replace(a_position, a_length, a_replacement);
+    m_statistics.compiledGroups = 0;
+    m_statistics.compiledLength = 0;
+    if (m_root == NoGroup || isBalanced(a_replacement) == false)
+        return rebuild();
+
+    // The innermost group that holds the whole edit
+    size_t id = m_root;
+    for (bool inner = true; inner;) {
+        inner = false;
+        for (size_t child : m_groups[id].children) {
+            const Group &group = m_groups[child];
+            if (a_position >= group.begin && end <= group.end) {
+                id = child;
+                inner = true;
+                break;
+            }
+        }
+    }
+
+    // Its inner groups are out of the edit or replaced with it
+    vector<size_t> &children = m_groups[id].children;
+    vector<size_t> kept;
+    for (size_t child : children) {
+        const Group &group = m_groups[child];
+        if (group.end < a_position || group.begin - 1 >= end)
+            kept.push_back(child);
+        else if (group.begin - 1 >= a_position && group.end < end)
+            remove(child);
+        else
+            return rebuild();
+    }
+    children.swap(kept);
+
+    for (auto &igroup : m_groups) {
+        Group &group = igroup.second;
+        if (igroup.first != id && group.begin >= end)
+            group.begin = group.begin - a_length + a_replacement.size();
+        if (group.end >= end)
+            group.end = group.end - a_length + a_replacement.size();
+    }
+    if (split(id) == false)
+        return rebuild();
+    return link();
+}
+
+/**
+ * @brief The expression with all the edits
+ */
+const string &ExpressionEditor::text() const
+{
+    return m_text;
+}
+
+/**
+ * @brief The program of the text and the names of its variables
+ * @details The program is nullptr if the text has an error.
+ */
+const CompiledExpression &ExpressionEditor::compiled() const
+{
+    return m_compiled;
+}
+
+/**
+ * @brief Description of the error of the text
+ */
+const string ExpressionEditor::errorString() const
+{
+    return m_compiled.errorString;
+}
+
+/**
+ * @brief Copy of the counters
+ */
+ExpressionEditor::Statistics ExpressionEditor::statistics() const
+{
+    return m_statistics;
+}
+
+/**
+ * @brief Splits and compiles the whole text again
+ * @details The names of the groups start with a prefix that no name of the
+ * text starts with.
+ * @return **true** The expression is compiled
+ * @return **false** The expression has an error
+ */
+bool ExpressionEditor::rebuild()
+{
+    m_linker = ExpressionLinker();
+    m_groups.clear();
+    m_root = NoGroup;
+
+    vector<string> names;
+    string name;
+    for (size_t i = 0; i <= m_text.size(); i++) {
+        if (i < m_text.size() && isalpha(m_text[i])) {
+            name.push_back(m_text[i]);
+        }
+        else if (i == m_text.size()
+                 || (m_text[i] != ' ' && m_text[i] != '\t')) {
+            if (name.empty() == false)
+                names.push_back(name);
+            name.clear();
+        }
+    }
+    m_prefix = "group";
+    for (bool used = true; used;) {
+        used = false;
+        for (const string &iname : names) {
+            if (iname.compare(0, m_prefix.size(), m_prefix) == 0) {
+                m_prefix.push_back('z');
+                used = true;
+                break;
+            }
+        }
+    }
+
+    const size_t id = m_nextId++;
+    Group &root = m_groups[id];
+    root.begin = 0;
+    root.end = m_text.size();
+    if (split(id) == false) {
+        m_linker = ExpressionLinker();
+        m_groups.clear();
+        m_statistics.groups = 0;
+        return fail("The parentheses of the expression aren't in pairs");
+    }
+    m_root = id;
+    return link();
+}
+
+/**
+ * @brief Finds the inner groups of the group and compiles it
+ * @details The inner groups already in the children of the group are kept,
+ * the new ones are split and compiled first.
+ * @param a_id Id of the group, its range is in the current text
+ * @return **true** The group is split, also if it has an error
+ * @return **false** The parentheses aren't in pairs or a name of the text
+ * starts with the prefix of the groups
+ */
+bool ExpressionEditor::split(const size_t a_id)
+{
+    unordered_map<size_t, size_t> kept;
+    for (size_t child : m_groups[a_id].children)
+        kept[m_groups[child].begin] = child;
+    const size_t begin = m_groups[a_id].begin;
+    const size_t end = m_groups[a_id].end;
+
+    vector<size_t> children;
+    string text;
+    string name;
+    for (size_t i = begin; i <= end; i++) {
+        const char c = i < end ? m_text[i] : '\0';
+        if (isalpha(c)) {
+            name.push_back(c);
+            continue;
+        }
+        if (c == ' ' || c == '\t') {
+            text.push_back(c);
+            continue;
+        }
+        if (name.compare(0, m_prefix.size(), m_prefix) == 0)
+            return false;
+        text += name;
+        name.clear();
+        if (c == ')')
+            return false;
+        if (c != '(') {
+            if (i < end)
+                text.push_back(c);
+            continue;
+        }
+
+        size_t child;
+        auto ikept = kept.find(i + 1);
+        if (ikept != kept.end()) {
+            child = ikept->second;
+        }
+        else {
+            size_t close = i + 1;
+            for (size_t depth = 0; close < end; close++) {
+                if (m_text[close] == '(')
+                    depth++;
+                else if (m_text[close] == ')' && depth-- == 0)
+                    break;
+            }
+            if (close == end)
+                return false;
+            child = m_nextId++;
+            Group &group = m_groups[child];
+            group.begin = i + 1;
+            group.end = close;
+            if (split(child) == false)
+                return false;
+        }
+        children.push_back(child);
+        text += "(" + groupName(child) + ")";
+        i = m_groups[child].end;
+    }
+
+    Group &group = m_groups[a_id];
+    group.children.swap(children);
+    m_statistics.groups = m_groups.size();
+    m_statistics.compiledGroups++;
+    m_statistics.compiledLength += text.size();
+    if (m_linker.define(groupName(a_id), text)) {
+        group.errorString.clear();
+    }
+    else {
+        group.errorString = m_linker.errorString();
+        m_linker.undefine(groupName(a_id));
+    }
+    return true;
+}
+
+/**
+ * @brief Removes the group with its inner groups
+ */
+void ExpressionEditor::remove(const size_t a_id)
+{
+    for (size_t child : m_groups[a_id].children)
+        remove(child);
+    m_linker.undefine(groupName(a_id));
+    m_groups.erase(a_id);
+    m_statistics.groups = m_groups.size();
+}
+
+/**
+ * @brief Links the program from the compiled groups
+ * @details The error of the first group in the text that has one is the
+ * error of the expression.
+ * @return **true** The program is linked
+ * @return **false** Some group has an error
+ */
+bool ExpressionEditor::link()
+{
+    const Group *error = nullptr;
+    for (const auto &igroup : m_groups) {
+        const Group &group = igroup.second;
+        if (group.errorString.empty() == false
+                && (error == nullptr || group.begin < error->begin))
+            error = &group;
+    }
+    if (error != nullptr)
+        return fail(error->errorString);
+
+    m_compiled = m_linker.link(groupName(m_root), m_variableNames);
+    if (m_compiled.program == nullptr)
+        return false;
+    m_variableNames = m_compiled.variableNames;
+    return true;
+}
+
+/**
+ * @brief Sets the error as the result
+ * @param a_errorString Description of the error
+ * @return **bool** Always false
+ */
+bool ExpressionEditor::fail(const string &a_errorString)
+{
+    m_compiled = CompiledExpression();
+    m_compiled.expressionError = 0;
+    m_compiled.reversePolishError = 0;
+    m_compiled.errorString = a_errorString;
+    return false;
+}
+
+/**
+ * @brief Name of the group in the texts of the other groups
+ */
+string ExpressionEditor::groupName(const size_t a_id) const
+{
+    return m_prefix + letters(a_id);
+}
@@ -0,0 +1,109 @@
+/**
+ *  @file pssmathedit.h
+ *  @brief Headers for recompiling an expression after edits of its text
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHEDIT_H
+#define PSSMATHEDIT_H
+
+#include "pssmathlink.h"
+
+namespace PssMathParser {
+
+/**
+ * @brief Text of an expression that is compiled again after every edit
+ * @details The text is split in groups, the text inside every pair of
+ * parentheses is a group and the whole text is the root group. Every group is
+ * compiled alone with its inner groups replaced by names, as a definition of
+ * an ExpressionLinker, and the program is linked from the root. An edit
+ * compiles again only the innermost group that holds the whole edit, with the
+ * groups the edit adds; the other groups keep their compiled programs. The
+ * linked program calculates the same results as the whole text compiled by a
+ * MathExpression.
+ *
+ * The variables keep their indices through the edits: the new variables are
+ * added after the old ones and the variables that are no longer read stay
+ * until setText(). An edit that changes the pairs of parentheses around it
+ * compiles the whole text again, as setText().
+ *
+ * ```c++
+ * ExpressionEditor editor;
+ * editor.setText("Io*(exp(V/(kBJ*(ToK+TC)/qe))-1)");
+ * editor.edit(20, 2, "Tj"); // compiles only "ToK+Tj" again
+ * EvaluationContext context(editor.compiled().program);
+ * ```
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC ExpressionEditor {
+public:
+    /**
+     * @brief Counters of the editor
+     */
+    struct Statistics {
+        size_t groups; /**< Groups of the text */
+        size_t compiledGroups; /**< Groups compiled by the last change */
+        size_t compiledLength; /**< Characters compiled by the last change */
+    };
+
+    ExpressionEditor();
+
+    bool setText(const string &a_expression);
+    bool edit(const size_t a_position, const size_t a_length,
+              const string &a_replacement);
+
+    const string &text() const;
+    const CompiledExpression &compiled() const;
+    const string errorString() const;
+    Statistics statistics() const;
+
+private:
+    /** @brief Index of no group */
+    static const size_t NoGroup = SIZE_MAX;
+
+    /**
+     * @brief Text inside a pair of parentheses, or the whole text
+     */
+    struct Group {
+        size_t begin; /**< Position of the first character */
+        size_t end; /**< Position after the last character */
+        vector<size_t> children; /**< Ids of the inner groups, in order */
+        string errorString; /**< Error of the compilation, empty if none */
+    };
+
+    bool rebuild();
+    bool split(const size_t a_id);
+    void remove(const size_t a_id);
+    bool link();
+    bool fail(const string &a_errorString);
+    string groupName(const size_t a_id) const;
+
+    string m_text; /**< The expression */
+    string m_prefix; /**< Start of the names of the groups */
+    unordered_map<size_t, Group> m_groups; /**< Groups by id */
+    size_t m_root; /**< Id of the root group, NoGroup if there is none */
+    size_t m_nextId; /**< Id of the next group */
+    ExpressionLinker m_linker; /**< Compiled groups */
+    vector<string> m_variableNames; /**< Variables in the order of indices */
+    CompiledExpression m_compiled; /**< The linked program */
+    Statistics m_statistics; /**< Counters of the editor */
+};
+
+}
+
+#endif // PSSMATHEDIT_H
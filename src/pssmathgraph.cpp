@@ -0,0 +1,344 @@
+/**
+ *  @file pssmathgraph.cpp
+ *  @brief Reactive graph of many expressions
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathgraph.h"
+#include <string.h>
+
+using namespace PssMathParser;
+
+namespace {
+
+/**
+ * @brief Tests if the values have the same bits
+ * @details -0.0 and 0.0 are different, 1/x gives results of opposite sign,
+ * and a NaN is the same as itself, so it isn't propagated again.
+ */
+bool isSameValue(const double a_first, const double a_second)
+{
+    return memcmp(&a_first, &a_second, sizeof(double)) == 0;
+}
+
+}
+
+/**
+ * @brief Constructor of an empty graph
+ */
+ExpressionGraph::ExpressionGraph():
+    m_nextId(1),
+    m_updateDepth(0),
+    m_propagating(false),
+    m_calculations(0),
+    m_notifications(0)
+{
+}
+
+/**
+ * @brief Adds a named expression
+ * @details The variables of the expression become names of the namespace,
+ * the ones that are names of expressions defined before are their results.
+ * The expression is calculated at once with the current values. The name must
+ * not be defined yet, must not be read by other expressions and must not be a
+ * constant or an operator of the parser.
+ * @param a_name Name of the result
+ * @param a_expression The infix expression
+ * @return **true** The expression is defined
+ * @return **false** The expression has an error or the name can't be used,
+ * see errorString()
+ */
+bool ExpressionGraph::define(const string &a_name, const string &a_expression)
+{
+    m_errorString.clear();
+    auto isymbol = m_symbols.find(a_name);
+    if (a_name.empty()) {
+        m_errorString = "The name is empty";
+        return false;
+    }
+    if (MathExpression::constantMap.count(a_name) > 0
+            || MathExpression::operatorMap.count(a_name) > 0) {
+        m_errorString = a_name + " is a constant or an operator";
+        return false;
+    }
+    if (isymbol != m_symbols.end() && isymbol->second.node != NoNode) {
+        m_errorString = a_name + " is already defined";
+        return false;
+    }
+    if (isymbol != m_symbols.end()
+            && isymbol->second.readers.empty() == false) {
+        m_errorString = a_name + " is a variable of other expressions";
+        return false;
+    }
+
+    Node node;
+    node.name = a_name;
+    node.expression.setBackend(EvaluationBackend::Incremental);
+    CompiledExpression compiled = node.expression.compile(a_expression);
+    if (compiled.program == nullptr) {
+        m_errorString = compiled.errorString;
+        return false;
+    }
+    for (const string &variable : compiled.variableNames) {
+        if (variable == a_name) {
+            m_errorString = a_name + " reads itself";
+            return false;
+        }
+    }
+
+    const size_t index = m_nodes.size();
+    for (const string &variable : compiled.variableNames) {
+        Symbol &input = symbol(variable);
+        input.readers.push_back(index);
+        node.expression.setVariableDouble(variable, input.value);
+    }
+    double result = node.expression.calculateExpression();
+    m_nodes.push_back(std::move(node));
+    Symbol &output = symbol(a_name);
+    output.node = index;
+    output.value = result;
+    return true;
+}
+
+/**
+ * @brief Description of the error of the last define() or setVariable()
+ */
+const string ExpressionGraph::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * @brief Sets a variable and calculates the expressions that depend on it
+ * @details Inside beginUpdate() and endUpdate() the expressions are
+ * calculated by endUpdate(). Setting the same value calculates nothing.
+ * @param a_name Name of the variable, not of an expression
+ * @param a_value The new value
+ * @return **true** The variable is set
+ * @return **false** The name is an expression
+ */
+bool ExpressionGraph::setVariable(const string &a_name, const double a_value)
+{
+    Symbol &variable = symbol(a_name);
+    if (variable.node != NoNode) {
+        m_errorString = a_name + " is an expression";
+        return false;
+    }
+    assign(variable, a_name, a_value);
+    if (m_updateDepth == 0 && m_propagating == false)
+        propagate();
+    return true;
+}
+
+/**
+ * @brief Sets many variables, every affected expression is calculated once
+ * @param a_values Names and values of the variables
+ * @return **true** All the variables are set
+ * @return **false** Some names are expressions, the others are set
+ */
+bool ExpressionGraph::setVariables(
+        const vector<pair<string, double>> &a_values)
+{
+    bool set = true;
+    beginUpdate();
+    for (const auto &ivalue : a_values) {
+        if (setVariable(ivalue.first, ivalue.second) == false)
+            set = false;
+    }
+    endUpdate();
+    return set;
+}
+
+/**
+ * @brief Starts collecting the changes of the variables
+ * @details The calls can be nested, the last endUpdate() calculates.
+ */
+void ExpressionGraph::beginUpdate()
+{
+    m_updateDepth++;
+}
+
+/**
+ * @brief Calculates the expressions affected since beginUpdate()
+ */
+void ExpressionGraph::endUpdate()
+{
+    if (m_updateDepth > 0)
+        m_updateDepth--;
+    if (m_updateDepth == 0 && m_propagating == false)
+        propagate();
+}
+
+/**
+ * @brief Tells if the name is a defined expression
+ */
+bool ExpressionGraph::isExpression(const string &a_name) const
+{
+    auto isymbol = m_symbols.find(a_name);
+    return isymbol != m_symbols.end() && isymbol->second.node != NoNode;
+}
+
+/**
+ * @brief Current value of a variable or of the result of an expression
+ * @param a_name The name
+ * @return **double** The value, NaN if the name is unknown
+ */
+double ExpressionGraph::value(const string &a_name) const
+{
+    auto isymbol = m_symbols.find(a_name);
+    if (isymbol == m_symbols.end())
+        return NAN;
+    return isymbol->second.value;
+}
+
+/**
+ * @brief Names of the expressions that read the name as a variable
+ * @param a_name Name of a variable or an expression
+ * @return **vector<string>** The expressions, in the order of definition
+ */
+vector<string> ExpressionGraph::readers(const string &a_name) const
+{
+    vector<string> names;
+    auto isymbol = m_symbols.find(a_name);
+    if (isymbol != m_symbols.end()) {
+        for (size_t index : isymbol->second.readers)
+            names.push_back(m_nodes[index].name);
+    }
+    return names;
+}
+
+/**
+ * @brief Calls the callback every time the result of the expression changes
+ * @param a_name Name of the expression
+ * @param a_callback Called with the name and the new value
+ * @return **size_t** Id for unsubscribe(), 0 if the name isn't an expression
+ */
+size_t ExpressionGraph::subscribe(const string &a_name,
+                                  const Callback &a_callback)
+{
+    if (isExpression(a_name) == false)
+        return 0;
+    size_t id = m_nextId++;
+    m_symbols.find(a_name)->second.callbacks.emplace_back(id, a_callback);
+    m_subscriptions[id] = a_name;
+    return id;
+}
+
+/**
+ * @brief Removes the callback of subscribe()
+ * @param a_id Id returned by subscribe()
+ */
+void ExpressionGraph::unsubscribe(const size_t a_id)
+{
+    auto isubscription = m_subscriptions.find(a_id);
+    if (isubscription == m_subscriptions.end())
+        return;
+    vector<pair<size_t, Callback>> &callbacks =
+            m_symbols.find(isubscription->second)->second.callbacks;
+    for (auto icallback = callbacks.begin(); icallback != callbacks.end();
+         ++icallback) {
+        if (icallback->first == a_id) {
+            callbacks.erase(icallback);
+            break;
+        }
+    }
+    m_subscriptions.erase(isubscription);
+}
+
+/**
+ * @brief Copy of the counters
+ */
+ExpressionGraph::Statistics ExpressionGraph::statistics() const
+{
+    Statistics statistics;
+    statistics.expressions = m_nodes.size();
+    statistics.variables = m_symbols.size() - m_nodes.size();
+    statistics.calculations = m_calculations;
+    statistics.notifications = m_notifications;
+    return statistics;
+}
+
+/**
+ * @brief The symbol of the name, a new variable with zero if it is unknown
+ */
+ExpressionGraph::Symbol &ExpressionGraph::symbol(const string &a_name)
+{
+    auto isymbol = m_symbols.find(a_name);
+    if (isymbol == m_symbols.end()) {
+        Symbol symbol;
+        symbol.value = 0.0;
+        symbol.node = NoNode;
+        isymbol = m_symbols.emplace(a_name, std::move(symbol)).first;
+    }
+    return isymbol->second;
+}
+
+/**
+ * @brief Changes the value of the symbol and marks its readers
+ * @param a_symbol The symbol
+ * @param a_name Name of the symbol
+ * @param a_value The new value
+ */
+void ExpressionGraph::assign(Symbol &a_symbol, const string &a_name,
+                             const double a_value)
+{
+    if (isSameValue(a_symbol.value, a_value))
+        return;
+    a_symbol.value = a_value;
+    for (size_t index : a_symbol.readers) {
+        m_nodes[index].expression.setVariableDouble(a_name, a_value);
+        m_pending.insert(index);
+    }
+}
+
+/**
+ * @brief Calculates the marked expressions in the order of definition
+ * @details An expression reads only the expressions defined before it, so
+ * every marked expression is calculated once, after all its inputs.
+ */
+void ExpressionGraph::propagate()
+{
+    m_propagating = true;
+    try {
+        while (m_pending.empty() == false) {
+            const size_t index = *m_pending.begin();
+            m_pending.erase(m_pending.begin());
+            Node &node = m_nodes[index];
+            double result = node.expression.calculateExpression();
+            m_calculations++;
+            Symbol &output = m_symbols.find(node.name)->second;
+            if (isSameValue(output.value, result))
+                continue;
+            assign(output, node.name, result);
+            if (output.callbacks.empty())
+                continue;
+            // A subscriber may unsubscribe in the call
+            vector<pair<size_t, Callback>> callbacks = output.callbacks;
+            for (const auto &icallback : callbacks) {
+                m_notifications++;
+                icallback.second(node.name, result);
+            }
+        }
+    }
+    catch (...) {
+        m_propagating = false;
+        throw;
+    }
+    m_propagating = false;
+}
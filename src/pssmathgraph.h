@@ -0,0 +1,133 @@
+/**
+ *  @file pssmathgraph.h
+ *  @brief Headers for the reactive graph of many expressions
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHGRAPH_H
+#define PSSMATHGRAPH_H
+
+#include "pssmathparser.h"
+#include <functional>
+#include <set>
+
+namespace PssMathParser {
+
+/**
+ * @brief Many named expressions that share one namespace of variables
+ * @details Every expression is compiled once with
+ * EvaluationBackend::Incremental and its result is a name of the namespace,
+ * so other expressions can read it as a variable. An expression can only read
+ * the expressions defined before it, so the graph has no cycles and the order
+ * of definition is an order of calculation.
+ *
+ * When a variable is set only the expressions that read it are calculated
+ * again, and in them only the generators downstream of the variable. If the
+ * result of an expression changes the expressions that read it follow, in the
+ * order of definition, and the subscribers of the expression are called with
+ * the new value. Between beginUpdate() and endUpdate() (or in setVariables())
+ * the changes are collected and every affected expression is calculated and
+ * notified once:
+ *
+ * ```c++
+ * ExpressionGraph graph;
+ * graph.define("Vt", "kBJ*(ToK+TC)/qe"); // kBJ, ToK and qe are constants
+ * graph.define("I", "Io*(exp(V/Vt)-1)");
+ * graph.subscribe("I", [](const string &a_name, double a_value) { ... });
+ * graph.setVariable("TC", 25.0); // calculates Vt, then I, then notifies
+ * ```
+ *
+ * The graph isn't thread safe, it is used like a MathExpression. A subscriber
+ * may set variables, the running propagation calculates their readers too.
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC ExpressionGraph {
+public:
+    /** @brief Called with the name and the new value of an expression */
+    typedef function<void(const string &a_name, double a_value)> Callback;
+
+    /**
+     * @brief Counters of the graph
+     */
+    struct Statistics {
+        size_t expressions; /**< Defined expressions */
+        size_t variables; /**< Names that aren't expressions */
+        size_t calculations; /**< Expressions calculated after a change */
+        size_t notifications; /**< Calls of the subscribers */
+    };
+
+    ExpressionGraph();
+
+    bool define(const string &a_name, const string &a_expression);
+    const string errorString() const;
+
+    bool setVariable(const string &a_name, const double a_value);
+    bool setVariables(const vector<pair<string, double>> &a_values);
+    void beginUpdate();
+    void endUpdate();
+
+    bool isExpression(const string &a_name) const;
+    double value(const string &a_name) const;
+    vector<string> readers(const string &a_name) const;
+
+    size_t subscribe(const string &a_name, const Callback &a_callback);
+    void unsubscribe(const size_t a_id);
+
+    Statistics statistics() const;
+
+private:
+    /** @brief Index of no expression */
+    static const size_t NoNode = SIZE_MAX;
+
+    /**
+     * @brief A name of the namespace, a variable or an expression
+     */
+    struct Symbol {
+        double value; /**< Current value */
+        size_t node; /**< Index of the expression, NoNode for a variable */
+        vector<size_t> readers; /**< Expressions reading it, ascending */
+        vector<pair<size_t, Callback>> callbacks; /**< Subscribers */
+    };
+
+    /**
+     * @brief One defined expression
+     */
+    struct Node {
+        string name; /**< Name of the result */
+        MathExpression expression; /**< Compiled, incremental */
+    };
+
+    Symbol &symbol(const string &a_name);
+    void assign(Symbol &a_symbol, const string &a_name, const double a_value);
+    void propagate();
+
+    vector<Node> m_nodes; /**< Expressions in the order of definition */
+    unordered_map<string, Symbol> m_symbols; /**< The namespace */
+    unordered_map<size_t, string> m_subscriptions; /**< Id to the name */
+    set<size_t> m_pending; /**< Expressions to calculate */
+    string m_errorString; /**< Error of the last define() */
+    size_t m_nextId; /**< Id of the next subscription */
+    unsigned m_updateDepth; /**< Nested beginUpdate() calls */
+    bool m_propagating; /**< propagate() is running */
+    size_t m_calculations; /**< Expressions calculated after a change */
+    size_t m_notifications; /**< Calls of the subscribers */
+};
+
+}
+
+#endif // PSSMATHGRAPH_H
@@ -0,0 +1,205 @@
+/**
+ *  @file pssmathhandle.cpp
+ *  @brief Hot swap of programs of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathhandle.h"
+
+using namespace PssMathParser;
+
+/**
+ * @brief Constructor of a free slot
+ */
+ProgramHandle::ReaderSlot::ReaderSlot():
+    epoch(0),
+    used(false)
+{
+}
+
+/**
+ * @brief Constructor, the program is the version 1
+ * @param a_program The first program, the empty program by default
+ */
+ProgramHandle::ProgramHandle(const shared_ptr<const Program> &a_program):
+    m_current(new Version{a_program, 1}),
+    m_epoch(1),
+    m_version(1)
+{
+}
+
+/**
+ * @brief Destructor, frees all the versions
+ */
+ProgramHandle::~ProgramHandle()
+{
+    for (Retired &retired : m_retired) {
+        delete retired.version;
+    }
+    delete m_current.load();
+}
+
+/**
+ * @brief Makes the program the current version
+ * @details The readers see it on their next ProgramReader::context(). Writers
+ * from many threads are served one after the other. The old versions that no
+ * reader can see are freed here.
+ * @param a_program The new program, e.g. MathParser::program()
+ * @return **uint64_t** Number of the new version
+ */
+uint64_t ProgramHandle::publish(const shared_ptr<const Program> &a_program)
+{
+    lock_guard<mutex> lock(m_mutex);
+    Version *old = m_current.load();
+    Version *version = new Version{a_program, old->number + 1};
+    m_current.store(version);
+    m_version.store(version->number);
+    m_retired.push_back(Retired{old, m_epoch.fetch_add(1) + 1});
+    reclaim();
+    return version->number;
+}
+
+/**
+ * @brief Copy of the current program
+ * @details Takes the lock of the writers, the evaluation threads should use a
+ * ProgramReader.
+ * @return **shared_ptr<const Program>** The current program
+ */
+shared_ptr<const Program> ProgramHandle::load() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_current.load()->program;
+}
+
+/**
+ * @brief Number of the current version
+ * @details The number is kept apart from the version, which a concurrent
+ * publish() may free, so no lock is needed.
+ */
+uint64_t ProgramHandle::version() const
+{
+    return m_version.load();
+}
+
+/**
+ * @brief Number of the swapped versions that are not freed yet
+ */
+size_t ProgramHandle::retiredSize() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_retired.size();
+}
+
+/**
+ * @brief Gives a free slot to a new reader
+ */
+ProgramHandle::ReaderSlot *ProgramHandle::addReader()
+{
+    lock_guard<mutex> lock(m_mutex);
+    for (unique_ptr<ReaderSlot> &slot : m_slots) {
+        if (slot->used == false) {
+            slot->used = true;
+            return slot.get();
+        }
+    }
+    m_slots.push_back(unique_ptr<ReaderSlot>(new ReaderSlot));
+    m_slots.back()->used = true;
+    return m_slots.back().get();
+}
+
+/**
+ * @brief Frees the slot of a destroyed reader
+ */
+void ProgramHandle::removeReader(ReaderSlot *a_slot)
+{
+    lock_guard<mutex> lock(m_mutex);
+    a_slot->epoch.store(0);
+    a_slot->used = false;
+    reclaim();
+}
+
+/**
+ * @brief Frees the retired versions that no reader can see
+ * @details A reader that announced an epoch before the swap may have loaded
+ * the old version. A reader outside or with a later epoch loads the version
+ * after the swap, because it announces the epoch before it loads the version.
+ * Called with m_mutex locked.
+ */
+void ProgramHandle::reclaim()
+{
+    uint64_t oldest = UINT64_MAX;
+    for (unique_ptr<ReaderSlot> &slot : m_slots) {
+        uint64_t epoch = slot->epoch.load();
+        if (epoch != 0 && epoch < oldest)
+            oldest = epoch;
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < m_retired.size(); i++) {
+        if (m_retired[i].epoch <= oldest)
+            delete m_retired[i].version;
+        else
+            m_retired[kept++] = m_retired[i];
+    }
+    m_retired.resize(kept);
+}
+
+/**
+ * @brief Constructor, registers the reader at the handle
+ * @param a_handle The read handle, must live longer than the reader
+ */
+ProgramReader::ProgramReader(ProgramHandle &a_handle):
+    m_handle(a_handle),
+    m_slot(a_handle.addReader()),
+    m_version(0)
+{
+}
+
+/**
+ * @brief Destructor, frees the slot of the reader
+ */
+ProgramReader::~ProgramReader()
+{
+    m_handle.removeReader(m_slot);
+}
+
+/**
+ * @brief Context of the current version
+ * @details The context is made again if a new version was published since the
+ * last call, otherwise it is the same context with the same variables.
+ * @return **EvaluationContext&** Context for the calculation in this thread
+ */
+EvaluationContext &ProgramReader::context()
+{
+    m_slot->epoch.store(m_handle.m_epoch.load());
+    const ProgramHandle::Version *version = m_handle.m_current.load();
+    if (version->number != m_version) {
+        m_context = EvaluationContext(version->program);
+        m_version = version->number;
+    }
+    m_slot->epoch.store(0, memory_order_release);
+    return m_context;
+}
+
+/**
+ * @brief Number of the version of context()
+ */
+uint64_t ProgramReader::version() const
+{
+    return m_version;
+}
@@ -0,0 +1,143 @@
+/**
+ *  @file pssmathhandle.h
+ *  @brief Headers for the hot swap of programs of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHHANDLE_H
+#define PSSMATHHANDLE_H
+
+#include "pssmathparser_global.h"
+#include "pssmathcore.h"
+#include <atomic>
+#include <mutex>
+
+namespace PssMathParser {
+
+class ProgramReader;
+
+/**
+ * @brief The current version of a program, replaced while threads calculate
+ * @details Writers publish() new programs, for example after a new setMath()
+ * of the operator. Every evaluation thread reads the current version through
+ * its own ProgramReader without locks.
+ *
+ * The versions are freed with epoch reclamation. A reader announces the
+ * global epoch while it looks at the current version. publish() swaps the
+ * version, increments the epoch and frees the old versions that no reader can
+ * still see: the readers that are outside or that announced an epoch after
+ * the swap. A version that a reader still sees is freed by a later publish()
+ * or by the destructor. The program itself is shared, a reader keeps it
+ * until it moves to the next version.
+ *
+ * The readers must be destroyed before the handle.
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC ProgramHandle {
+public:
+    explicit ProgramHandle(
+            const shared_ptr<const Program> &a_program = Program::empty());
+    ~ProgramHandle();
+
+    ProgramHandle(const ProgramHandle &) = delete;
+    ProgramHandle &operator=(const ProgramHandle &) = delete;
+
+    uint64_t publish(const shared_ptr<const Program> &a_program);
+    shared_ptr<const Program> load() const;
+    uint64_t version() const;
+    size_t retiredSize() const;
+
+private:
+    friend class ProgramReader;
+
+    /**
+     * @brief One published program
+     */
+    struct Version {
+        shared_ptr<const Program> program; /**< The program */
+        uint64_t number; /**< Counts the publish() calls */
+    };
+
+    /**
+     * @brief Epoch announced by one reader, 0 when it is outside, on its own
+     * cache line
+     */
+    struct ReaderSlot {
+        ReaderSlot();
+
+        atomic<uint64_t> epoch; /**< Epoch seen by the reader or 0 */
+        bool used; /**< Belongs to a living reader */
+        char padding[64 - sizeof(atomic<uint64_t>) - sizeof(bool)];
+    };
+
+    /**
+     * @brief A swapped version and the epoch of the swap
+     */
+    struct Retired {
+        Version *version; /**< The old version */
+        uint64_t epoch; /**< Readers from this epoch don't see it */
+    };
+
+    ReaderSlot *addReader();
+    void removeReader(ReaderSlot *a_slot);
+    void reclaim();
+
+    atomic<Version *> m_current; /**< Version read by the readers */
+    atomic<uint64_t> m_epoch; /**< Global epoch, starts with 1 */
+    atomic<uint64_t> m_version; /**< Number of m_current, read without lock */
+    mutable mutex m_mutex; /**< Guards the writers and the members below */
+    vector<unique_ptr<ReaderSlot>> m_slots; /**< Slots of the readers */
+    vector<Retired> m_retired; /**< Versions waiting to be freed */
+};
+
+/**
+ * @brief Access of one evaluation thread to a ProgramHandle
+ * @details Every thread makes its own reader and calls context() before the
+ * calculation. The call is wait free: two atomic stores and two loads, the
+ * EvaluationContext is only made again when a new version was published. The
+ * variables are not kept over a new version.
+ *
+ * ```c++
+ * ProgramReader reader(handle);
+ * while (running) {
+ *     EvaluationContext &context = reader.context();
+ *     double result = context.calculate(variables);
+ * }
+ * ```
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC ProgramReader {
+public:
+    explicit ProgramReader(ProgramHandle &a_handle);
+    ~ProgramReader();
+
+    ProgramReader(const ProgramReader &) = delete;
+    ProgramReader &operator=(const ProgramReader &) = delete;
+
+    EvaluationContext &context();
+    uint64_t version() const;
+
+private:
+    ProgramHandle &m_handle; /**< The read handle */
+    ProgramHandle::ReaderSlot *m_slot; /**< Epoch of this reader */
+    uint64_t m_version; /**< Version of the context, 0 before the first */
+    EvaluationContext m_context; /**< Context of the current version */
+};
+
+}
+
+#endif // PSSMATHHANDLE_H
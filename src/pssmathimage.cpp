@@ -0,0 +1,694 @@
+/**
+ *  @file pssmathimage.cpp
+ *  @brief Binary file of compiled programs
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathimage.h"
+#include "pssmathshare.h"
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PSSMATHPARSER_IMAGE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define PSSMATHPARSER_IMAGE_MMAP 0
+#endif
+
+namespace PssMathParser {
+
+/**
+ * @brief Beginning of the file
+ */
+struct ImageHeader {
+    char magic[8]; /**< Tells that the file is a program image */
+    uint32_t version; /**< Version of the format */
+    uint32_t byteOrder; /**< ByteOrder in the byte order of the writer */
+    uint64_t fileSize; /**< Bytes of the file */
+    uint64_t functionOffset; /**< Offset of the table of the functions */
+    uint64_t programOffset; /**< Offset of the table of the programs */
+    uint32_t functionSize; /**< Number of the functions */
+    uint32_t programSize; /**< Number of the programs */
+    uint32_t maxSlotSize; /**< Largest number of slots of a program */
+    uint32_t reserved; /**< Keeps the tables aligned */
+};
+
+/**
+ * @brief Function called by the instructions, by its name in the operatorMap
+ */
+struct ImageFunction {
+    uint64_t nameOffset; /**< Offset of the name */
+    uint32_t argumentSize; /**< 1 or 2 */
+    uint32_t reserved; /**< Keeps the table aligned */
+};
+
+/**
+ * @brief One program of the file
+ */
+struct ImageProgram {
+    uint64_t nameOffset; /**< Offset of the name of the program */
+    uint64_t instructionOffset; /**< Offset of the instructions */
+    uint64_t valueOffset; /**< Offset of the initial slots */
+    uint64_t variableNameOffset; /**< Offset of the offsets of the names */
+    uint32_t instructionSize; /**< Number of instructions */
+    uint32_t valueSize; /**< Number of slots */
+    uint32_t variableSize; /**< Number of variables, the first slots */
+    uint32_t resultSlot; /**< Slot of the result, UINT32_MAX is 0 */
+    uint32_t level; /**< EvaluationBackend of the program */
+    uint32_t reserved; /**< Keeps the table aligned */
+};
+
+/**
+ * @brief Instruction of the file, the function is an index in the file
+ */
+struct ImageInstruction {
+    uint32_t code; /**< The OpCode */
+    uint32_t arg1; /**< Slot of the first argument */
+    uint32_t arg2; /**< Slot of the second argument */
+    uint32_t result; /**< Slot of the generated argument */
+    uint32_t function; /**< Index of the function or UINT32_MAX */
+    uint32_t reserved; /**< Keeps the instructions aligned */
+};
+
+}
+
+using namespace PssMathParser;
+
+namespace {
+
+/** @brief First bytes of the file */
+const char Magic[8] = { 'P', 'S', 'S', 'M', 'A', 'T', 'H', '\0' };
+/** @brief Written in the byte order of the machine */
+const uint32_t ByteOrder = 0x01020304;
+/** @brief ByteOrder read on a machine of the other byte order */
+const uint32_t OtherByteOrder = 0x04030201;
+/** @brief Alignment of the tables and of the arrays */
+const size_t Alignment = 8;
+/** @brief Numbers the temporary files of save() */
+atomic<uint64_t> g_temporaryCounter(0);
+
+static_assert(sizeof(ImageHeader) == 56, "ImageHeader has no padding");
+static_assert(sizeof(ImageFunction) == 16, "ImageFunction has no padding");
+static_assert(sizeof(ImageProgram) == 56, "ImageProgram has no padding");
+static_assert(sizeof(ImageInstruction) == 24,
+              "ImageInstruction has no padding");
+
+/**
+ * @brief Appends the array at the next aligned offset
+ * @return **uint64_t** Offset of the array
+ */
+uint64_t append(vector<char> &a_bytes, const void *a_data, const size_t a_size)
+{
+    a_bytes.resize((a_bytes.size() + Alignment - 1) / Alignment * Alignment);
+    const uint64_t offset = a_bytes.size();
+    a_bytes.resize(a_bytes.size() + a_size);
+    if (a_size != 0)
+        memcpy(a_bytes.data() + offset, a_data, a_size);
+    return offset;
+}
+
+/**
+ * @brief Calculates the instructions of the file in the slots
+ * @details Same as Program::run(), the functions are found by their index.
+ */
+double run(const ImageInstruction *a_instructions,
+           const size_t a_size,
+           double *a_values,
+           const uint32_t a_resultSlot,
+           const DDFunction *a_ddFunctions,
+           const DDDFunction *a_dddFunctions)
+{
+    for (size_t i = 0; i < a_size; i++) {
+        const ImageInstruction &ins = a_instructions[i];
+        switch (OpCode(ins.code)) {
+        case OpCode::Add:
+            a_values[ins.result] = a_values[ins.arg1] + a_values[ins.arg2];
+            break;
+        case OpCode::Subtract:
+            a_values[ins.result] = a_values[ins.arg1] - a_values[ins.arg2];
+            break;
+        case OpCode::Multiply:
+            a_values[ins.result] = a_values[ins.arg1] * a_values[ins.arg2];
+            break;
+        case OpCode::Divide:
+            a_values[ins.result] = a_values[ins.arg1] / a_values[ins.arg2];
+            break;
+        case OpCode::CallOneArg:
+            a_values[ins.result] =
+                    a_ddFunctions[ins.function](a_values[ins.arg1]);
+            break;
+        case OpCode::CallTwoArg:
+            a_values[ins.result] = a_dddFunctions[ins.function](
+                        a_values[ins.arg1], a_values[ins.arg2]);
+            break;
+        }
+    }
+    if (a_resultSlot == UINT32_MAX)
+        return 0.0;
+    return a_values[a_resultSlot];
+}
+
+}
+
+/**
+ * @brief Constructor of an image without programs
+ */
+ProgramImage::ProgramImage():
+    m_data(nullptr),
+    m_size(0),
+    m_mapped(false),
+    m_header(nullptr),
+    m_programs(nullptr)
+{
+}
+
+/**
+ * @brief Destructor, unmaps the file
+ */
+ProgramImage::~ProgramImage()
+{
+    close();
+}
+
+/**
+ * @brief Writes the programs to a new file
+ * @details The programs keep their order, their instructions and their
+ * initial slots, so a loaded program gives the same results. The functions
+ * are written by their names, the memoized ones by the names of the plain
+ * functions. The names of the programs can be empty.
+ * @param a_fileName Path of the file, replaced if it exists. The file is
+ * written under another name and renamed, so the processes that have the old
+ * file loaded keep it
+ * @param a_programs The compiled programs
+ * @param a_names Names of the programs for find(), none or one per program
+ * @param a_level Optimization level of the programs, the backend to use
+ * when a loaded program is compiled again
+ * @return **true** The file is written
+ * @return **false** A program or the file has an error, see errorString()
+ */
+bool ProgramImage::save(const string &a_fileName,
+                        const vector<CompiledExpression> &a_programs,
+                        const vector<string> &a_names,
+                        const EvaluationBackend a_level)
+{
+    m_errorString.clear();
+    if (a_names.empty() == false && a_names.size() != a_programs.size()) {
+        m_errorString = "There are " + to_string(a_names.size())
+                + " names for " + to_string(a_programs.size()) + " programs";
+        return false;
+    }
+
+    // The names of the functions, of the programs and of the variables
+    string strings;
+    auto addString = [&strings](const string &a_string) -> uint64_t {
+        uint64_t offset = sizeof(ImageHeader) + strings.size();
+        strings += a_string;
+        strings += '\0';
+        return offset;
+    };
+    vector<ImageFunction> functions;
+    unordered_map<string, uint32_t> functionIndices;
+    vector<vector<ImageInstruction>> instructions(a_programs.size());
+    vector<ImageProgram> programs(a_programs.size());
+    vector<vector<uint64_t>> variableNames(a_programs.size());
+    uint32_t maxSlotSize = 0;
+    for (size_t p = 0; p < a_programs.size(); p++) {
+        const shared_ptr<const Program> &program = a_programs[p].program;
+        if (program == nullptr) {
+            m_errorString = "The program " + to_string(p)
+                    + " has an error: " + a_programs[p].errorString;
+            return false;
+        }
+        if (a_programs[p].variableNames.size() != program->variableSize()) {
+            m_errorString = "The program " + to_string(p)
+                    + " has no name of every variable";
+            return false;
+        }
+        for (const Instruction &ins : program->instructions()) {
+            ImageInstruction out = { uint32_t(ins.code), ins.arg1, ins.arg2,
+                                     ins.result, UINT32_MAX, 0 };
+            if (ins.code == OpCode::CallOneArg
+                    || ins.code == OpCode::CallTwoArg) {
+                const string name = MathExpression::operatorName(ins);
+                if (name.empty()) {
+                    m_errorString = "The program " + to_string(p)
+                            + " calls a function that isn't an operator";
+                    return false;
+                }
+                auto ifunction = functionIndices.find(name);
+                if (ifunction == functionIndices.end()) {
+                    ImageFunction function = {
+                        addString(name),
+                        ins.code == OpCode::CallOneArg ? 1u : 2u, 0 };
+                    ifunction = functionIndices.emplace(
+                                name, uint32_t(functions.size())).first;
+                    functions.push_back(function);
+                }
+                out.function = ifunction->second;
+            }
+            instructions[p].push_back(out);
+        }
+        ImageProgram &out = programs[p];
+        memset(&out, 0, sizeof(out));
+        out.nameOffset = addString(a_names.empty() ? string() : a_names[p]);
+        out.instructionSize = uint32_t(instructions[p].size());
+        out.valueSize = uint32_t(program->values().size());
+        out.variableSize = program->variableSize();
+        out.resultSlot = program->resultSlot();
+        out.level = uint32_t(a_level);
+        for (const string &variable : a_programs[p].variableNames)
+            variableNames[p].push_back(addString(variable));
+        maxSlotSize = max(maxSlotSize, out.valueSize);
+    }
+
+    // The strings first, then the tables, then the arrays of every program
+    vector<char> bytes(sizeof(ImageHeader));
+    bytes.insert(bytes.end(), strings.begin(), strings.end());
+    ImageHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.byteOrder = ByteOrder;
+    header.functionSize = uint32_t(functions.size());
+    header.programSize = uint32_t(programs.size());
+    header.maxSlotSize = maxSlotSize;
+    header.functionOffset = append(bytes, functions.data(),
+                                   functions.size() * sizeof(ImageFunction));
+    header.programOffset = append(bytes, programs.data(),
+                                  programs.size() * sizeof(ImageProgram));
+    for (size_t p = 0; p < programs.size(); p++) {
+        const vector<double> &values = a_programs[p].program->values();
+        programs[p].instructionOffset = append(
+                    bytes, instructions[p].data(),
+                    instructions[p].size() * sizeof(ImageInstruction));
+        programs[p].valueOffset = append(bytes, values.data(),
+                                         values.size() * sizeof(double));
+        programs[p].variableNameOffset = append(
+                    bytes, variableNames[p].data(),
+                    variableNames[p].size() * sizeof(uint64_t));
+    }
+    bytes.resize((bytes.size() + Alignment - 1) / Alignment * Alignment);
+    header.fileSize = bytes.size();
+    memcpy(bytes.data(), &header, sizeof(header));
+    if (programs.empty() == false) {
+        memcpy(bytes.data() + header.programOffset, programs.data(),
+               programs.size() * sizeof(ImageProgram));
+    }
+
+    // A file mapped by load() must not be truncated, the mapping would fault.
+    // The new file is written aside and renamed over the old one, the mappings
+    // keep the old file until they are closed
+    string temporary = a_fileName + ".";
+#if PSSMATHPARSER_IMAGE_MMAP == 1
+    temporary += to_string(getpid()) + ".";
+#endif
+    temporary += to_string(g_temporaryCounter.fetch_add(1)) + ".tmp";
+    ofstream file(temporary, ios::binary | ios::trunc);
+    file.write(bytes.data(), streamsize(bytes.size()));
+    file.close();
+    if (file.fail() || rename(temporary.c_str(), a_fileName.c_str()) != 0) {
+        remove(temporary.c_str());
+        m_errorString = "The file \'" + a_fileName + "\' can't be written";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Maps the file written by save()
+ * @details The file is mapped read only and shared by the processes that map
+ * it; the programs are checked once but nothing is parsed or copied. The
+ * previous file is closed first.
+ * @param a_fileName Path of the file
+ * @return **true** The programs can be calculated
+ * @return **false** The file can't be read, is of another version or byte
+ * order or is broken, see errorString()
+ */
+bool ProgramImage::load(const string &a_fileName)
+{
+    close();
+    m_errorString.clear();
+#if PSSMATHPARSER_IMAGE_MMAP == 1
+    int fd = open(a_fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat status;
+    if (fd < 0 || fstat(fd, &status) != 0) {
+        if (fd >= 0)
+            ::close(fd);
+        m_errorString = "The file \'" + a_fileName + "\' can't be read";
+        return false;
+    }
+    m_size = size_t(status.st_size);
+    if (m_size >= sizeof(ImageHeader)) {
+        void *memory = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (memory != MAP_FAILED) {
+            m_data = static_cast<const char *>(memory);
+            m_mapped = true;
+        }
+    }
+    ::close(fd);
+#else
+    ifstream file(a_fileName, ios::binary | ios::ate);
+    if (file.good() == false) {
+        m_errorString = "The file \'" + a_fileName + "\' can't be read";
+        return false;
+    }
+    m_size = size_t(file.tellg());
+    if (m_size >= sizeof(ImageHeader)) {
+        uint64_t *words = new uint64_t[(m_size + 7) / 8];
+        file.seekg(0);
+        file.read(reinterpret_cast<char *>(words), streamsize(m_size));
+        m_data = reinterpret_cast<const char *>(words);
+    }
+#endif
+    if (m_data == nullptr) {
+        m_size = 0;
+        m_errorString = "The file \'" + a_fileName
+                + "\' isn't a program image";
+        return false;
+    }
+    if (check() == false) {
+        string errorString = m_errorString;
+        close();
+        m_errorString = errorString;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Unmaps the file, the image has no programs
+ */
+void ProgramImage::close()
+{
+    if (m_data != nullptr) {
+#if PSSMATHPARSER_IMAGE_MMAP == 1
+        if (m_mapped)
+            munmap(const_cast<char *>(m_data), m_size);
+#else
+        delete[] reinterpret_cast<const uint64_t *>(m_data);
+#endif
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_header = nullptr;
+    m_programs = nullptr;
+    m_ddFunctions.clear();
+    m_dddFunctions.clear();
+}
+
+/**
+ * @brief Number of the programs of the loaded file
+ */
+size_t ProgramImage::size() const
+{
+    return m_header == nullptr ? 0 : m_header->programSize;
+}
+
+/**
+ * @brief Index of the first program of the name
+ * @return **size_t** The index, size() if there is no such program
+ */
+size_t ProgramImage::find(const string &a_name) const
+{
+    for (size_t p = 0; p < size(); p++) {
+        if (strcmp(m_data + m_programs[p].nameOffset, a_name.c_str()) == 0)
+            return p;
+    }
+    return size();
+}
+
+/**
+ * @brief Name of the program, in the mapped file
+ */
+const char *ProgramImage::name(const size_t a_index) const
+{
+    return a_index < size() ? m_data + m_programs[a_index].nameOffset : "";
+}
+
+/**
+ * @brief Number of the variables of the program
+ */
+uint32_t ProgramImage::variableSize(const size_t a_index) const
+{
+    return a_index < size() ? m_programs[a_index].variableSize : 0;
+}
+
+/**
+ * @brief Name of a variable of the program, in the mapped file
+ */
+const char *ProgramImage::variableName(const size_t a_index,
+                                       const uint32_t a_variable) const
+{
+    if (a_index >= size() || a_variable >= m_programs[a_index].variableSize)
+        return "";
+    const uint64_t *offsets = reinterpret_cast<const uint64_t *>(
+                m_data + m_programs[a_index].variableNameOffset);
+    return m_data + offsets[a_variable];
+}
+
+/**
+ * @brief Number of the slots that calculate() needs for the program
+ */
+uint32_t ProgramImage::slotSize(const size_t a_index) const
+{
+    return a_index < size() ? m_programs[a_index].valueSize : 0;
+}
+
+/**
+ * @brief Number of the slots that calculate() needs for any program
+ */
+uint32_t ProgramImage::maxSlotSize() const
+{
+    return m_header == nullptr ? 0 : m_header->maxSlotSize;
+}
+
+/**
+ * @brief Optimization level that the program was saved with
+ */
+EvaluationBackend ProgramImage::level(const size_t a_index) const
+{
+    return a_index < size() ? EvaluationBackend(m_programs[a_index].level)
+                            : EvaluationBackend::Interpreter;
+}
+
+/**
+ * @brief Calculates the program from the mapped file
+ * @details Nothing is allocated: the initial slots are copied to a_slots and
+ * the mapped instructions are run in them. Any number of threads can
+ * calculate the programs at once, each with its own slots.
+ * @param a_index Index of the program
+ * @param a_variables Array of variableSize() values, ordered as the names of
+ * variableName()
+ * @param a_slots Array of at least slotSize() values, overwritten
+ * @return **double** The result, NaN if there is no such program
+ */
+double ProgramImage::calculate(const size_t a_index,
+                               const double *a_variables,
+                               double *a_slots) const
+{
+    if (a_index >= size())
+        return NAN;
+    const ImageProgram &program = m_programs[a_index];
+    memcpy(a_slots, m_data + program.valueOffset,
+           program.valueSize * sizeof(double));
+    if (program.variableSize != 0)
+        memcpy(a_slots, a_variables, program.variableSize * sizeof(double));
+    return run(reinterpret_cast<const ImageInstruction *>(
+                   m_data + program.instructionOffset),
+               program.instructionSize, a_slots, program.resultSlot,
+               m_ddFunctions.data(), m_dddFunctions.data());
+}
+
+/**
+ * @brief Makes a Program of the mapped one
+ * @details The Program is allocated and independent of the file, it can be
+ * used by an EvaluationContext or compiled by the native backends.
+ * @param a_index Index of the program
+ * @return **shared_ptr<const Program>** The program, nullptr if there is no
+ * such program
+ */
+shared_ptr<const Program> ProgramImage::program(const size_t a_index) const
+{
+    if (a_index >= size())
+        return nullptr;
+    const ImageProgram &program = m_programs[a_index];
+    const ImageInstruction *in = reinterpret_cast<const ImageInstruction *>(
+                m_data + program.instructionOffset);
+    const double *values = reinterpret_cast<const double *>(
+                m_data + program.valueOffset);
+    vector<Instruction> instructions(program.instructionSize);
+    for (size_t i = 0; i < instructions.size(); i++) {
+        Instruction &ins = instructions[i];
+        ins.code = OpCode(in[i].code);
+        ins.arg1 = in[i].arg1;
+        ins.arg2 = in[i].arg2;
+        ins.result = in[i].result;
+        ins.ddFunction = nullptr;
+        ins.dddFunction = nullptr;
+        if (ins.code == OpCode::CallOneArg)
+            ins.ddFunction = m_ddFunctions[in[i].function];
+        else if (ins.code == OpCode::CallTwoArg)
+            ins.dddFunction = m_dddFunctions[in[i].function];
+    }
+    return make_shared<const Program>(
+                InstructionPool::instance().intern(instructions),
+                vector<double>(values, values + program.valueSize),
+                program.variableSize, program.resultSlot);
+}
+
+/**
+ * @brief Description of the error of the last save() or load()
+ */
+const string ProgramImage::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * @brief Checks the header, the offsets and the instructions of the file
+ * @details Every offset and slot is checked once here, so calculate() can
+ * trust the file. The functions are found in the operatorMap.
+ * @return **bool** false if the file can't be used, see errorString()
+ */
+bool ProgramImage::check()
+{
+    const ImageHeader *header = reinterpret_cast<const ImageHeader *>(m_data);
+    if (memcmp(header->magic, Magic, sizeof(Magic)) != 0) {
+        m_errorString = "The file isn't a program image";
+        return false;
+    }
+    if (header->byteOrder != ByteOrder) {
+        m_errorString = header->byteOrder == OtherByteOrder
+                ? "The file has the other byte order"
+                : "The file has an unknown byte order";
+        return false;
+    }
+    if (header->version != Version) {
+        m_errorString = "The file has the version "
+                + to_string(header->version) + ", not "
+                + to_string(Version);
+        return false;
+    }
+    if (header->fileSize != m_size) {
+        m_errorString = "The file has " + to_string(m_size) + " bytes, not "
+                + to_string(header->fileSize);
+        return false;
+    }
+
+    // An array of a_count elements is aligned and inside the file
+    auto fits = [this](const uint64_t a_offset, const uint64_t a_count,
+                       const size_t a_elementSize) {
+        return a_offset % Alignment == 0 && a_offset <= m_size
+                && a_count <= (m_size - a_offset) / a_elementSize;
+    };
+    // A string ends inside the file
+    auto isString = [this](const uint64_t a_offset) {
+        return a_offset < m_size
+                && memchr(m_data + a_offset, '\0', m_size - a_offset)
+                != nullptr;
+    };
+    if (fits(header->functionOffset, header->functionSize,
+             sizeof(ImageFunction)) == false
+            || fits(header->programOffset, header->programSize,
+                    sizeof(ImageProgram)) == false) {
+        m_errorString = "The tables of the file are broken";
+        return false;
+    }
+
+    const ImageFunction *functions = reinterpret_cast<const ImageFunction *>(
+                m_data + header->functionOffset);
+    m_ddFunctions.assign(header->functionSize, nullptr);
+    m_dddFunctions.assign(header->functionSize, nullptr);
+    for (uint32_t f = 0; f < header->functionSize; f++) {
+        auto iop = MathExpression::operatorMap.end();
+        if (isString(functions[f].nameOffset)) {
+            iop = MathExpression::operatorMap.find(
+                        m_data + functions[f].nameOffset);
+        }
+        if (iop != MathExpression::operatorMap.end()) {
+            m_ddFunctions[f] = iop->second.ddFunction();
+            m_dddFunctions[f] = iop->second.dddFunction();
+        }
+        if ((functions[f].argumentSize == 1 && m_ddFunctions[f] == nullptr)
+                || (functions[f].argumentSize == 2
+                    && m_dddFunctions[f] == nullptr)
+                || functions[f].argumentSize == 0
+                || functions[f].argumentSize > 2) {
+            m_errorString = "The function " + to_string(f)
+                    + " of the file isn't an operator";
+            return false;
+        }
+    }
+
+    const ImageProgram *programs = reinterpret_cast<const ImageProgram *>(
+                m_data + header->programOffset);
+    for (uint32_t p = 0; p < header->programSize; p++) {
+        const ImageProgram &program = programs[p];
+        bool valid = isString(program.nameOffset)
+                && fits(program.instructionOffset, program.instructionSize,
+                        sizeof(ImageInstruction))
+                && fits(program.valueOffset, program.valueSize,
+                        sizeof(double))
+                && fits(program.variableNameOffset, program.variableSize,
+                        sizeof(uint64_t))
+                && program.variableSize <= program.valueSize
+                && program.valueSize <= header->maxSlotSize
+                && (program.resultSlot < program.valueSize
+                    || program.resultSlot == UINT32_MAX)
+                && program.level <= uint32_t(EvaluationBackend::Incremental);
+        const uint64_t *names = reinterpret_cast<const uint64_t *>(
+                    m_data + program.variableNameOffset);
+        for (uint32_t v = 0; valid && v < program.variableSize; v++)
+            valid = isString(names[v]);
+        const ImageInstruction *in =
+                reinterpret_cast<const ImageInstruction *>(
+                    m_data + program.instructionOffset);
+        for (uint32_t i = 0; valid && i < program.instructionSize; i++) {
+            const uint32_t code = in[i].code;
+            const bool oneArg = code == uint32_t(OpCode::CallOneArg);
+            const bool call = oneArg || code == uint32_t(OpCode::CallTwoArg);
+            valid = code <= uint32_t(OpCode::CallTwoArg)
+                    && in[i].arg1 < program.valueSize
+                    && (oneArg || in[i].arg2 < program.valueSize)
+                    && in[i].result < program.valueSize
+                    && in[i].result >= program.variableSize;
+            if (valid && call) {
+                valid = in[i].function < header->functionSize
+                        && functions[in[i].function].argumentSize
+                        == (oneArg ? 1u : 2u);
+            }
+        }
+        if (valid == false) {
+            m_errorString = "The program " + to_string(p)
+                    + " of the file is broken";
+            return false;
+        }
+    }
+    m_header = header;
+    m_programs = programs;
+    return true;
+}
@@ -0,0 +1,111 @@
+/**
+ *  @file pssmathimage.h
+ *  @brief Headers for the binary file of compiled programs
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHIMAGE_H
+#define PSSMATHIMAGE_H
+
+#include "pssmathparser_global.h"
+#include "pssmathparser.h"
+#include <string>
+
+namespace PssMathParser {
+
+struct ImageHeader;
+struct ImageProgram;
+struct ImageInstruction;
+
+/**
+ * @brief Binary file of many compiled programs, loaded without parsing
+ * @details save() writes the instructions, the initial slots, the names of
+ * the variables and the optimization level of every program. The file has
+ * offsets instead of pointers and the functions are written by their names
+ * in the operatorMap, so it can be mapped at any address of any process.
+ *
+ * load() maps the file (reads it once where mmap isn't available), checks
+ * its version, byte order and offsets, and finds the functions once for the
+ * whole file. calculate() then runs a program from the mapped instructions
+ * in the slots given by the caller, without any allocation:
+ *
+ * ```c++
+ * ProgramImage image;
+ * image.save("models.pssm", MathParser::compileAll(formulas), names);
+ * ...
+ * ProgramImage loaded;
+ * loaded.load("models.pssm");
+ * vector<double> slots(loaded.maxSlotSize());
+ * double result = loaded.calculate(loaded.find("diode"), variables,
+ *                                  slots.data());
+ * ```
+ *
+ * The file has the byte order of the machine that wrote it; a file of another
+ * version or byte order is rejected by load().
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC ProgramImage {
+public:
+    /** @brief Version of the file format written by save() */
+    static const uint32_t Version = 1;
+
+    ProgramImage();
+    ~ProgramImage();
+
+    bool save(const string &a_fileName,
+              const vector<CompiledExpression> &a_programs,
+              const vector<string> &a_names = vector<string>(),
+              const EvaluationBackend a_level = EvaluationBackend::Interpreter);
+    bool load(const string &a_fileName);
+    void close();
+
+    size_t size() const;
+    size_t find(const string &a_name) const;
+    const char *name(const size_t a_index) const;
+    uint32_t variableSize(const size_t a_index) const;
+    const char *variableName(const size_t a_index,
+                             const uint32_t a_variable) const;
+    uint32_t slotSize(const size_t a_index) const;
+    uint32_t maxSlotSize() const;
+    EvaluationBackend level(const size_t a_index) const;
+
+    double calculate(const size_t a_index,
+                     const double *a_variables,
+                     double *a_slots) const;
+    shared_ptr<const Program> program(const size_t a_index) const;
+    const string errorString() const;
+
+private:
+    ProgramImage(const ProgramImage &) = delete;
+    ProgramImage &operator=(const ProgramImage &) = delete;
+
+    bool check();
+
+    const char *m_data; /**< The mapped file */
+    size_t m_size; /**< Bytes of the file */
+    bool m_mapped; /**< The file is mapped, not read */
+    const ImageHeader *m_header; /**< Header of the file */
+    const ImageProgram *m_programs; /**< Table of the programs */
+    vector<DDFunction> m_ddFunctions; /**< Functions of one argument */
+    vector<DDDFunction> m_dddFunctions; /**< Functions of two arguments */
+    string m_errorString; /**< Error of save() or load() */
+};
+
+}
+
+#endif // PSSMATHIMAGE_H
@@ -0,0 +1,127 @@
+/**
+ *  @file pssmathincremental.cpp
+ *  @brief Incremental calculation of one compiled program
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathincremental.h"
+#include <algorithm>
+
+using namespace PssMathParser;
+
+/**
+ * @brief Constructor, finds the instructions downstream of every variable
+ * @param a_instructions The compiled program, not nullptr
+ * @param a_variableSize Number of variables, the first slots
+ * @param a_resultSlot Slot of the result, UINT32_MAX if the result is zero
+ */
+IncrementalSchedule::IncrementalSchedule(
+        const InstructionStream &a_instructions,
+        const uint32_t a_variableSize,
+        const uint32_t a_resultSlot):
+    m_instructions(a_instructions),
+    m_dependents(a_variableSize),
+    m_resultSlot(a_resultSlot)
+{
+    const vector<Instruction> &instructions = *m_instructions;
+    uint32_t slotSize = a_variableSize;
+    for (const Instruction &ins : instructions) {
+        slotSize = max(slotSize, max(ins.arg1, max(ins.arg2, ins.result)) + 1);
+    }
+
+    // One pass over the program for every variable
+    vector<uint8_t> dirty(slotSize);
+    for (uint32_t v = 0; v < a_variableSize; v++) {
+        fill(dirty.begin(), dirty.end(), 0);
+        dirty[v] = 1;
+        for (size_t i = 0; i < instructions.size(); i++) {
+            const Instruction &ins = instructions[i];
+            if (dirty[ins.arg1] || (ins.code != OpCode::CallOneArg
+                                    && dirty[ins.arg2])) {
+                dirty[ins.result] = 1;
+                m_dependents[v].push_back(uint32_t(i));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Return the number of variables
+ */
+uint32_t IncrementalSchedule::variableSize() const
+{
+    return uint32_t(m_dependents.size());
+}
+
+/**
+ * @brief Number of instructions calculated when only the variable changes
+ * @param a_variable Index of the variable
+ * @return **size_t** The instructions downstream of the variable
+ */
+size_t IncrementalSchedule::dependentSize(const uint32_t a_variable) const
+{
+    if (a_variable >= m_dependents.size())
+        return 0;
+    return m_dependents[a_variable].size();
+}
+
+/**
+ * @brief Calculates the whole program
+ * @details Used for the first calculation and after the constants change.
+ * @param a_values The slots of the program
+ * @return **double** Value of the result slot
+ */
+double IncrementalSchedule::run(double *a_values) const
+{
+    return Program::run(m_instructions->data(), m_instructions->size(),
+                        a_values, m_resultSlot);
+}
+
+/**
+ * @brief Calculates the instructions downstream of the changed variables
+ * @details The other slots must hold the values of the previous calculation.
+ * @param a_values The slots of the program
+ * @param a_changed Indices of the variables changed since the previous
+ * calculation
+ * @return **double** Value of the result slot
+ */
+double IncrementalSchedule::run(double *a_values,
+                                const vector<uint32_t> &a_changed) const
+{
+    const Instruction *instructions = m_instructions->data();
+    if (a_changed.size() == 1) {
+        for (uint32_t i : m_dependents[a_changed[0]])
+            Program::run(instructions + i, 1, a_values, UINT32_MAX);
+    }
+    else if (a_changed.size() > 1) {
+        // The union of the dependents, in the order of the program
+        vector<uint8_t> dirty(m_instructions->size());
+        for (uint32_t v : a_changed) {
+            for (uint32_t i : m_dependents[v])
+                dirty[i] = 1;
+        }
+        for (size_t i = 0; i < dirty.size(); i++) {
+            if (dirty[i])
+                Program::run(instructions + i, 1, a_values, UINT32_MAX);
+        }
+    }
+    if (m_resultSlot == UINT32_MAX)
+        return 0.0;
+    return a_values[m_resultSlot];
+}
@@ -0,0 +1,63 @@
+/**
+ *  @file pssmathincremental.h
+ *  @brief Headers for the incremental calculation of one compiled program
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHINCREMENTAL_H
+#define PSSMATHINCREMENTAL_H
+
+#include "pssmathparser_global.h"
+#include "pssmathcore.h"
+
+namespace PssMathParser {
+
+/**
+ * @brief The instructions that depend on every variable of a program
+ * @details Made when the program is compiled. Every slot is written by one
+ * instruction only, so the instructions downstream of a variable are the ones
+ * that read the variable or a slot written downstream of it. run() calculates
+ * only the instructions downstream of the changed variables, in the order of
+ * the program; the other slots keep the values of the previous calculation.
+ * The result is the same as from the interpreter, bit by bit.
+ *
+ * The schedule doesn't change after construction, the changed variables are
+ * tracked by the owner of the slots (MathExpression with
+ * EvaluationBackend::Incremental).
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC IncrementalSchedule {
+public:
+    IncrementalSchedule(const InstructionStream &a_instructions,
+                        const uint32_t a_variableSize,
+                        const uint32_t a_resultSlot);
+
+    uint32_t variableSize() const;
+    size_t dependentSize(const uint32_t a_variable) const;
+    double run(double *a_values) const;
+    double run(double *a_values, const vector<uint32_t> &a_changed) const;
+
+private:
+    InstructionStream m_instructions; /**< The compiled program */
+    vector<vector<uint32_t>> m_dependents; /**< Instructions of every variable */
+    uint32_t m_resultSlot; /**< Slot of the result, UINT32_MAX for zero */
+};
+
+}
+
+#endif // PSSMATHINCREMENTAL_H
@@ -0,0 +1,495 @@
+/**
+ *  @file pssmathjit.cpp
+ *  @brief Source code for the native code generator of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathjit.h"
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__linux__)
+#define PSSMATHPARSER_JIT_X86_64 1
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#define PSSMATHPARSER_JIT_X86_64 0
+#endif
+
+using namespace PssMathParser;
+
+#if PSSMATHPARSER_JIT_X86_64 == 1
+namespace {
+
+const uint32_t numRegisters = 16; /**< Number of XMM registers */
+const uint8_t noRegister = 0xFF; /**< Slot is not in a register */
+
+/**
+ * @brief Writes the x86-64 instructions used by the JitFunction
+ * @details The pointer to the slots is kept in rbx for the whole function, so
+ * every slot is addressed as [rbx + 8*slot].
+ */
+class Assembler {
+public:
+    vector<uint8_t> code; /**< The machine code */
+
+    /** @brief Appends one byte */
+    void byte(uint8_t a_byte)
+    {
+        code.push_back(a_byte);
+    }
+
+    /** @brief Appends 32 bit little endian value */
+    void dword(uint32_t a_value)
+    {
+        for (int i = 0; i < 4; i++)
+            byte(uint8_t(a_value >> (8*i)));
+    }
+
+    /** @brief Appends 64 bit little endian value */
+    void qword(uint64_t a_value)
+    {
+        for (int i = 0; i < 8; i++)
+            byte(uint8_t(a_value >> (8*i)));
+    }
+
+    /** @brief REX prefix for the registers, only if needed */
+    void rex(uint8_t a_reg, uint8_t a_rm)
+    {
+        uint8_t prefix = 0x40 | ((a_reg >> 3) << 2) | (a_rm >> 3);
+        if (prefix != 0x40)
+            byte(prefix);
+    }
+
+    /** @brief SSE instruction xmm, [rbx + 8*slot] */
+    void sseSlot(uint8_t a_prefix, uint8_t a_opcode,
+                 uint8_t a_xmm, uint32_t a_slot)
+    {
+        byte(a_prefix);
+        rex(a_xmm, 0);
+        byte(0x0F);
+        byte(a_opcode);
+        byte(0x80 | ((a_xmm & 7) << 3) | 3); // [rbx + disp32]
+        dword(8*a_slot);
+    }
+
+    /** @brief SSE instruction xmm, xmm */
+    void sseReg(uint8_t a_prefix, uint8_t a_opcode,
+                uint8_t a_dst, uint8_t a_src)
+    {
+        byte(a_prefix);
+        rex(a_dst, a_src);
+        byte(0x0F);
+        byte(a_opcode);
+        byte(0xC0 | ((a_dst & 7) << 3) | (a_src & 7));
+    }
+
+    /** @brief movsd xmm, [rbx + 8*slot] */
+    void load(uint8_t a_xmm, uint32_t a_slot)
+    {
+        sseSlot(0xF2, 0x10, a_xmm, a_slot);
+    }
+
+    /** @brief movsd [rbx + 8*slot], xmm */
+    void store(uint32_t a_slot, uint8_t a_xmm)
+    {
+        sseSlot(0xF2, 0x11, a_xmm, a_slot);
+    }
+
+    /** @brief movapd xmm, xmm */
+    void move(uint8_t a_dst, uint8_t a_src)
+    {
+        if (a_dst != a_src)
+            sseReg(0x66, 0x28, a_dst, a_src);
+    }
+
+    /** @brief addsd, subsd, mulsd or divsd xmm, xmm */
+    void arithmetic(OpCode a_code, uint8_t a_dst, uint8_t a_src)
+    {
+        uint8_t opcode = 0x58;
+        switch (a_code) {
+        case OpCode::Add: opcode = 0x58; break;
+        case OpCode::Subtract: opcode = 0x5C; break;
+        case OpCode::Multiply: opcode = 0x59; break;
+        case OpCode::Divide: opcode = 0x5E; break;
+        default: break;
+        }
+        sseReg(0xF2, opcode, a_dst, a_src);
+    }
+
+    /** @brief xorpd xmm0, xmm0 */
+    void zero()
+    {
+        byte(0x66); byte(0x0F); byte(0x57); byte(0xC0);
+    }
+
+    /** @brief mov rax, imm64; call rax */
+    void call(const void *a_function)
+    {
+        byte(0x48); byte(0xB8);
+        qword(uint64_t(reinterpret_cast<uintptr_t>(a_function)));
+        byte(0xFF); byte(0xD0);
+    }
+
+    /** @brief Pads the code with int3 to the given alignment */
+    void align(size_t a_alignment)
+    {
+        while (code.size() % a_alignment != 0)
+            byte(0xCC);
+    }
+};
+
+/**
+ * @brief Tracks which slot is held in which XMM register
+ * @details All results are also stored to their slots, so a register can be
+ * reused at any time without spilling. Calls clobber all XMM registers, so the
+ * cache is reset after every call.
+ */
+class RegisterCache {
+public:
+    RegisterCache(size_t a_slotSize) :
+        m_slotRegister(a_slotSize, noRegister),
+        m_next(0)
+    {
+        for (uint32_t r = 0; r < numRegisters; r++)
+            m_registerSlot[r] = UINT32_MAX;
+    }
+
+    /** @brief Forget all registers */
+    void reset()
+    {
+        for (uint32_t r = 0; r < numRegisters; r++) {
+            if (m_registerSlot[r] != UINT32_MAX)
+                m_slotRegister[m_registerSlot[r]] = noRegister;
+            m_registerSlot[r] = UINT32_MAX;
+        }
+    }
+
+    /** @brief Register holding the slot or noRegister */
+    uint8_t find(uint32_t a_slot) const
+    {
+        return m_slotRegister[a_slot];
+    }
+
+    /** @brief Picks a free register, or the oldest one not pinned */
+    uint8_t allocate(uint8_t a_pinned1, uint8_t a_pinned2)
+    {
+        for (uint8_t r = 0; r < numRegisters; r++) {
+            if (m_registerSlot[r] == UINT32_MAX)
+                return r;
+        }
+        uint8_t r;
+        do {
+            r = m_next;
+            m_next = uint8_t((m_next + 1) % numRegisters);
+        } while (r == a_pinned1 || r == a_pinned2);
+        return r;
+    }
+
+    /** @brief Marks that the register now holds the slot */
+    void assign(uint8_t a_register, uint32_t a_slot)
+    {
+        if (m_registerSlot[a_register] != UINT32_MAX)
+            m_slotRegister[m_registerSlot[a_register]] = noRegister;
+        m_registerSlot[a_register] = a_slot;
+        m_slotRegister[a_slot] = a_register;
+    }
+
+    /** @brief Returns the register with the slot, loads it if needed */
+    uint8_t load(Assembler &a_asm, uint32_t a_slot, uint8_t a_pinned)
+    {
+        uint8_t r = find(a_slot);
+        if (r != noRegister)
+            return r;
+        r = allocate(a_pinned, a_pinned);
+        a_asm.load(r, a_slot);
+        assign(r, a_slot);
+        return r;
+    }
+
+private:
+    vector<uint8_t> m_slotRegister; /**< Register of each slot */
+    uint32_t m_registerSlot[numRegisters]; /**< Slot of each register */
+    uint8_t m_next; /**< Next register to be reused */
+};
+
+/**
+ * @brief Writes the code of the program, result ends in xmm0
+ */
+void emitProgram(Assembler &a_asm,
+                 const vector<Instruction> &a_instructions,
+                 const vector<size_t> &a_lastUse,
+                 uint32_t a_resultSlot,
+                 size_t a_slotSize)
+{
+    RegisterCache cache(a_slotSize);
+    for (size_t i = 0; i < a_instructions.size(); i++) {
+        const Instruction &ins = a_instructions[i];
+        switch (ins.code) {
+        case OpCode::Add:
+        case OpCode::Subtract:
+        case OpCode::Multiply:
+        case OpCode::Divide: {
+            uint8_t r1 = cache.load(a_asm, ins.arg1, noRegister);
+            uint8_t r2 = cache.load(a_asm, ins.arg2, r1);
+            uint8_t rd;
+            // Reuse the register of the first argument if it is not read later
+            if (a_lastUse[ins.arg1] == i) {
+                rd = r1;
+            }
+            else {
+                rd = cache.allocate(r1, r2);
+                a_asm.move(rd, r1);
+            }
+            a_asm.arithmetic(ins.code, rd, r2);
+            a_asm.store(ins.result, rd);
+            cache.assign(rd, ins.result);
+            break;
+        }
+        case OpCode::CallOneArg:
+            a_asm.load(0, ins.arg1);
+            a_asm.call(reinterpret_cast<const void *>(ins.ddFunction));
+            cache.reset();
+            a_asm.store(ins.result, 0);
+            cache.assign(0, ins.result);
+            break;
+        case OpCode::CallTwoArg:
+            a_asm.load(0, ins.arg1);
+            a_asm.load(1, ins.arg2);
+            a_asm.call(reinterpret_cast<const void *>(ins.dddFunction));
+            cache.reset();
+            a_asm.store(ins.result, 0);
+            cache.assign(0, ins.result);
+            break;
+        }
+    }
+    if (a_resultSlot == UINT32_MAX) {
+        a_asm.zero();
+    }
+    else {
+        uint8_t r = cache.find(a_resultSlot);
+        if (r == noRegister)
+            a_asm.load(0, a_resultSlot);
+        else
+            a_asm.move(0, r);
+    }
+}
+
+}
+#endif
+
+/**
+ * @brief Constructor, the object holds no code until compile()
+ */
+JitFunction::JitFunction():
+    m_code(nullptr),
+    m_mappedSize(0),
+    m_codeSize(0)
+{
+}
+
+/**
+ * @brief Destructor, unmaps the code
+ */
+JitFunction::~JitFunction()
+{
+    release();
+}
+
+/**
+ * @brief Tells if native code can be generated on this system
+ * @return **true** The architecture is x86-64 (Linux)
+ * @return **false** Only the interpreter can be used
+ */
+bool JitFunction::isSupported()
+{
+    return PSSMATHPARSER_JIT_X86_64 == 1;
+}
+
+/**
+ * @brief Getter of the backend
+ * @return EvaluationBackend Always EvaluationBackend::Jit
+ */
+EvaluationBackend JitFunction::backend() const
+{
+    return EvaluationBackend::Jit;
+}
+
+/**
+ * @brief Translates the program to machine code
+ * @details The scalar entry is `double f(double *values)`. The batch entry is
+ * `void f(double *values, const double *const *variables, double *results,
+ * size_t size)`, where the variables are copied to the first slots before
+ * every row. Slots are the m_values of the MathExpression.
+ * @param a_instructions The compiled program
+ * @param a_variableSize Number of variables (the first slots)
+ * @param a_resultSlot Slot of the result, UINT32_MAX if the result is zero
+ * @return **true** Code is ready
+ * @return **false** Not supported or the system refused executable memory
+ */
+bool JitFunction::compile(const vector<Instruction> &a_instructions,
+                          const uint32_t a_variableSize,
+                          const uint32_t a_resultSlot)
+{
+    release();
+#if PSSMATHPARSER_JIT_X86_64 == 1
+    // Number of slots and the last instruction that reads each slot
+    size_t slotSize = a_variableSize;
+    if (a_resultSlot != UINT32_MAX)
+        slotSize = max(slotSize, size_t(a_resultSlot) + 1);
+    for (const Instruction &ins : a_instructions) {
+        slotSize = max(slotSize, size_t(ins.arg1) + 1);
+        slotSize = max(slotSize, size_t(ins.arg2) + 1);
+        slotSize = max(slotSize, size_t(ins.result) + 1);
+    }
+    vector<size_t> lastUse(slotSize, 0);
+    for (size_t i = 0; i < a_instructions.size(); i++) {
+        lastUse[a_instructions[i].arg1] = i;
+        if (a_instructions[i].code != OpCode::CallOneArg)
+            lastUse[a_instructions[i].arg2] = i;
+    }
+    if (a_resultSlot != UINT32_MAX)
+        lastUse[a_resultSlot] = a_instructions.size();
+
+    Assembler as;
+
+    // double scalar(double *values)
+    as.byte(0x53);                                  // push rbx
+    as.byte(0x48); as.byte(0x89); as.byte(0xFB);    // mov rbx, rdi
+    emitProgram(as, a_instructions, lastUse, a_resultSlot, slotSize);
+    as.byte(0x5B);                                  // pop rbx
+    as.byte(0xC3);                                  // ret
+
+    // void batch(double *values, const double *const *variables,
+    //            double *results, size_t size)
+    as.align(16);
+    size_t batchOffset = as.code.size();
+    as.byte(0x53);                                  // push rbx
+    as.byte(0x41); as.byte(0x54);                   // push r12
+    as.byte(0x41); as.byte(0x55);                   // push r13
+    as.byte(0x41); as.byte(0x56);                   // push r14
+    as.byte(0x41); as.byte(0x57);                   // push r15
+    as.byte(0x48); as.byte(0x89); as.byte(0xFB);    // mov rbx, rdi
+    as.byte(0x49); as.byte(0x89); as.byte(0xF4);    // mov r12, rsi
+    as.byte(0x49); as.byte(0x89); as.byte(0xD5);    // mov r13, rdx
+    as.byte(0x49); as.byte(0x89); as.byte(0xCE);    // mov r14, rcx
+    as.byte(0x45); as.byte(0x31); as.byte(0xFF);    // xor r15d, r15d
+    as.byte(0x4D); as.byte(0x85); as.byte(0xF6);    // test r14, r14
+    as.byte(0x0F); as.byte(0x84);                   // jz done
+    size_t jumpToDone = as.code.size();
+    as.dword(0);
+    size_t loop = as.code.size();
+    for (uint32_t v = 0; v < a_variableSize; v++) {
+        // mov rax, [r12 + 8*v]
+        as.byte(0x49); as.byte(0x8B); as.byte(0x84); as.byte(0x24);
+        as.dword(8*v);
+        // movsd xmm0, [rax + 8*r15]
+        as.byte(0xF2); as.byte(0x42); as.byte(0x0F); as.byte(0x10);
+        as.byte(0x04); as.byte(0xF8);
+        as.store(v, 0);
+    }
+    emitProgram(as, a_instructions, lastUse, a_resultSlot, slotSize);
+    // movsd [r13 + 8*r15], xmm0
+    as.byte(0xF2); as.byte(0x43); as.byte(0x0F); as.byte(0x11);
+    as.byte(0x44); as.byte(0xFD); as.byte(0x00);
+    as.byte(0x49); as.byte(0xFF); as.byte(0xC7);    // inc r15
+    as.byte(0x4D); as.byte(0x39); as.byte(0xF7);    // cmp r15, r14
+    as.byte(0x0F); as.byte(0x82);                   // jb loop
+    as.dword(uint32_t(int32_t(loop - (as.code.size() + 4))));
+    size_t done = as.code.size();
+    uint32_t rel = uint32_t(int32_t(done - (jumpToDone + 4)));
+    memcpy(&as.code[jumpToDone], &rel, 4);
+    as.byte(0x41); as.byte(0x5F);                   // pop r15
+    as.byte(0x41); as.byte(0x5E);                   // pop r14
+    as.byte(0x41); as.byte(0x5D);                   // pop r13
+    as.byte(0x41); as.byte(0x5C);                   // pop r12
+    as.byte(0x5B);                                  // pop rbx
+    as.byte(0xC3);                                  // ret
+
+    // Map the code: write through one mapping, run through the other
+    size_t pageSize = size_t(sysconf(_SC_PAGESIZE));
+    size_t mappedSize = (as.code.size() + pageSize - 1) / pageSize * pageSize;
+    void *code = MAP_FAILED;
+#ifdef MFD_CLOEXEC
+    int fd = memfd_create("pssmathparser-jit", MFD_CLOEXEC);
+    if (fd >= 0) {
+        if (ftruncate(fd, off_t(mappedSize)) == 0) {
+            void *writable = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE,
+                                  MAP_SHARED, fd, 0);
+            if (writable != MAP_FAILED) {
+                memcpy(writable, as.code.data(), as.code.size());
+                munmap(writable, mappedSize);
+                code = mmap(nullptr, mappedSize, PROT_READ | PROT_EXEC,
+                            MAP_SHARED, fd, 0);
+            }
+        }
+        close(fd);
+    }
+#endif
+    // Without memfd the page is writable first and executable after
+    if (code == MAP_FAILED) {
+        code = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (code == MAP_FAILED)
+            return false;
+        memcpy(code, as.code.data(), as.code.size());
+        if (mprotect(code, mappedSize, PROT_READ | PROT_EXEC) != 0) {
+            munmap(code, mappedSize);
+            return false;
+        }
+    }
+
+    m_code = code;
+    m_mappedSize = mappedSize;
+    m_codeSize = as.code.size();
+    m_scalarEntry = reinterpret_cast<ScalarEntry>(m_code);
+    m_batchEntry = reinterpret_cast<BatchEntry>(
+                static_cast<uint8_t *>(m_code) + batchOffset);
+    return true;
+#else
+    (void)a_instructions;
+    (void)a_variableSize;
+    (void)a_resultSlot;
+    return false;
+#endif
+}
+
+/**
+ * @brief Unmaps the code
+ */
+void JitFunction::release()
+{
+#if PSSMATHPARSER_JIT_X86_64 == 1
+    if (m_code != nullptr)
+        munmap(m_code, m_mappedSize);
+#endif
+    m_code = nullptr;
+    m_mappedSize = 0;
+    m_codeSize = 0;
+    m_scalarEntry = nullptr;
+    m_batchEntry = nullptr;
+}
+
+/**
+ * @brief Getter of the size of the generated machine code
+ * @return **size_t** Size in bytes
+ */
+size_t JitFunction::codeSize() const
+{
+    return m_codeSize;
+}
@@ -0,0 +1,65 @@
+/**
+ *  @file pssmathjit.h
+ *  @brief Headers for the native code generator of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHJIT_H
+#define PSSMATHJIT_H
+
+#include "pssmathnative.h"
+
+namespace PssMathParser {
+
+/**
+ * @brief Native x86-64 code of a compiled program
+ * @details The program (vector of Instructions) is translated directly to
+ * machine code, without external compiler. Arithmetic is done with the SSE2
+ * scalar instructions on values kept in the XMM registers, and the functions
+ * (sin, exp, pow...) are called directly through their pointers. The code has
+ * two entry points: scalar that calculates the program once, and batch that
+ * loops over the rows of the variable columns.
+ *
+ * The code is written through one mapping and run through another one, so no
+ * memory is writable and executable at the same time (W^X). On other
+ * architectures isSupported() returns false and the interpreter is used.
+ */
+class JitFunction : public NativeFunction {
+public:
+    JitFunction();
+    ~JitFunction();
+
+    static bool isSupported();
+
+    EvaluationBackend backend() const;
+    bool compile(const vector<Instruction> &a_instructions,
+                 const uint32_t a_variableSize,
+                 const uint32_t a_resultSlot);
+    void release();
+    size_t codeSize() const;
+
+private:
+    void *m_code; /**< Executable mapping of the code */
+    size_t m_mappedSize; /**< Size of the executable mapping */
+    size_t m_codeSize; /**< Size of the generated code */
+};
+
+}
+
+#endif // PSSMATHJIT_H
@@ -0,0 +1,331 @@
+/**
+ *  @file pssmathjobs.cpp
+ *  @brief Scheduler of evaluation jobs of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathjobs.h"
+#include <algorithm>
+
+using namespace PssMathParser;
+
+/**
+ * @brief Constructor, copies the column pointers
+ * @param a_program The compiled program
+ * @param a_variables Array of variableSize() columns of a_size values
+ * @param a_results Array of a_size values for the results
+ * @param a_size Number of rows
+ * @param a_priority Priority class of the job
+ * @param a_deadline When the results are needed
+ */
+EvaluationJob::EvaluationJob(const shared_ptr<const Program> &a_program,
+                             const double *const *a_variables,
+                             double *a_results,
+                             const size_t a_size,
+                             const JobPriority a_priority,
+                             const Clock::time_point a_deadline):
+    m_program(a_program),
+    m_variables(a_variables, a_variables + a_program->variableSize()),
+    m_results(a_results),
+    m_size(a_size),
+    m_priority(a_priority),
+    m_deadline(a_deadline),
+    m_submitTime(Clock::now()),
+    m_sequence(0),
+    m_nextRow(0),
+    m_rowsDone(0),
+    m_status(JobStatus::Queued)
+{
+}
+
+/**
+ * @brief Getter of the priority class
+ */
+JobPriority EvaluationJob::priority() const
+{
+    return m_priority;
+}
+
+/**
+ * @brief Getter of the deadline
+ */
+EvaluationJob::Clock::time_point EvaluationJob::deadline() const
+{
+    return m_deadline;
+}
+
+/**
+ * @brief Getter of the state of the job
+ */
+JobStatus EvaluationJob::status() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_status;
+}
+
+/**
+ * @brief Tells if the job is done or expired
+ */
+bool EvaluationJob::isFinished() const
+{
+    JobStatus status = this->status();
+    return status == JobStatus::Done || status == JobStatus::Expired;
+}
+
+/**
+ * @brief Waits until the job is done or expired
+ */
+void EvaluationJob::wait() const
+{
+    unique_lock<mutex> lock(m_mutex);
+    m_finished.wait(lock, [this]() {
+        return m_status == JobStatus::Done || m_status == JobStatus::Expired;
+    });
+}
+
+/**
+ * @brief The first job is more urgent than the second
+ */
+bool JobScheduler::Urgency::operator()(
+        const shared_ptr<EvaluationJob> &a_first,
+        const shared_ptr<EvaluationJob> &a_second) const
+{
+    if (a_first->m_deadline != a_second->m_deadline)
+        return a_first->m_deadline < a_second->m_deadline;
+    return a_first->m_sequence < a_second->m_sequence;
+}
+
+/**
+ * @brief Constructor
+ * @param a_pool The workers, nullptr for ThreadPool::instance()
+ */
+JobScheduler::JobScheduler(ThreadPool *a_pool):
+    m_pool(a_pool != nullptr ? *a_pool : ThreadPool::instance()),
+    m_runners(0),
+    m_unfinished(0),
+    m_sequence(0)
+{
+    for (size_t p = 0; p < 3; p++) {
+        m_running[p] = 0;
+        m_done[p] = 0;
+        m_expired[p] = 0;
+        m_late[p] = 0;
+        m_waitSum[p] = 0.0;
+        m_started[p] = 0;
+        m_maxWait[p] = 0.0;
+    }
+}
+
+/**
+ * @brief Destructor, waits for all the jobs
+ */
+JobScheduler::~JobScheduler()
+{
+    waitAll();
+}
+
+/**
+ * @brief Adds a batch calculation to the queue of its priority class
+ * @details Returns at once, the job is calculated by the workers. The columns
+ * and the results must live until the job is finished.
+ *
+ * ```c++
+ * JobScheduler scheduler;
+ * shared_ptr<EvaluationJob> job = scheduler.submit(
+ *         mp->program(), columns, results, size, JobPriority::High,
+ *         JobScheduler::Clock::now() + chrono::milliseconds(5));
+ * job->wait();
+ * ```
+ *
+ * @param a_program The compiled program
+ * @param a_variables Array of variableSize() columns of a_size values
+ * @param a_results Array of a_size values for the results
+ * @param a_size Number of rows
+ * @param a_priority Priority class of the job
+ * @param a_deadline When the results are needed, no deadline by default
+ * @return **shared_ptr<EvaluationJob>** The job for waiting on it
+ */
+shared_ptr<EvaluationJob> JobScheduler::submit(
+        const shared_ptr<const Program> &a_program,
+        const double *const *a_variables,
+        double *a_results,
+        const size_t a_size,
+        const JobPriority a_priority,
+        const Clock::time_point a_deadline)
+{
+    shared_ptr<EvaluationJob> job = make_shared<EvaluationJob>(
+                a_program, a_variables, a_results, a_size, a_priority,
+                a_deadline);
+    bool startRunner = false;
+    {
+        lock_guard<mutex> lock(m_mutex);
+        job->m_sequence = m_sequence++;
+        m_queues[size_t(a_priority)].insert(job);
+        m_unfinished++;
+        if (m_runners < m_pool.size()) {
+            m_runners++;
+            startRunner = true;
+        }
+    }
+    if (startRunner)
+        m_pool.submit(bind(&JobScheduler::run, this));
+    return job;
+}
+
+/**
+ * @brief Copy of the counters
+ * @return **Statistics** Queue depths and waiting times by priority class
+ */
+JobScheduler::Statistics JobScheduler::statistics() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    Statistics statistics;
+    for (size_t p = 0; p < 3; p++) {
+        statistics.queued[p] = 0;
+        for (const shared_ptr<EvaluationJob> &job : m_queues[p]) {
+            if (job->m_nextRow == 0)
+                statistics.queued[p]++;
+        }
+        statistics.running[p] = m_running[p];
+        statistics.done[p] = m_done[p];
+        statistics.expired[p] = m_expired[p];
+        statistics.late[p] = m_late[p];
+        statistics.meanWait[p] =
+                m_started[p] > 0 ? m_waitSum[p] / m_started[p] : 0.0;
+        statistics.maxWait[p] = m_maxWait[p];
+    }
+    return statistics;
+}
+
+/**
+ * @brief Waits until all the submitted jobs are finished
+ */
+void JobScheduler::waitAll()
+{
+    unique_lock<mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() {
+        return m_unfinished == 0 && m_runners == 0;
+    });
+}
+
+/**
+ * @brief Takes the next chunk of the most urgent job
+ * @details Jobs that are past their deadline before their first chunk expire
+ * here. Called with m_mutex locked.
+ * @return **true** a_chunk is set
+ * @return **false** There are no chunks left
+ */
+bool JobScheduler::takeChunk(Chunk &a_chunk)
+{
+    for (size_t p = 0; p < 3; p++) {
+        while (m_queues[p].empty() == false) {
+            shared_ptr<EvaluationJob> job = *m_queues[p].begin();
+            if (job->m_nextRow == 0) {
+                Clock::time_point now = Clock::now();
+                if (now > job->m_deadline) {
+                    m_queues[p].erase(m_queues[p].begin());
+                    m_expired[p]++;
+                    finishJob(*job, JobStatus::Expired);
+                    continue;
+                }
+                double wait = chrono::duration<double>(
+                            now - job->m_submitTime).count();
+                m_waitSum[p] += wait;
+                m_maxWait[p] = max(m_maxWait[p], wait);
+                m_started[p]++;
+                m_running[p]++;
+                lock_guard<mutex> lock(job->m_mutex);
+                job->m_status = JobStatus::Running;
+            }
+            const size_t chunk = ThreadPool::chunkSize(
+                        job->m_program->variableSize());
+            a_chunk.job = job;
+            a_chunk.begin = job->m_nextRow;
+            a_chunk.end = min(job->m_size, job->m_nextRow + chunk);
+            job->m_nextRow = a_chunk.end;
+            if (job->m_nextRow == job->m_size)
+                m_queues[p].erase(m_queues[p].begin());
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Counts the rows of the chunk, the last chunk finishes the job
+ * @details Called with m_mutex locked.
+ */
+void JobScheduler::finishChunk(const Chunk &a_chunk)
+{
+    EvaluationJob &job = *a_chunk.job;
+    job.m_rowsDone += a_chunk.end - a_chunk.begin;
+    if (job.m_rowsDone < job.m_size)
+        return;
+    size_t p = size_t(job.m_priority);
+    m_running[p]--;
+    m_done[p]++;
+    if (Clock::now() > job.m_deadline)
+        m_late[p]++;
+    finishJob(job, JobStatus::Done);
+}
+
+/**
+ * @brief Sets the final state of the job and wakes the waiting threads
+ * @details Called with m_mutex locked.
+ */
+void JobScheduler::finishJob(EvaluationJob &a_job, const JobStatus a_status)
+{
+    {
+        lock_guard<mutex> lock(a_job.m_mutex);
+        a_job.m_status = a_status;
+    }
+    a_job.m_finished.notify_all();
+    m_unfinished--;
+}
+
+/**
+ * @brief Loop of one worker, calculates chunks until there are none
+ */
+void JobScheduler::run()
+{
+    unique_ptr<EvaluationContext> context;
+    vector<const double *> columns;
+    Chunk chunk;
+    unique_lock<mutex> lock(m_mutex);
+    while (true) {
+        if (takeChunk(chunk) == false)
+            break;
+        lock.unlock();
+        EvaluationJob &job = *chunk.job;
+        if (!context || context->program() != job.m_program)
+            context.reset(new EvaluationContext(job.m_program));
+        columns.resize(job.m_variables.size());
+        for (size_t j = 0; j < columns.size(); j++) {
+            columns[j] = job.m_variables[j] + chunk.begin;
+        }
+        context->calculateBatch(columns.data(), job.m_results + chunk.begin,
+                                chunk.end - chunk.begin);
+        lock.lock();
+        finishChunk(chunk);
+        chunk.job.reset();
+    }
+    m_runners--;
+    if (m_unfinished == 0 && m_runners == 0)
+        m_idle.notify_all();
+}
@@ -0,0 +1,181 @@
+/**
+ *  @file pssmathjobs.h
+ *  @brief Headers for the scheduler of evaluation jobs of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHJOBS_H
+#define PSSMATHJOBS_H
+
+#include "pssmaththreadpool.h"
+#include <chrono>
+#include <set>
+
+namespace PssMathParser {
+
+/**
+ * @brief Enum defines the priority classes of the evaluation jobs
+ */
+enum class JobPriority {
+    High,
+    Normal,
+    Low
+};
+
+/**
+ * @brief Enum defines the states of an evaluation job
+ */
+enum class JobStatus {
+    Queued,
+    Running,
+    Done,
+    Expired
+};
+
+class JobScheduler;
+
+/**
+ * @brief One batch calculation submitted to the JobScheduler
+ * @details The job is shared by the scheduler and the caller. The columns and
+ * the results must live until the job is finished.
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC EvaluationJob {
+public:
+    typedef chrono::steady_clock Clock; /**< Clock of the deadlines */
+
+    EvaluationJob(const shared_ptr<const Program> &a_program,
+                  const double *const *a_variables,
+                  double *a_results,
+                  const size_t a_size,
+                  const JobPriority a_priority,
+                  const Clock::time_point a_deadline);
+
+    JobPriority priority() const;
+    Clock::time_point deadline() const;
+    JobStatus status() const;
+    bool isFinished() const;
+    void wait() const;
+
+private:
+    friend class JobScheduler;
+
+    shared_ptr<const Program> m_program; /**< The calculated program */
+    vector<const double *> m_variables; /**< The variable columns */
+    double *m_results; /**< The results */
+    size_t m_size; /**< Number of rows */
+    JobPriority m_priority; /**< Priority class */
+    Clock::time_point m_deadline; /**< When the results are needed */
+    Clock::time_point m_submitTime; /**< When the job was submitted */
+    uint64_t m_sequence; /**< Order of submission */
+    size_t m_nextRow; /**< First row not given to a worker */
+    size_t m_rowsDone; /**< Rows calculated */
+    JobStatus m_status; /**< State of the job */
+    mutable mutex m_mutex; /**< Guards m_status for wait() */
+    mutable condition_variable m_finished; /**< Wakes wait() */
+};
+
+/**
+ * @brief Runs evaluation jobs by priority and deadline on a ThreadPool
+ * @details The jobs are split in chunks of ThreadPool::chunkSize() rows. Every
+ * time a worker finishes a chunk it takes the next chunk of the most urgent
+ * job: the highest priority class first and inside the class the earliest
+ * deadline, then the oldest job. So a high priority job waits at most for
+ * one chunk of the running sweeps. A job that is not started before its
+ * deadline is not calculated and ends as JobStatus::Expired. A started job is
+ * finished even after its deadline, which is counted in the statistics.
+ *
+ * The scheduler uses at most ThreadPool::size() workers of the pool at the
+ * same time and releases them when there are no jobs. The destructor waits
+ * for all the jobs.
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC JobScheduler {
+public:
+    typedef EvaluationJob::Clock Clock; /**< Clock of the deadlines */
+
+    /**
+     * @brief Counters of the scheduler, one entry for every JobPriority
+     */
+    struct Statistics {
+        size_t queued[3]; /**< Jobs waiting for the first chunk */
+        size_t running[3]; /**< Jobs with chunks given to workers */
+        size_t done[3]; /**< Finished jobs */
+        size_t expired[3]; /**< Jobs not started before the deadline */
+        size_t late[3]; /**< Jobs finished after the deadline */
+        double meanWait[3]; /**< Mean seconds from submit to start */
+        double maxWait[3]; /**< Longest seconds from submit to start */
+    };
+
+    explicit JobScheduler(ThreadPool *a_pool = nullptr);
+    ~JobScheduler();
+
+    JobScheduler(const JobScheduler &) = delete;
+    JobScheduler &operator=(const JobScheduler &) = delete;
+
+    shared_ptr<EvaluationJob> submit(
+            const shared_ptr<const Program> &a_program,
+            const double *const *a_variables,
+            double *a_results,
+            const size_t a_size,
+            const JobPriority a_priority = JobPriority::Normal,
+            const Clock::time_point a_deadline = Clock::time_point::max());
+    Statistics statistics() const;
+    void waitAll();
+
+private:
+    /**
+     * @brief Order of the jobs in one priority class
+     */
+    struct Urgency {
+        bool operator()(const shared_ptr<EvaluationJob> &a_first,
+                        const shared_ptr<EvaluationJob> &a_second) const;
+    };
+
+    /**
+     * @brief A part of a job given to a worker
+     */
+    struct Chunk {
+        shared_ptr<EvaluationJob> job; /**< The job */
+        size_t begin; /**< First row */
+        size_t end; /**< One after the last row */
+    };
+
+    bool takeChunk(Chunk &a_chunk);
+    void finishChunk(const Chunk &a_chunk);
+    void finishJob(EvaluationJob &a_job, const JobStatus a_status);
+    void run();
+
+    ThreadPool &m_pool; /**< Workers of the jobs */
+    mutable mutex m_mutex; /**< Guards all the members below */
+    condition_variable m_idle; /**< Wakes waitAll() */
+    set<shared_ptr<EvaluationJob>, Urgency> m_queues[3]; /**< By priority */
+    size_t m_runners; /**< Workers running run() */
+    size_t m_unfinished; /**< Jobs submitted and not finished */
+    uint64_t m_sequence; /**< Counter of submitted jobs */
+    size_t m_running[3]; /**< Started jobs that are not finished */
+    size_t m_done[3]; /**< Finished jobs */
+    size_t m_expired[3]; /**< Expired jobs */
+    size_t m_late[3]; /**< Jobs finished after the deadline */
+    double m_waitSum[3]; /**< Sum of the waiting of the started jobs */
+    size_t m_started[3]; /**< Number of started jobs */
+    double m_maxWait[3]; /**< Longest waiting */
+};
+
+}
+
+#endif // PSSMATHJOBS_H
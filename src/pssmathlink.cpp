@@ -0,0 +1,420 @@
+/**
+ *  @file pssmathlink.cpp
+ *  @brief Linking named expressions into one program
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathlink.h"
+#include "pssmathshare.h"
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <string.h>
+
+using namespace PssMathParser;
+
+namespace {
+
+/** @brief Slot that doesn't exist */
+const uint32_t NoSlot = UINT32_MAX;
+
+/**
+ * @brief The program of one link(), built while the definitions are inlined
+ * @details The slots are numbered as they are made, the variables are moved
+ * to the first slots by finish().
+ */
+class ProgramBuilder {
+public:
+    ProgramBuilder(
+            const unordered_map<string, CompiledExpression> &a_definitions,
+            ExpressionLinker::Statistics &a_statistics);
+
+    void reserve(const vector<string> &a_names);
+    uint32_t inlineProgram(const CompiledExpression &a_compiled);
+    CompiledExpression finish(const uint32_t a_resultSlot);
+    const string &errorString() const;
+
+private:
+    /** @brief Operation and arguments of an instruction */
+    typedef tuple<int, uintptr_t, uintptr_t, uint32_t, uint32_t> Key;
+
+    uint32_t resolve(const string &a_name);
+    uint32_t newSlot(const double a_value, const bool a_isConstant);
+    uint32_t constant(const double a_value);
+    uint32_t emit(Instruction a_instruction);
+
+    const unordered_map<string, CompiledExpression> &m_definitions; /**< By
+                                                                      name */
+    ExpressionLinker::Statistics &m_statistics; /**< Counters of the link */
+    vector<Instruction> m_instructions; /**< The program */
+    vector<double> m_values; /**< Initial value of every slot */
+    vector<uint8_t> m_isConstant; /**< The slot is known when linking */
+    vector<string> m_variableNames; /**< Free variables in order of use */
+    vector<uint32_t> m_variableSlots; /**< Slots of the free variables */
+    unordered_map<string, uint32_t> m_resolved; /**< Name to its slot */
+    vector<string> m_path; /**< Definitions being inlined */
+    map<Key, uint32_t> m_common; /**< Instruction to its result slot */
+    unordered_map<uint64_t, uint32_t> m_constants; /**< Bits to the slot */
+    string m_errorString; /**< Description of the error */
+};
+
+/**
+ * @brief Constructor of an empty program
+ * @param a_definitions The definitions of the linker
+ * @param a_statistics Counters, increased by the builder
+ */
+ProgramBuilder::ProgramBuilder(
+        const unordered_map<string, CompiledExpression> &a_definitions,
+        ExpressionLinker::Statistics &a_statistics):
+    m_definitions(a_definitions),
+    m_statistics(a_statistics)
+{
+}
+
+/**
+ * @brief Gives the first variable slots to the names, in their order
+ * @details The names of definitions are skipped.
+ * @param a_names Names of variables, also the ones no expression reads
+ */
+void ProgramBuilder::reserve(const vector<string> &a_names)
+{
+    for (const string &name : a_names) {
+        if (m_definitions.count(name) == 0)
+            resolve(name);
+    }
+}
+
+/**
+ * @brief Adds the instructions of the compiled expression
+ * @param a_compiled The expression, its variables are resolved by name
+ * @return **uint32_t** Slot of the result, NoSlot on an error
+ */
+uint32_t ProgramBuilder::inlineProgram(const CompiledExpression &a_compiled)
+{
+    const Program &program = *a_compiled.program;
+    const vector<double> &values = program.values();
+    vector<uint32_t> slots(values.size(), NoSlot);
+    for (size_t v = 0; v < a_compiled.variableNames.size(); v++) {
+        slots[v] = resolve(a_compiled.variableNames[v]);
+        if (slots[v] == NoSlot)
+            return NoSlot;
+    }
+
+    // Slots that no instruction writes are constants
+    vector<uint8_t> written(values.size());
+    for (const Instruction &ins : program.instructions())
+        written[ins.result] = 1;
+    for (size_t s = a_compiled.variableNames.size(); s < values.size(); s++) {
+        if (written[s] == 0)
+            slots[s] = constant(values[s]);
+    }
+
+    for (const Instruction &ins : program.instructions()) {
+        Instruction out = ins;
+        out.arg1 = slots[ins.arg1];
+        out.arg2 = ins.code == OpCode::CallOneArg ? 0 : slots[ins.arg2];
+        slots[ins.result] = emit(out);
+    }
+    if (program.resultSlot() == UINT32_MAX)
+        return constant(0.0);
+    return slots[program.resultSlot()];
+}
+
+/**
+ * @brief Makes the Program with the variables in the first slots
+ * @param a_resultSlot Slot of the result returned by inlineProgram()
+ * @return **CompiledExpression** The linked program and its variables
+ */
+CompiledExpression ProgramBuilder::finish(const uint32_t a_resultSlot)
+{
+    // The constants of the folded instructions are left out
+    vector<uint8_t> used(m_values.size());
+    for (const Instruction &ins : m_instructions) {
+        used[ins.arg1] = 1;
+        if (ins.code != OpCode::CallOneArg)
+            used[ins.arg2] = 1;
+        used[ins.result] = 1;
+    }
+    used[a_resultSlot] = 1;
+
+    const uint32_t variableSize = uint32_t(m_variableSlots.size());
+    vector<uint32_t> slots(m_values.size(), NoSlot);
+    uint32_t slotSize = 0;
+    for (uint32_t slot : m_variableSlots)
+        slots[slot] = slotSize++;
+    for (size_t s = 0; s < m_values.size(); s++) {
+        if (slots[s] == NoSlot && used[s] != 0)
+            slots[s] = slotSize++;
+    }
+    vector<double> values(slotSize);
+    for (size_t s = 0; s < m_values.size(); s++) {
+        if (slots[s] != NoSlot)
+            values[slots[s]] = m_values[s];
+    }
+    for (Instruction &ins : m_instructions) {
+        ins.arg1 = slots[ins.arg1];
+        if (ins.code != OpCode::CallOneArg)
+            ins.arg2 = slots[ins.arg2];
+        ins.result = slots[ins.result];
+    }
+    uint32_t resultSlot = slots[a_resultSlot];
+
+    // Shared with the equivalent programs like a compiled expression
+    vector<uint32_t> canonical;
+    if (InstructionPool::canonicalize(m_instructions, canonical, slotSize,
+                                      variableSize, resultSlot)) {
+        vector<double> moved(slotSize);
+        for (uint32_t s = 0; s < slotSize; s++)
+            moved[canonical[s]] = values[s];
+        values.swap(moved);
+        resultSlot = canonical[resultSlot];
+    }
+
+    CompiledExpression result;
+    result.program = make_shared<const Program>(
+                InstructionPool::instance().intern(m_instructions),
+                values, variableSize, resultSlot);
+    result.variableNames = m_variableNames;
+    result.expressionError = 0;
+    result.reversePolishError = 0;
+    return result;
+}
+
+/**
+ * @brief Description of the error of inlineProgram()
+ */
+const string &ProgramBuilder::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * @brief Slot of a name: the result of a definition or a free variable
+ * @param a_name The name of the variable
+ * @return **uint32_t** The slot, NoSlot if the definitions have a cycle
+ */
+uint32_t ProgramBuilder::resolve(const string &a_name)
+{
+    auto iresolved = m_resolved.find(a_name);
+    if (iresolved != m_resolved.end())
+        return iresolved->second;
+
+    auto idefinition = m_definitions.find(a_name);
+    if (idefinition == m_definitions.end()) {
+        uint32_t slot = newSlot(0.0, false);
+        m_variableNames.push_back(a_name);
+        m_variableSlots.push_back(slot);
+        m_resolved[a_name] = slot;
+        return slot;
+    }
+
+    auto ipath = find(m_path.begin(), m_path.end(), a_name);
+    if (ipath != m_path.end()) {
+        m_errorString = "The definitions have a cycle: ";
+        for (; ipath != m_path.end(); ++ipath)
+            m_errorString += *ipath + " -> ";
+        m_errorString += a_name;
+        return NoSlot;
+    }
+    m_path.push_back(a_name);
+    uint32_t slot = inlineProgram(idefinition->second);
+    m_path.pop_back();
+    if (slot != NoSlot) {
+        m_statistics.inlined++;
+        m_resolved[a_name] = slot;
+    }
+    return slot;
+}
+
+/**
+ * @brief Adds a slot
+ * @param a_value Initial value
+ * @param a_isConstant The value is known when linking
+ * @return **uint32_t** The new slot
+ */
+uint32_t ProgramBuilder::newSlot(const double a_value, const bool a_isConstant)
+{
+    m_values.push_back(a_value);
+    m_isConstant.push_back(a_isConstant ? 1 : 0);
+    return uint32_t(m_values.size() - 1);
+}
+
+/**
+ * @brief Slot of a constant, equal constants share one slot
+ * @param a_value The constant
+ * @return **uint32_t** The slot
+ */
+uint32_t ProgramBuilder::constant(const double a_value)
+{
+    uint64_t bits;
+    memcpy(&bits, &a_value, sizeof(bits));
+    auto iconstant = m_constants.find(bits);
+    if (iconstant != m_constants.end())
+        return iconstant->second;
+    uint32_t slot = newSlot(a_value, true);
+    m_constants[bits] = slot;
+    return slot;
+}
+
+/**
+ * @brief Adds an instruction, calculated now or merged if possible
+ * @param a_instruction The instruction on the slots of the builder
+ * @return **uint32_t** Slot of the result
+ */
+uint32_t ProgramBuilder::emit(Instruction a_instruction)
+{
+    const bool oneArg = a_instruction.code == OpCode::CallOneArg;
+    if (m_isConstant[a_instruction.arg1]
+            && (oneArg || m_isConstant[a_instruction.arg2])) {
+        double values[3] = { m_values[a_instruction.arg1],
+                             oneArg ? 0.0 : m_values[a_instruction.arg2],
+                             0.0 };
+        Instruction ins = a_instruction;
+        ins.arg1 = 0;
+        ins.arg2 = 1;
+        ins.result = 2;
+        m_statistics.folded++;
+        return constant(Program::run(&ins, 1, values, 2));
+    }
+
+    if ((a_instruction.code == OpCode::Add
+         || a_instruction.code == OpCode::Multiply)
+            && a_instruction.arg2 < a_instruction.arg1)
+        swap(a_instruction.arg1, a_instruction.arg2);
+    Key key(int(a_instruction.code),
+            uintptr_t(a_instruction.ddFunction),
+            uintptr_t(a_instruction.dddFunction),
+            a_instruction.arg1, a_instruction.arg2);
+    auto icommon = m_common.find(key);
+    if (icommon != m_common.end()) {
+        m_statistics.merged++;
+        return icommon->second;
+    }
+    a_instruction.result = newSlot(0.0, false);
+    m_instructions.push_back(a_instruction);
+    m_common[key] = a_instruction.result;
+    return a_instruction.result;
+}
+
+}
+
+/**
+ * @brief Constructor without definitions
+ */
+ExpressionLinker::ExpressionLinker():
+    m_statistics({ 0, 0, 0 })
+{
+}
+
+/**
+ * @brief Defines or changes a named expression
+ * @details The expression is compiled at once, its variables are resolved
+ * by link().
+ * @param a_name Name used as a variable by other expressions
+ * @param a_expression The infix expression
+ * @return **true** The expression is defined
+ * @return **false** The expression has an error or the name is a constant or
+ * an operator, see errorString()
+ */
+bool ExpressionLinker::define(const string &a_name,
+                              const string &a_expression)
+{
+    m_errorString.clear();
+    if (a_name.empty()
+            || MathExpression::constantMap.count(a_name) > 0
+            || MathExpression::operatorMap.count(a_name) > 0) {
+        m_errorString = "The name \'" + a_name + "\' can't be defined";
+        return false;
+    }
+    MathExpression parser;
+    CompiledExpression compiled = parser.compile(a_expression);
+    if (compiled.program == nullptr) {
+        m_errorString = compiled.errorString;
+        return false;
+    }
+    m_definitions[a_name] = compiled;
+    return true;
+}
+
+/**
+ * @brief Tells if the name is defined
+ */
+bool ExpressionLinker::isDefined(const string &a_name) const
+{
+    return m_definitions.count(a_name) > 0;
+}
+
+/**
+ * @brief Removes the definition, the name is a variable again
+ */
+void ExpressionLinker::undefine(const string &a_name)
+{
+    m_definitions.erase(a_name);
+}
+
+/**
+ * @brief Description of the error of the last define()
+ */
+const string ExpressionLinker::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * @brief Compiles the expression with the definitions inlined
+ * @details The variables of the program are the names that aren't defined,
+ * in the order they are met: the variables of the expression in order of
+ * appearance with the variables of every definition at its first use. The
+ * given variables come first, so a program linked again after the definitions
+ * change can keep the variable indices of the previous one.
+ * @param a_expression The infix expression, it can also be only a name
+ * @param a_variableNames Variables of the first slots, in this order, also
+ * the ones that aren't read
+ * @return **CompiledExpression** The linked program, or the error of the
+ * expression or the cycle of the definitions with a nullptr program
+ */
+CompiledExpression ExpressionLinker::link(const string &a_expression,
+                                          const vector<string> &a_variableNames)
+{
+    m_statistics = { 0, 0, 0 };
+    MathExpression parser;
+    CompiledExpression compiled = parser.compile(a_expression);
+    if (compiled.program == nullptr)
+        return compiled;
+
+    ProgramBuilder builder(m_definitions, m_statistics);
+    builder.reserve(a_variableNames);
+    uint32_t resultSlot = builder.inlineProgram(compiled);
+    if (resultSlot == NoSlot) {
+        CompiledExpression error;
+        error.expressionError = 0;
+        error.reversePolishError = 0;
+        error.errorString = builder.errorString();
+        return error;
+    }
+    return builder.finish(resultSlot);
+}
+
+/**
+ * @brief Counters of the last link()
+ */
+ExpressionLinker::Statistics ExpressionLinker::statistics() const
+{
+    return m_statistics;
+}
@@ -0,0 +1,83 @@
+/**
+ *  @file pssmathlink.h
+ *  @brief Headers for linking named expressions into one program
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHLINK_H
+#define PSSMATHLINK_H
+
+#include "pssmathparser.h"
+
+namespace PssMathParser {
+
+/**
+ * @brief Named expressions that other expressions read as variables
+ * @details Every definition is compiled once by define(). link() compiles an
+ * expression and replaces its variables that are names of definitions by the
+ * instructions of the definitions, also in the definitions it inlines. The
+ * definitions may be given in any order and may be changed, they are resolved
+ * when linking. A definition that reads itself through other definitions is
+ * an error.
+ *
+ * The inlined program is optimized as one program: instructions with constant
+ * arguments are calculated when linking (constant folding) and equal
+ * instructions on equal arguments are calculated once (common subexpression
+ * elimination), also across the definitions. The folded values are
+ * calculated by the same functions as the interpreter uses.
+ *
+ * ```c++
+ * ExpressionLinker linker;
+ * linker.define("Vt", "kBJ*(ToK+TC)/qe");
+ * CompiledExpression diode = linker.link("Io*(exp(V/Vt)-1)");
+ * // diode.variableNames are Io, V and TC
+ * ```
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC ExpressionLinker {
+public:
+    /**
+     * @brief Counters of the last link()
+     */
+    struct Statistics {
+        size_t inlined; /**< Definitions inlined */
+        size_t folded; /**< Instructions calculated when linking */
+        size_t merged; /**< Instructions equal to an earlier one */
+    };
+
+    ExpressionLinker();
+
+    bool define(const string &a_name, const string &a_expression);
+    bool isDefined(const string &a_name) const;
+    void undefine(const string &a_name);
+    const string errorString() const;
+
+    CompiledExpression link(const string &a_expression,
+                            const vector<string> &a_variableNames =
+                                vector<string>());
+    Statistics statistics() const;
+
+private:
+    unordered_map<string, CompiledExpression> m_definitions; /**< By name */
+    string m_errorString; /**< Error of the last define() */
+    Statistics m_statistics; /**< Counters of the last link() */
+};
+
+}
+
+#endif // PSSMATHLINK_H
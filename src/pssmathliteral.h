@@ -0,0 +1,752 @@
+/**
+ *  @file pssmathliteral.h
+ *  @brief Header only compile time front end for literal expressions
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHLITERAL_H
+#define PSSMATHLITERAL_H
+
+#if __cplusplus < 201703L
+#error "pssmathliteral.h needs C++17"
+#endif
+
+#include <array>
+#include <cmath>
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+#ifndef M_1_PI
+#define M_1_PI 0.31830988618379067154
+#endif
+
+#if defined(__GNUC__)
+#define PSSMATHPARSER_LITERAL_INLINE inline __attribute__((always_inline))
+#else
+#define PSSMATHPARSER_LITERAL_INLINE inline
+#endif
+
+/**
+ * @brief Parses the string literal at compile time
+ * @details The result is a LiteralExpression, a callable that takes the
+ * variables in order of appearance, as getVariableName() of the MathParser:
+ *
+ * ```c++
+ * constexpr auto wave = PSSMATHPARSER_LITERAL("2 * sin( 2*pi*f*t + phi )");
+ * double y = wave(50.0, 0.001, 0.785398); // f, t, phi
+ * ```
+ *
+ * Syntax errors stop the compilation with a static_assert.
+ */
+#define PSSMATHPARSER_LITERAL(a_expression) \
+    ([] { \
+        struct LiteralSource { \
+            static constexpr std::string_view text() \
+            { \
+                return std::string_view(a_expression); \
+            } \
+        }; \
+        return ::PssMathParser::LiteralExpression<LiteralSource>(); \
+    }())
+
+namespace PssMathParser {
+
+/**
+ * @brief Syntax errors found by the literal parser
+ */
+enum class LiteralError {
+    None,
+    EmptyExpression,
+    UnexpectedCharacter,
+    MissingOperand,
+    MissingParenthesis,
+    UnmatchedParenthesis,
+    InvalidNumber,
+    UnknownFunction,
+    MissingFunctionArgument
+};
+
+/**
+ * @brief Type of the node in the parsed literal
+ */
+enum class LiteralNodeType : uint8_t {
+    Number,
+    Variable,
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Power,
+    Function
+};
+
+/**
+ * @brief Functions of one argument known to the literal parser
+ */
+enum class LiteralFunction : uint8_t {
+    Sin,
+    Cos,
+    Tan,
+    Sqrt,
+    Exp
+};
+
+/**
+ * @brief Name of a function in the literal
+ */
+struct LiteralFunctionName {
+    std::string_view name; /**< Name as in the operatorMap */
+    LiteralFunction function; /**< The function */
+};
+
+/**
+ * @brief Named constant in the literal
+ */
+struct LiteralConstant {
+    std::string_view name; /**< Name as in the constantMap */
+    double value; /**< Value as in the constantMap */
+};
+
+/**
+ * @brief Functions of the operatorMap of the MathExpression
+ * @details `^` is the Power node. The two argument `pow` can't be called
+ * with parenthesis in the runtime parser either.
+ */
+inline constexpr LiteralFunctionName literalFunctions[] = {
+    {"sin", LiteralFunction::Sin},
+    {"cos", LiteralFunction::Cos},
+    {"tan", LiteralFunction::Tan},
+    {"sqrt", LiteralFunction::Sqrt},
+    {"exp", LiteralFunction::Exp}
+};
+
+/**
+ * @brief Constants of the constantMap of the MathExpression
+ */
+inline constexpr LiteralConstant literalConstants[] = {
+    {"pi", M_PI},
+    {"invPi", M_1_PI},
+    {"qe", 1.6021766208e-19},
+    {"kBJ", 1.38064852e-23},
+    {"kBeV", 8.6173303e-5},
+    {"ToK", 273.15}
+};
+
+/**
+ * @brief One node of the parsed literal
+ */
+struct LiteralNode {
+    LiteralNodeType type = LiteralNodeType::Number; /**< Type of the node */
+    LiteralFunction function = LiteralFunction::Sin; /**< Called function */
+    size_t left = 0; /**< First operand or the function argument */
+    size_t right = 0; /**< Second operand */
+    size_t index = 0; /**< Index of the variable */
+    double value = 0.0; /**< Value of the number */
+};
+
+/**
+ * @brief The literal parsed into a tree of nodes
+ * @details Spaces and tabs are removed and the successive signs are merged as
+ * in MathExpression::setExpression() and expressionToReversePolish().
+ * @tparam Capacity Maximum number of nodes, characters and variables
+ */
+template <size_t Capacity>
+struct LiteralProgram {
+    LiteralNode nodes[Capacity] = {}; /**< Nodes, children come first */
+    size_t nodeSize = 0; /**< Number of nodes */
+    size_t root = 0; /**< Index of the node with the result */
+    char text[Capacity] = {}; /**< Expression without spaces */
+    size_t textSize = 0; /**< Length of the text */
+    size_t position[Capacity] = {}; /**< Position of the char in the literal */
+    size_t variableStart[Capacity] = {}; /**< Name of the variable in text */
+    size_t variableLength[Capacity] = {}; /**< Length of the name */
+    size_t variableSize = 0; /**< Number of variables */
+    LiteralError error = LiteralError::None; /**< First syntax error */
+    size_t errorPosition = 0; /**< Position of the error in the literal */
+};
+
+/**
+ * @brief Recursive descent parser of the literal
+ * @details The grammar is the one of the runtime parser:
+ *
+ * ```
+ * expression = [sign] term {("+" | "-") term}
+ * term       = power {("*" | "/") power}
+ * power      = unary ["^" power]
+ * unary      = [sign] primary
+ * primary    = number | constant | variable | function "(" expression ")"
+ *            | "(" expression ")"
+ * ```
+ *
+ * A sign in front of the whole expression or of an unary is `0 - x`. A sign
+ * after an opening parenthesis or an operator is part of the number that
+ * follows it.
+ */
+template <size_t Capacity>
+class LiteralParser {
+public:
+    /**
+     * @brief Parses the literal
+     * @param a_text The literal
+     * @return LiteralProgram The nodes or the error
+     */
+    constexpr LiteralProgram<Capacity> parse(std::string_view a_text)
+    {
+        for (size_t i = 0; i < a_text.size(); i++) {
+            char c = a_text[i];
+            if (c == ' ' || c == '\t')
+                continue;
+            size_t last = m_program.textSize;
+            if (last > 0 && isSign(c) && isSign(m_program.text[last-1])) {
+                m_program.text[last-1] =
+                        (m_program.text[last-1] == c) ? '+' : '-';
+                continue;
+            }
+            m_program.position[last] = i;
+            m_program.text[last] = c;
+            m_program.textSize++;
+        }
+        if (m_program.textSize == 0) {
+            m_program.error = LiteralError::EmptyExpression;
+            return m_program;
+        }
+        m_program.root = expression(true);
+        if (m_program.error == LiteralError::None
+                && m_pos < m_program.textSize) {
+            setError(peek() == ')' ? LiteralError::UnmatchedParenthesis
+                                   : LiteralError::UnexpectedCharacter);
+        }
+        return m_program;
+    }
+
+private:
+    static constexpr bool isSign(const char a_char)
+    {
+        return a_char == '+' || a_char == '-';
+    }
+
+    static constexpr bool isDigit(const char a_char)
+    {
+        return a_char >= '0' && a_char <= '9';
+    }
+
+    static constexpr bool isAlpha(const char a_char)
+    {
+        return (a_char >= 'a' && a_char <= 'z')
+                || (a_char >= 'A' && a_char <= 'Z');
+    }
+
+    constexpr char peek(const size_t a_offset = 0) const
+    {
+        size_t i = m_pos + a_offset;
+        return i < m_program.textSize ? m_program.text[i] : '\0';
+    }
+
+    constexpr bool isNumberStart(const size_t a_offset) const
+    {
+        return isDigit(peek(a_offset)) || peek(a_offset) == '.';
+    }
+
+    constexpr void setError(const LiteralError a_error)
+    {
+        if (m_program.error != LiteralError::None)
+            return;
+        m_program.error = a_error;
+        m_program.errorPosition = (m_pos < m_program.textSize)
+                ? m_program.position[m_pos]
+                : (m_program.textSize > 0
+                   ? m_program.position[m_program.textSize-1] + 1 : 0);
+    }
+
+    constexpr size_t addNode(const LiteralNode &a_node)
+    {
+        m_program.nodes[m_program.nodeSize] = a_node;
+        return m_program.nodeSize++;
+    }
+
+    constexpr size_t addNumber(const double a_value)
+    {
+        LiteralNode node;
+        node.type = LiteralNodeType::Number;
+        node.value = a_value;
+        return addNode(node);
+    }
+
+    constexpr size_t addBinary(const LiteralNodeType a_type,
+                               const size_t a_left,
+                               const size_t a_right)
+    {
+        LiteralNode node;
+        node.type = a_type;
+        node.left = a_left;
+        node.right = a_right;
+        return addNode(node);
+    }
+
+    static constexpr LiteralNodeType binaryType(const char a_char)
+    {
+        switch (a_char) {
+        case '+': return LiteralNodeType::Add;
+        case '-': return LiteralNodeType::Subtract;
+        case '*': return LiteralNodeType::Multiply;
+        case '/': return LiteralNodeType::Divide;
+        default: return LiteralNodeType::Power;
+        }
+    }
+
+    constexpr size_t expression(const bool a_start)
+    {
+        size_t left = 0;
+        if (isSign(peek()) && (a_start || isNumberStart(1) == false)) {
+            char sign = peek();
+            m_pos++;
+            size_t zero = addNumber(0.0);
+            left = addBinary(binaryType(sign), zero, term());
+        }
+        else {
+            left = term();
+        }
+        while (m_program.error == LiteralError::None && isSign(peek())) {
+            char sign = peek();
+            m_pos++;
+            left = addBinary(binaryType(sign), left, term());
+        }
+        return left;
+    }
+
+    constexpr size_t term()
+    {
+        size_t left = power();
+        while (m_program.error == LiteralError::None
+               && (peek() == '*' || peek() == '/')) {
+            char op = peek();
+            m_pos++;
+            left = addBinary(binaryType(op), left, power());
+        }
+        return left;
+    }
+
+    constexpr size_t power()
+    {
+        size_t base = unary();
+        if (m_program.error == LiteralError::None && peek() == '^') {
+            m_pos++;
+            return addBinary(LiteralNodeType::Power, base, power());
+        }
+        return base;
+    }
+
+    constexpr size_t unary()
+    {
+        if (isSign(peek()) == false)
+            return primary();
+        char sign = peek();
+        m_pos++;
+        if (isNumberStart(0))
+            return number(sign == '-');
+        size_t zero = addNumber(0.0);
+        return addBinary(binaryType(sign), zero, primary());
+    }
+
+    constexpr size_t primary()
+    {
+        if (m_program.error != LiteralError::None)
+            return 0;
+        if (isNumberStart(0))
+            return number(false);
+        if (peek() == '(') {
+            m_pos++;
+            size_t node = expression(false);
+            closeParenthesis();
+            return node;
+        }
+        if (isAlpha(peek()))
+            return identifier();
+        setError(LiteralError::MissingOperand);
+        return 0;
+    }
+
+    constexpr void closeParenthesis()
+    {
+        if (m_program.error != LiteralError::None)
+            return;
+        if (peek() != ')') {
+            setError(m_pos < m_program.textSize
+                     ? LiteralError::UnexpectedCharacter
+                     : LiteralError::MissingParenthesis);
+            return;
+        }
+        m_pos++;
+    }
+
+    constexpr size_t number(const bool a_negative)
+    {
+        // Digits are gathered in an integer, the decimal exponent is separate
+        uint64_t mantissa = 0;
+        int exponent = 0;
+        int digits = 0;
+        bool exact = true, hasDigits = false, fraction = false;
+        for (; isDigit(peek()) || (peek() == '.' && fraction == false);
+             m_pos++) {
+            if (peek() == '.') {
+                fraction = true;
+                continue;
+            }
+            hasDigits = true;
+            int digit = peek() - '0';
+            if (mantissa == 0 && digit == 0) {
+                if (fraction)
+                    exponent--;
+                continue;
+            }
+            if (digits < 19) {
+                mantissa = mantissa * 10 + uint64_t(digit);
+                digits++;
+                if (fraction)
+                    exponent--;
+            }
+            else {
+                exact = exact && digit == 0;
+                if (fraction == false)
+                    exponent++;
+            }
+        }
+        if (hasDigits && peek() == 'e'
+                && (isDigit(peek(1)) || (isSign(peek(1)) && isDigit(peek(2))))) {
+            m_pos++;
+            bool negative = peek() == '-';
+            if (isSign(peek()))
+                m_pos++;
+            int value = 0;
+            for (; isDigit(peek()); m_pos++) {
+                if (value < 100000)
+                    value = value * 10 + (peek() - '0');
+            }
+            exponent += negative ? -value : value;
+        }
+        if (hasDigits == false) {
+            setError(LiteralError::InvalidNumber);
+            return 0;
+        }
+        double value = decimalToDouble(mantissa, exponent,
+                                       exact && mantissa < (1ULL << 53));
+        return addNumber(a_negative ? -value : value);
+    }
+
+    /**
+     * @brief Converts mantissa*10^exponent to double
+     * @details When the mantissa fits into the double and the power of ten is
+     * exact (up to 1e22) the result is one correctly rounded operation, the
+     * same as from atof(). Otherwise it's calculated in long double and may
+     * differ from atof() in the last bit.
+     */
+    static constexpr double decimalToDouble(const uint64_t a_mantissa,
+                                            const int a_exponent,
+                                            const bool a_exact)
+    {
+        if (a_mantissa == 0)
+            return 0.0;
+        if (a_exact && a_exponent >= -22 && a_exponent <= 22) {
+            double scale = 1.0;
+            for (int i = 0; i < (a_exponent < 0 ? -a_exponent : a_exponent);
+                 i++)
+                scale *= 10.0;
+            return a_exponent < 0 ? double(a_mantissa) / scale
+                                  : double(a_mantissa) * scale;
+        }
+        long double value = (long double)a_mantissa;
+        for (int i = 0; i < a_exponent; i++)
+            value *= 10.0L;
+        for (int i = 0; i > a_exponent; i--)
+            value /= 10.0L;
+        return double(value);
+    }
+
+    constexpr size_t identifier()
+    {
+        size_t start = m_pos;
+        while (isAlpha(peek()))
+            m_pos++;
+        std::string_view name(m_program.text + start, m_pos - start);
+
+        for (const LiteralFunctionName &function : literalFunctions) {
+            if (function.name != name)
+                continue;
+            if (peek() != '(') {
+                setError(LiteralError::MissingFunctionArgument);
+                return 0;
+            }
+            m_pos++;
+            LiteralNode node;
+            node.type = LiteralNodeType::Function;
+            node.function = function.function;
+            node.left = expression(false);
+            closeParenthesis();
+            return addNode(node);
+        }
+        if (peek() == '(' || name == "pow") {
+            m_pos = start;
+            setError(LiteralError::UnknownFunction);
+            return 0;
+        }
+        for (const LiteralConstant &constant : literalConstants) {
+            if (constant.name == name)
+                return addNumber(constant.value);
+        }
+
+        // Variables are numbered in order of appearance
+        LiteralNode node;
+        node.type = LiteralNodeType::Variable;
+        node.index = m_program.variableSize;
+        for (size_t i = 0; i < m_program.variableSize; i++) {
+            std::string_view other(m_program.text + m_program.variableStart[i],
+                                   m_program.variableLength[i]);
+            if (other == name)
+                node.index = i;
+        }
+        if (node.index == m_program.variableSize) {
+            m_program.variableStart[node.index] = start;
+            m_program.variableLength[node.index] = name.size();
+            m_program.variableSize++;
+        }
+        return addNode(node);
+    }
+
+    LiteralProgram<Capacity> m_program = {}; /**< The result */
+    size_t m_pos = 0; /**< Position in the text */
+};
+
+/**
+ * @brief Parses the literal, usable in static_assert
+ * @tparam Capacity At least twice the length of the literal plus one
+ * @param a_text The literal
+ * @return LiteralProgram The nodes or the error
+ */
+template <size_t Capacity>
+constexpr LiteralProgram<Capacity> parseLiteral(std::string_view a_text)
+{
+    return LiteralParser<Capacity>().parse(a_text);
+}
+
+/**
+ * @brief Parses the literal, only the error is returned
+ * @tparam Capacity At least twice the length of the literal plus one
+ * @param a_text The literal
+ * @return LiteralError Error or LiteralError::None
+ */
+template <size_t Capacity>
+constexpr LiteralError literalError(std::string_view a_text)
+{
+    return parseLiteral<Capacity>(a_text).error;
+}
+
+/**
+ * @brief Stops the compilation with the message of the error
+ * @details The position of the error in the literal is the template argument
+ * in the compiler message.
+ */
+template <LiteralError Error, size_t Position>
+struct LiteralCheck {
+    static_assert(Error != LiteralError::EmptyExpression,
+                  "PssMathParser literal: the expression is empty");
+    static_assert(Error != LiteralError::UnexpectedCharacter,
+                  "PssMathParser literal: unexpected character");
+    static_assert(Error != LiteralError::MissingOperand,
+                  "PssMathParser literal: operator without operand");
+    static_assert(Error != LiteralError::MissingParenthesis,
+                  "PssMathParser literal: missing closing parenthesis");
+    static_assert(Error != LiteralError::UnmatchedParenthesis,
+                  "PssMathParser literal: closing parenthesis without "
+                  "opening");
+    static_assert(Error != LiteralError::InvalidNumber,
+                  "PssMathParser literal: invalid number");
+    static_assert(Error != LiteralError::UnknownFunction,
+                  "PssMathParser literal: unknown function");
+    static_assert(Error != LiteralError::MissingFunctionArgument,
+                  "PssMathParser literal: function without parenthesis");
+    static constexpr bool value = Error == LiteralError::None;
+};
+
+/**
+ * @brief The parsed literal of the Source
+ */
+template <class Source>
+struct LiteralData {
+    static constexpr size_t capacity = 2 * Source::text().size() + 1;
+    static constexpr LiteralProgram<capacity> program =
+            parseLiteral<capacity>(Source::text());
+};
+
+/**
+ * @brief Expression template of one node, calculates the node and children
+ * @details The node is picked at compile time, so the calculation of the
+ * whole tree is inlined into one expression.
+ */
+template <class Source, size_t Index>
+struct LiteralEvaluator {
+    template <class Access>
+    PSSMATHPARSER_LITERAL_INLINE static double calculate(const Access &a_access)
+    {
+        constexpr const LiteralNode &node =
+                LiteralData<Source>::program.nodes[Index];
+        if constexpr (node.type == LiteralNodeType::Number) {
+            return node.value;
+        }
+        else if constexpr (node.type == LiteralNodeType::Variable) {
+            return a_access(node.index);
+        }
+        else if constexpr (node.type == LiteralNodeType::Function) {
+            double arg = LiteralEvaluator<Source, node.left>::calculate(
+                        a_access);
+            if constexpr (node.function == LiteralFunction::Sin)
+                return std::sin(arg);
+            else if constexpr (node.function == LiteralFunction::Cos)
+                return std::cos(arg);
+            else if constexpr (node.function == LiteralFunction::Tan)
+                return std::tan(arg);
+            else if constexpr (node.function == LiteralFunction::Sqrt)
+                return std::sqrt(arg);
+            else
+                return std::exp(arg);
+        }
+        else {
+            double arg1 = LiteralEvaluator<Source, node.left>::calculate(
+                        a_access);
+            double arg2 = LiteralEvaluator<Source, node.right>::calculate(
+                        a_access);
+            if constexpr (node.type == LiteralNodeType::Add)
+                return arg1 + arg2;
+            else if constexpr (node.type == LiteralNodeType::Subtract)
+                return arg1 - arg2;
+            else if constexpr (node.type == LiteralNodeType::Multiply)
+                return arg1 * arg2;
+            else if constexpr (node.type == LiteralNodeType::Divide)
+                return arg1 / arg2;
+            else
+                return std::pow(arg1, arg2);
+        }
+    }
+};
+
+/**
+ * @brief Callable made from the literal by PSSMATHPARSER_LITERAL
+ * @details Variables are the arguments in order of appearance, the same as
+ * the columns of MathParser::calculateBatch(). The results are the same as
+ * from the runtime parser, but the compiler may simplify the calls with
+ * constant arguments (for example `x^2` to `x*x`), which can change the last
+ * bit.
+ */
+template <class Source>
+class LiteralExpression final {
+    static_assert(LiteralCheck<LiteralData<Source>::program.error,
+                               LiteralData<Source>::program.errorPosition
+                               >::value,
+                  "PssMathParser literal: syntax error");
+
+    typedef LiteralEvaluator<Source, LiteralData<Source>::program.root>
+            Root;
+
+public:
+    /** @brief Number of variables */
+    static constexpr size_t variableSize =
+            LiteralData<Source>::program.variableSize;
+
+    /**
+     * @brief Getter of the literal
+     * @return **string_view** The expression as written
+     */
+    static constexpr std::string_view expression()
+    {
+        return Source::text();
+    }
+
+    /**
+     * @brief Return the name of the variable
+     * @param a_index Index of the variable, less than variableSize
+     * @return **string_view** Name of the variable or empty
+     */
+    static constexpr std::string_view variableName(const size_t a_index)
+    {
+        if (a_index >= variableSize)
+            return std::string_view();
+        return std::string_view(
+                    LiteralData<Source>::program.text
+                    + LiteralData<Source>::program.variableStart[a_index],
+                    LiteralData<Source>::program.variableLength[a_index]);
+    }
+
+    /**
+     * @brief Calculates the expression
+     * @param a_variables Values of all the variables
+     * @return **double** The result
+     */
+    template <class... Variables>
+    PSSMATHPARSER_LITERAL_INLINE double operator()(
+            const Variables... a_variables) const
+    {
+        static_assert(sizeof...(Variables) == variableSize,
+                      "PssMathParser literal: wrong number of variables");
+        const std::array<double, variableSize> values = {
+            {double(a_variables)...}
+        };
+        return calculate(values.data());
+    }
+
+    /**
+     * @brief Calculates the expression
+     * @param a_variables Array of variableSize values
+     * @return **double** The result
+     */
+    PSSMATHPARSER_LITERAL_INLINE double calculate(
+            const double *a_variables) const
+    {
+        (void)a_variables;
+        return Root::calculate([a_variables](const size_t a_index) {
+            return a_variables[a_index];
+        });
+    }
+
+    /**
+     * @brief Calculates the expression for many sets of variables
+     * @details Same as MathParser::calculateBatch().
+     * @param a_variables Array of variableSize columns of a_size values
+     * @param a_results Array of a_size values for the results
+     * @param a_size Number of rows
+     */
+    PSSMATHPARSER_LITERAL_INLINE void calculateBatch(
+            const double *const *a_variables,
+            double *a_results,
+            const size_t a_size) const
+    {
+        for (size_t i = 0; i < a_size; i++) {
+            a_results[i] = Root::calculate(
+                        [a_variables, i](const size_t a_index) {
+                return a_variables[a_index][i];
+            });
+        }
+    }
+};
+
+}
+
+#endif // PSSMATHLITERAL_H
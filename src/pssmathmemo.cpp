@@ -0,0 +1,497 @@
+/**
+ *  @file pssmathmemo.cpp
+ *  @brief Memoization of operators and of results
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathmemo.h"
+#include "pssmathparser.h"
+#include <atomic>
+#include <mutex>
+#include <string.h>
+
+using namespace PssMathParser;
+
+namespace {
+
+/** @brief Functions that can be memoized */
+const size_t MaxFunctions = 16;
+/** @brief Entries of a bucket of a MemoTable */
+const uint32_t MaxWays = 8;
+/** @brief Calls of a wrapper between the updates of the shared counters */
+const uint64_t FlushPeriod = 64;
+
+/**
+ * @brief A memoized function and its shared settings and counters
+ * @details The function is set once, before its wrapper is given out.
+ */
+struct FunctionSlot {
+    DDFunction ddFunction; /**< Function of one argument */
+    DDDFunction dddFunction; /**< Function of two arguments */
+    atomic<size_t> capacity; /**< Entries of the tables, 0 if disabled */
+    atomic<uint64_t> generation; /**< Changed by enable() and disable() */
+    atomic<uint64_t> hits; /**< Hits of all threads */
+    atomic<uint64_t> misses; /**< Misses of all threads */
+    atomic<uint64_t> evictions; /**< Evictions of all threads */
+};
+
+/**
+ * @brief The table of one thread for one function
+ */
+struct LocalMemo {
+    unique_ptr<MemoTable> table; /**< The table, nullptr until used */
+    uint64_t generation; /**< Generation of the slot of the table */
+    MemoTable::Statistics flushed; /**< Counters added to the slot */
+    uint64_t calls; /**< Calls since the table was made */
+};
+
+void flush(LocalMemo &a_local, FunctionSlot &a_slot);
+
+/**
+ * @brief The tables of one thread, the counters are added at the thread exit
+ */
+struct LocalMemos {
+    LocalMemo memos[MaxFunctions]; /**< Table of every function */
+    ~LocalMemos();
+};
+
+FunctionSlot g_slots[MaxFunctions]; /**< Memoized functions */
+size_t g_slotSize = 0; /**< Used slots */
+mutex g_mutex; /**< Guards the assignment of the slots */
+atomic<size_t> g_enabledSize(0); /**< Slots with capacity, read without lock */
+thread_local LocalMemos t_memos; /**< Tables of the thread */
+
+/**
+ * @brief Adds the new counts of the thread's table to the slot
+ */
+void flush(LocalMemo &a_local, FunctionSlot &a_slot)
+{
+    MemoTable::Statistics statistics = a_local.table->statistics();
+    a_slot.hits += statistics.hits - a_local.flushed.hits;
+    a_slot.misses += statistics.misses - a_local.flushed.misses;
+    a_slot.evictions += statistics.evictions - a_local.flushed.evictions;
+    a_local.flushed = statistics;
+}
+
+/**
+ * @brief Destructor, adds the counts of the thread
+ */
+LocalMemos::~LocalMemos()
+{
+    for (size_t i = 0; i < MaxFunctions; i++) {
+        if (memos[i].table != nullptr
+                && memos[i].generation == g_slots[i].generation.load())
+            flush(memos[i], g_slots[i]);
+    }
+}
+
+/**
+ * @brief The table of the thread for the slot, made again after enable()
+ * @param a_slot Index of the slot
+ * @param a_keySize Arguments of the function
+ * @return **LocalMemo*** The table, nullptr if the function is disabled
+ */
+LocalMemo *localMemo(const size_t a_slot, const uint32_t a_keySize)
+{
+    FunctionSlot &slot = g_slots[a_slot];
+    const uint64_t generation = slot.generation.load(memory_order_acquire);
+    const size_t capacity = slot.capacity.load(memory_order_relaxed);
+    if (capacity == 0)
+        return nullptr;
+    LocalMemo &local = t_memos.memos[a_slot];
+    if (local.table == nullptr || local.generation != generation) {
+        local.table.reset(new MemoTable(a_keySize, capacity));
+        local.generation = generation;
+        local.flushed = local.table->statistics();
+        local.calls = 0;
+    }
+    return &local;
+}
+
+/**
+ * @brief Counts a call, the shared counters are updated periodically
+ */
+void counted(LocalMemo &a_local, const size_t a_slot)
+{
+    if (++a_local.calls % FlushPeriod == 0)
+        flush(a_local, g_slots[a_slot]);
+}
+
+/**
+ * @brief The memoized function of one argument in the slot I
+ */
+template <size_t I>
+double memoizedOne(const double a_arg)
+{
+    LocalMemo *local = localMemo(I, 1);
+    if (local == nullptr)
+        return g_slots[I].ddFunction(a_arg);
+    double value;
+    if (local->table->find(&a_arg, value) == false) {
+        value = g_slots[I].ddFunction(a_arg);
+        local->table->insert(&a_arg, value);
+    }
+    counted(*local, I);
+    return value;
+}
+
+/**
+ * @brief The memoized function of two arguments in the slot I
+ */
+template <size_t I>
+double memoizedTwo(const double a_arg1, const double a_arg2)
+{
+    LocalMemo *local = localMemo(I, 2);
+    if (local == nullptr)
+        return g_slots[I].dddFunction(a_arg1, a_arg2);
+    const double key[2] = { a_arg1, a_arg2 };
+    double value;
+    if (local->table->find(key, value) == false) {
+        value = g_slots[I].dddFunction(a_arg1, a_arg2);
+        local->table->insert(key, value);
+    }
+    counted(*local, I);
+    return value;
+}
+
+/** @brief Wrappers of the functions of one argument, by slot */
+const DDFunction g_oneArgWrappers[MaxFunctions] = {
+    &memoizedOne<0>, &memoizedOne<1>, &memoizedOne<2>, &memoizedOne<3>,
+    &memoizedOne<4>, &memoizedOne<5>, &memoizedOne<6>, &memoizedOne<7>,
+    &memoizedOne<8>, &memoizedOne<9>, &memoizedOne<10>, &memoizedOne<11>,
+    &memoizedOne<12>, &memoizedOne<13>, &memoizedOne<14>, &memoizedOne<15>
+};
+
+/** @brief Wrappers of the functions of two arguments, by slot */
+const DDDFunction g_twoArgWrappers[MaxFunctions] = {
+    &memoizedTwo<0>, &memoizedTwo<1>, &memoizedTwo<2>, &memoizedTwo<3>,
+    &memoizedTwo<4>, &memoizedTwo<5>, &memoizedTwo<6>, &memoizedTwo<7>,
+    &memoizedTwo<8>, &memoizedTwo<9>, &memoizedTwo<10>, &memoizedTwo<11>,
+    &memoizedTwo<12>, &memoizedTwo<13>, &memoizedTwo<14>, &memoizedTwo<15>
+};
+
+/**
+ * @brief Slot of the function of the operator, g_mutex must be locked
+ * @param a_operator Name in the MathExpression::operatorMap
+ * @param a_assign Assigns a new slot if the function has none
+ * @return **size_t** The slot, MaxFunctions if there is none
+ */
+size_t slotOf(const string &a_operator, const bool a_assign)
+{
+    auto iop = MathExpression::operatorMap.find(a_operator);
+    if (iop == MathExpression::operatorMap.end())
+        return MaxFunctions;
+    const DDFunction ddFunction = iop->second.ddFunction();
+    const DDDFunction dddFunction = iop->second.dddFunction();
+    // The arithmetic is calculated inline, it has no call to memoize
+    if (ddFunction == nullptr
+            && (dddFunction == nullptr
+                || dddFunction == &MathExpression::add
+                || dddFunction == &MathExpression::subtract
+                || dddFunction == &MathExpression::multiply
+                || dddFunction == &MathExpression::divide))
+        return MaxFunctions;
+
+    for (size_t i = 0; i < g_slotSize; i++) {
+        if (g_slots[i].ddFunction == ddFunction
+                && g_slots[i].dddFunction == dddFunction)
+            return i;
+    }
+    if (a_assign == false || g_slotSize == MaxFunctions)
+        return MaxFunctions;
+    g_slots[g_slotSize].ddFunction = ddFunction;
+    g_slots[g_slotSize].dddFunction = dddFunction;
+    return g_slotSize++;
+}
+
+}
+
+/**
+ * @brief Constructor of an empty table
+ * @param a_keySize Doubles in a key
+ * @param a_capacity Entries, rounded up to a power of two
+ */
+MemoTable::MemoTable(const uint32_t a_keySize, const size_t a_capacity):
+    m_keySize(a_keySize),
+    m_stride(a_keySize + 2),
+    m_ways(1),
+    m_mask(1),
+    m_statistics({ 0, 0, 0, 0, 0 })
+{
+    size_t capacity = 1;
+    while (capacity < a_capacity)
+        capacity *= 2;
+    m_ways = uint32_t(min(capacity, size_t(MaxWays)));
+    m_mask = capacity / m_ways - 1;
+    m_statistics.capacity = capacity;
+    m_entries.assign(capacity * m_stride, 0);
+}
+
+/**
+ * @brief Number of doubles in a key
+ */
+uint32_t MemoTable::keySize() const
+{
+    return m_keySize;
+}
+
+/**
+ * @brief Finds the value of the key
+ * @param a_key keySize() doubles
+ * @param a_value Set to the value if the key is found
+ * @return **true** The key is found
+ * @return **false** The key isn't in the table
+ */
+bool MemoTable::find(const double *a_key, double &a_value)
+{
+    const uint64_t keyHash = hash(a_key);
+    const uint64_t *entry = &m_entries[(keyHash & m_mask) * m_ways * m_stride];
+    for (uint32_t way = 0; way < m_ways; way++, entry += m_stride) {
+        if (entry[0] == keyHash
+                && memcmp(entry + 1, a_key,
+                          m_keySize * sizeof(double)) == 0) {
+            memcpy(&a_value, entry + 1 + m_keySize, sizeof(double));
+            m_statistics.hits++;
+            return true;
+        }
+    }
+    m_statistics.misses++;
+    return false;
+}
+
+/**
+ * @brief Adds the key first in its bucket, the oldest key may be dropped
+ * @param a_key keySize() doubles
+ * @param a_value The value of the key
+ */
+void MemoTable::insert(const double *a_key, const double a_value)
+{
+    const uint64_t keyHash = hash(a_key);
+    uint64_t *entry = &m_entries[(keyHash & m_mask) * m_ways * m_stride];
+    for (uint32_t way = 0; way < m_ways; way++) {
+        uint64_t *used = entry + way * m_stride;
+        if (used[0] == keyHash
+                && memcmp(used + 1, a_key, m_keySize * sizeof(double)) == 0) {
+            memcpy(used + 1 + m_keySize, &a_value, sizeof(double));
+            return;
+        }
+    }
+    if (entry[(m_ways - 1) * m_stride] == 0)
+        m_statistics.size++;
+    else
+        m_statistics.evictions++;
+    memmove(entry + m_stride, entry,
+            (m_ways - 1) * m_stride * sizeof(uint64_t));
+    entry[0] = keyHash;
+    memcpy(entry + 1, a_key, m_keySize * sizeof(double));
+    memcpy(entry + 1 + m_keySize, &a_value, sizeof(double));
+}
+
+/**
+ * @brief Removes all the keys, the counters are kept
+ */
+void MemoTable::clear()
+{
+    fill(m_entries.begin(), m_entries.end(), 0);
+    m_statistics.size = 0;
+}
+
+/**
+ * @brief Copy of the counters
+ */
+MemoTable::Statistics MemoTable::statistics() const
+{
+    return m_statistics;
+}
+
+/**
+ * @brief Hash of the bits of the key, never 0
+ */
+uint64_t MemoTable::hash(const double *a_key) const
+{
+    uint64_t keyHash = 0x9E3779B97F4A7C15ULL;
+    for (uint32_t i = 0; i < m_keySize; i++) {
+        uint64_t bits;
+        memcpy(&bits, &a_key[i], sizeof(bits));
+        // The doubles often differ only in their high bits, the bucket is
+        // selected by the low bits
+        keyHash ^= bits;
+        keyHash ^= keyHash >> 33;
+        keyHash *= 0xFF51AFD7ED558CCDULL;
+        keyHash ^= keyHash >> 33;
+        keyHash *= 0xC4CEB9FE1A85EC53ULL;
+        keyHash ^= keyHash >> 33;
+    }
+    return keyHash | 1;
+}
+
+/**
+ * @brief Memoizes the function of the operator in the programs compiled next
+ * @details Enabling again empties the tables and the counters.
+ * @param a_operator Name in the MathExpression::operatorMap, like "exp"
+ * @param a_capacity Entries of the table of every thread
+ * @return **true** The operator is memoized
+ * @return **false** The operator is unknown or inline arithmetic, the
+ * capacity is 0, or too many functions are memoized
+ */
+bool OperatorMemo::enable(const string &a_operator, const size_t a_capacity)
+{
+    if (a_capacity == 0)
+        return false;
+    lock_guard<mutex> lock(g_mutex);
+    const size_t i = slotOf(a_operator, true);
+    if (i == MaxFunctions)
+        return false;
+    if (g_slots[i].capacity.exchange(a_capacity, memory_order_relaxed) == 0)
+        g_enabledSize.fetch_add(1, memory_order_release);
+    g_slots[i].hits = 0;
+    g_slots[i].misses = 0;
+    g_slots[i].evictions = 0;
+    g_slots[i].generation.fetch_add(1, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Stops the memoization of the operator
+ * @details The compiled programs call the function through the wrapper, the
+ * wrapper calls it directly. The counters are kept.
+ */
+void OperatorMemo::disable(const string &a_operator)
+{
+    lock_guard<mutex> lock(g_mutex);
+    const size_t i = slotOf(a_operator, false);
+    if (i == MaxFunctions)
+        return;
+    LocalMemo &local = t_memos.memos[i];
+    if (local.table != nullptr
+            && local.generation == g_slots[i].generation.load())
+        flush(local, g_slots[i]);
+    if (g_slots[i].capacity.exchange(0, memory_order_relaxed) > 0)
+        g_enabledSize.fetch_sub(1, memory_order_release);
+    g_slots[i].generation.fetch_add(1, memory_order_release);
+}
+
+/**
+ * @brief Tells if the function of the operator is memoized
+ */
+bool OperatorMemo::isEnabled(const string &a_operator)
+{
+    lock_guard<mutex> lock(g_mutex);
+    const size_t i = slotOf(a_operator, false);
+    return i != MaxFunctions && g_slots[i].capacity.load() > 0;
+}
+
+/**
+ * @brief Counters of the memoized operator
+ * @details The hits, misses and evictions are of all threads, the other
+ * threads add them every 64 calls and when they exit. The size is of the
+ * table of the calling thread.
+ * @param a_operator Name in the MathExpression::operatorMap
+ * @return **MemoTable::Statistics** The counters, zero if not memoized
+ */
+MemoTable::Statistics OperatorMemo::statistics(const string &a_operator)
+{
+    MemoTable::Statistics statistics = { 0, 0, 0, 0, 0 };
+    lock_guard<mutex> lock(g_mutex);
+    const size_t i = slotOf(a_operator, false);
+    if (i == MaxFunctions)
+        return statistics;
+    const LocalMemo &local = t_memos.memos[i];
+    if (local.table != nullptr
+            && local.generation == g_slots[i].generation.load()) {
+        MemoTable::Statistics own = local.table->statistics();
+        statistics.hits = own.hits - local.flushed.hits;
+        statistics.misses = own.misses - local.flushed.misses;
+        statistics.evictions = own.evictions - local.flushed.evictions;
+        statistics.size = own.size;
+    }
+    statistics.hits += g_slots[i].hits.load();
+    statistics.misses += g_slots[i].misses.load();
+    statistics.evictions += g_slots[i].evictions.load();
+    statistics.capacity = g_slots[i].capacity.load();
+    return statistics;
+}
+
+/**
+ * @brief The function to compile for the function of an operator
+ * @details Called for every call in every compiled program, so without any
+ * memoized operator it returns without the lock.
+ * @param a_function The function of the operator
+ * @return **DDFunction** The memoized wrapper if enabled, else the function
+ */
+DDFunction OperatorMemo::memoized(const DDFunction a_function)
+{
+    if (g_enabledSize.load(memory_order_acquire) == 0)
+        return a_function;
+    lock_guard<mutex> lock(g_mutex);
+    for (size_t i = 0; i < g_slotSize; i++) {
+        if (g_slots[i].ddFunction == a_function
+                && g_slots[i].capacity.load() > 0)
+            return g_oneArgWrappers[i];
+    }
+    return a_function;
+}
+
+/**
+ * @brief The function to compile for the function of an operator
+ * @param a_function The function of the operator
+ * @return **DDDFunction** The memoized wrapper if enabled, else the function
+ */
+DDDFunction OperatorMemo::memoized(const DDDFunction a_function)
+{
+    if (g_enabledSize.load(memory_order_acquire) == 0)
+        return a_function;
+    lock_guard<mutex> lock(g_mutex);
+    for (size_t i = 0; i < g_slotSize; i++) {
+        if (g_slots[i].dddFunction == a_function
+                && g_slots[i].capacity.load() > 0)
+            return g_twoArgWrappers[i];
+    }
+    return a_function;
+}
+
+/**
+ * @brief The function of the operator behind a wrapper
+ * @param a_function A function of a compiled program
+ * @return **DDFunction** The wrapped function, or a_function if it isn't a
+ * wrapper
+ */
+DDFunction OperatorMemo::original(const DDFunction a_function)
+{
+    for (size_t i = 0; i < MaxFunctions; i++) {
+        if (g_oneArgWrappers[i] == a_function)
+            return g_slots[i].ddFunction;
+    }
+    return a_function;
+}
+
+/**
+ * @brief The function of the operator behind a wrapper
+ * @param a_function A function of a compiled program
+ * @return **DDDFunction** The wrapped function, or a_function if it isn't a
+ * wrapper
+ */
+DDDFunction OperatorMemo::original(const DDDFunction a_function)
+{
+    for (size_t i = 0; i < MaxFunctions; i++) {
+        if (g_twoArgWrappers[i] == a_function)
+            return g_slots[i].dddFunction;
+    }
+    return a_function;
+}
@@ -0,0 +1,110 @@
+/**
+ *  @file pssmathmemo.h
+ *  @brief Headers for the memoization of operators and of results
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHMEMO_H
+#define PSSMATHMEMO_H
+
+#include "pssmathparser_global.h"
+#include "pssmathcore.h"
+#include <string>
+
+namespace PssMathParser {
+
+/**
+ * @brief Bounded hash table from a tuple of doubles to a double
+ * @details The table has a fixed number of entries, a power of two, in one
+ * array. The hash of a key selects a bucket of 8 neighbouring entries; a new
+ * key goes first in its bucket and the oldest key of a full bucket is dropped.
+ * The keys are compared bit by bit, so the value found is the value inserted
+ * for the same inputs. Some buckets fill before the others, so the capacity
+ * should be a few times the number of keys that are used again.
+ *
+ * The table isn't thread safe.
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC MemoTable {
+public:
+    /**
+     * @brief Counters of the table
+     */
+    struct Statistics {
+        uint64_t hits; /**< find() that found the key */
+        uint64_t misses; /**< find() that didn't find the key */
+        uint64_t evictions; /**< insert() that replaced another key */
+        size_t size; /**< Used entries */
+        size_t capacity; /**< All entries */
+    };
+
+    MemoTable(const uint32_t a_keySize, const size_t a_capacity);
+
+    uint32_t keySize() const;
+    bool find(const double *a_key, double &a_value);
+    void insert(const double *a_key, const double a_value);
+    void clear();
+    Statistics statistics() const;
+
+private:
+    uint64_t hash(const double *a_key) const;
+
+    uint32_t m_keySize; /**< Doubles in a key */
+    uint32_t m_stride; /**< Words of an entry: hash, key and value */
+    uint32_t m_ways; /**< Entries of a bucket */
+    size_t m_mask; /**< Buckets minus one */
+    vector<uint64_t> m_entries; /**< All entries, hash 0 if empty */
+    Statistics m_statistics; /**< Counters of the table */
+};
+
+/**
+ * @brief Memoization of the functions of selected operators
+ * @details After enable() the programs compiled by a MathExpression call the
+ * operator through a wrapper that looks its exact arguments up in a MemoTable
+ * first. Every thread has its own tables, so the wrappers take no locks. The
+ * memoization is of the function, so enabling "^" also memoizes "pow". The
+ * operators calculated inline (+ - * /) can't be memoized.
+ *
+ * ```c++
+ * OperatorMemo::enable("exp");
+ * parser.setMath("Io*(exp(V/Vt)-1)"); // compiled with the memoized exp
+ * MemoTable::Statistics statistics = OperatorMemo::statistics("exp");
+ * ```
+ *
+ * The programs compiled before enable() keep the function, the ones compiled
+ * after disable() keep the wrapper but it calls the function directly. The
+ * native code of EvaluationBackend::SystemCompiler and the programs sent to
+ * worker processes call the function without the memoization.
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC OperatorMemo {
+public:
+    static bool enable(const string &a_operator,
+                       const size_t a_capacity = 4096);
+    static void disable(const string &a_operator);
+    static bool isEnabled(const string &a_operator);
+    static MemoTable::Statistics statistics(const string &a_operator);
+
+    static DDFunction memoized(const DDFunction a_function);
+    static DDDFunction memoized(const DDDFunction a_function);
+    static DDFunction original(const DDFunction a_function);
+    static DDDFunction original(const DDDFunction a_function);
+};
+
+}
+
+#endif // PSSMATHMEMO_H
@@ -0,0 +1,69 @@
+/**
+ *  @file pssmathnative.cpp
+ *  @brief Source code for the native backends of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathnative.h"
+
+using namespace PssMathParser;
+
+/**
+ * @brief Constructor, the object holds no code
+ */
+NativeFunction::NativeFunction():
+    m_scalarEntry(nullptr),
+    m_batchEntry(nullptr)
+{
+}
+
+/**
+ * @brief Virtual destructor, the derived classes release the code
+ */
+NativeFunction::~NativeFunction()
+{
+}
+
+/**
+ * @brief Tells if the code is ready to run
+ * @return **true** Entry points can be called
+ * @return **false** No code
+ */
+bool NativeFunction::isCompiled() const
+{
+    return m_scalarEntry != nullptr && m_batchEntry != nullptr;
+}
+
+/**
+ * @brief Getter of the scalar entry point
+ * @return ScalarEntry Pointer to the function or nullptr
+ */
+NativeFunction::ScalarEntry NativeFunction::scalarEntry() const
+{
+    return m_scalarEntry;
+}
+
+/**
+ * @brief Getter of the batch entry point
+ * @return BatchEntry Pointer to the function or nullptr
+ */
+NativeFunction::BatchEntry NativeFunction::batchEntry() const
+{
+    return m_batchEntry;
+}
@@ -0,0 +1,63 @@
+/**
+ *  @file pssmathnative.h
+ *  @brief Headers for the native backends of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHNATIVE_H
+#define PSSMATHNATIVE_H
+
+#include "pssmathparser.h"
+
+namespace PssMathParser {
+
+/**
+ * @brief Base class for the compiled program translated to native code
+ * @details Every native backend produces two functions that work on the slots
+ * (m_values) of the MathExpression: scalar that calculates the program once,
+ * and batch that loops over the rows of the variable columns. The variables
+ * are the first slots of the program.
+ */
+class NativeFunction {
+public:
+    /** @brief Calculates the program once, returns the result */
+    typedef NativeScalarEntry ScalarEntry;
+    /** @brief Calculates the program for a_size rows of the variables */
+    typedef NativeBatchEntry BatchEntry;
+
+    NativeFunction();
+    virtual ~NativeFunction();
+
+    virtual EvaluationBackend backend() const = 0;
+    bool isCompiled() const;
+    ScalarEntry scalarEntry() const;
+    BatchEntry batchEntry() const;
+
+protected:
+    ScalarEntry m_scalarEntry; /**< Entry point of the scalar function */
+    BatchEntry m_batchEntry; /**< Entry point of the batch loop */
+
+private:
+    NativeFunction(const NativeFunction &) = delete;
+    NativeFunction &operator=(const NativeFunction &) = delete;
+};
+
+}
+
+#endif // PSSMATHNATIVE_H
@@ -21,6 +21,13 @@
  **/
 
 #include "pssmathparser.h"
+#include "pssmathjit.h"
+#include "pssmathcompiler.h"
+#include "pssmathcodegen.h"
+#include "pssmathschedule.h"
+#include "pssmathshare.h"
+#include "pssmathincremental.h"
+#include <string.h>
 
 using namespace PssMathParser;
 
@@ -157,6 +164,49 @@ MathParser *MathParser::makeMathParser() {
     return new MathExpression;
 }
 
+/**
+ * @brief Compiles many expressions on the workers of the thread pool
+ * @details Every worker parses with its own MathExpression, so the stacks and
+ * maps used while parsing are not shared. The static maps (operatorMap,
+ * constantMap) are only read and must not be changed during the call. An
+ * expression with an error doesn't stop the others, its result holds the
+ * error, see compile(). The programs are for the interpreter and can be run
+ * with an EvaluationContext.
+ *
+ * ```c++
+ * vector<CompiledExpression> rules = MathParser::compileAll(ruleStrings);
+ * for (const CompiledExpression &rule : rules) {
+ *     if (rule.program == nullptr)
+ *         cout << rule.errorString << endl;
+ * }
+ * ```
+ *
+ * @param a_expressions The infix expressions
+ * @param a_pool The pool of threads, nullptr for ThreadPool::instance()
+ * @return **vector<CompiledExpression>** One result for every expression in
+ * the same order
+ */
+vector<CompiledExpression> MathParser::compileAll(
+        const vector<string> &a_expressions,
+        ThreadPool *a_pool)
+{
+    ThreadPool &pool = a_pool != nullptr ? *a_pool : ThreadPool::instance();
+    vector<CompiledExpression> results(a_expressions.size());
+    vector<unique_ptr<MathExpression>> parsers(pool.size());
+    const size_t part = 16;
+    pool.parallelFor((a_expressions.size() + part - 1) / part,
+                     [&](size_t a_part, unsigned a_worker) {
+        unique_ptr<MathExpression> &parser = parsers[a_worker];
+        if (!parser)
+            parser.reset(new MathExpression);
+        const size_t end = min(a_expressions.size(), (a_part + 1) * part);
+        for (size_t i = a_part * part; i < end; i++) {
+            results[i] = parser->compile(a_expressions[i]);
+        }
+    });
+    return results;
+}
+
 /**
  * @brief Virtual destructor because this class is pure virtual
  */
@@ -332,6 +382,17 @@ EntityType Entity::entityType() const
     return m_type;
 }
 
+/**
+ * @brief Getter of the entity name
+ * @details For arguments and generators this is the key in the m_argumentMap.
+ * For operators this is the key in the operatorMap.
+ * @return **string** Name of the entity
+ */
+const string &Entity::getName() const
+{
+    return m_name;
+}
+
 /**
  * @brief Constructor, with constructor list only
  * @param a_name Name key of the Operator, part of the Entity parent class
@@ -404,6 +465,24 @@ double Operator::ddOperator(double a_arg1) const
     return m_ddOperator(a_arg1);
 }
 
+/**
+ * @brief Getter of the pointer to the function that operates on one arg
+ * @return **DDFunction** Pointer to the function or nullptr
+ */
+DDFunction Operator::ddFunction() const
+{
+    return m_ddOperator;
+}
+
+/**
+ * @brief Getter of the pointer to the function that operates on two args
+ * @return **DDDFunction** Pointer to the function or nullptr
+ */
+DDDFunction Operator::dddFunction() const
+{
+    return m_dddOperator;
+}
+
 /**
  * @brief Return the operator precedence as unsigned int
  *
@@ -496,7 +575,14 @@ int Argument::getIntValue()
 MathExpression::MathExpression():
     m_reversePolishError(0),
     m_expressionError(0),
-    m_mathPrintPrecision(7)
+    m_mathPrintPrecision(7),
+    m_userConstantCount(0),
+    m_compiled(false),
+    m_instructions(Program::empty()->instructionStream()),
+    m_resultSlot(UINT32_MAX),
+    m_backend(EvaluationBackend::Interpreter),
+    m_calculated(false),
+    m_resultMemoCapacity(0)
 {
 #if DEBUG_MESSAGES_PSSMATHPARSER == 1
     cout << "MathExpression constructor called" << endl;
@@ -504,6 +590,159 @@ MathExpression::MathExpression():
 #endif
 }
 
+/**
+ * @brief Copy constructor, duplicates the parsed and compiled expression
+ * @details Nothing is parsed again. The maps and the slots are copied and the
+ * Generators of the copy are pointed to the Arguments of the copy. The native
+ * code and the shared Program are immutable, so the copy shares them. The
+ * memo of the results is copied.
+ *
+ * Moving is O(1), see the move constructor.
+ * @param a_other The copied expression
+ */
+MathExpression::MathExpression(const MathExpression &a_other):
+    MathParser(),
+    m_reversePolishError(a_other.m_reversePolishError),
+    m_reversePolishErrorString(a_other.m_reversePolishErrorString),
+    m_expressionError(a_other.m_expressionError),
+    m_expressionErrorString(a_other.m_expressionErrorString),
+    m_expression(a_other.m_expression),
+    m_reversePolish(a_other.m_reversePolish),
+    m_mathPrintPrecision(a_other.m_mathPrintPrecision),
+    m_argumentMap(a_other.m_argumentMap),
+    m_generatorVec(a_other.m_generatorVec),
+    m_math(a_other.m_math),
+    m_RPstack(a_other.m_RPstack),
+    m_variableNames(a_other.m_variableNames),
+    m_userConstantCount(a_other.m_userConstantCount),
+    m_compiled(a_other.m_compiled),
+    m_instructions(a_other.m_instructions),
+    m_values(a_other.m_values),
+    m_slotMap(a_other.m_slotMap),
+    m_resultSlot(a_other.m_resultSlot),
+    m_backend(a_other.m_backend),
+    m_native(a_other.m_native),
+    m_program(a_other.m_program),
+    m_schedule(a_other.m_schedule),
+    m_incremental(a_other.m_incremental),
+    m_changed(a_other.m_changed),
+    m_calculated(a_other.m_calculated),
+    m_resultMemoCapacity(a_other.m_resultMemoCapacity),
+    m_resultMemo(a_other.m_resultMemo
+                 ? make_shared<MemoTable>(*a_other.m_resultMemo) : nullptr)
+{
+    unordered_map<const Argument *, Argument *> arguments;
+    for (const auto &iarg : a_other.m_argumentMap) {
+        arguments[&iarg.second] = &m_argumentMap.find(iarg.first)->second;
+    }
+    for (Generator &igen : m_generatorVec) {
+        igen.remapArguments(arguments);
+    }
+}
+
+/**
+ * @brief Move constructor, takes the parsed and compiled expression
+ * @details The nodes of the m_argumentMap are moved with the map, so the
+ * Generators stay valid. The moved-from expression is cleared, it is empty
+ * and can be used again.
+ * @param a_other The moved expression
+ */
+MathExpression::MathExpression(MathExpression &&a_other) noexcept:
+    MathParser(),
+    m_reversePolishError(std::move(a_other.m_reversePolishError)),
+    m_reversePolishErrorString(std::move(a_other.m_reversePolishErrorString)),
+    m_expressionError(std::move(a_other.m_expressionError)),
+    m_expressionErrorString(std::move(a_other.m_expressionErrorString)),
+    m_expression(std::move(a_other.m_expression)),
+    m_reversePolish(std::move(a_other.m_reversePolish)),
+    m_mathPrintPrecision(std::move(a_other.m_mathPrintPrecision)),
+    m_argumentMap(std::move(a_other.m_argumentMap)),
+    m_generatorVec(std::move(a_other.m_generatorVec)),
+    m_math(std::move(a_other.m_math)),
+    m_RPstack(std::move(a_other.m_RPstack)),
+    m_variableNames(std::move(a_other.m_variableNames)),
+    m_userConstantCount(std::move(a_other.m_userConstantCount)),
+    m_compiled(std::move(a_other.m_compiled)),
+    m_instructions(std::move(a_other.m_instructions)),
+    m_values(std::move(a_other.m_values)),
+    m_slotMap(std::move(a_other.m_slotMap)),
+    m_resultSlot(std::move(a_other.m_resultSlot)),
+    m_backend(std::move(a_other.m_backend)),
+    m_native(std::move(a_other.m_native)),
+    m_program(std::move(a_other.m_program)),
+    m_schedule(std::move(a_other.m_schedule)),
+    m_incremental(std::move(a_other.m_incremental)),
+    m_changed(std::move(a_other.m_changed)),
+    m_calculated(std::move(a_other.m_calculated)),
+    m_resultMemoCapacity(std::move(a_other.m_resultMemoCapacity)),
+    m_resultMemo(std::move(a_other.m_resultMemo))
+{
+    a_other.clear();
+}
+
+/**
+ * @brief Copy assignment, see the copy constructor
+ * @param a_other The copied expression
+ * @return MathExpression& This object
+ */
+MathExpression &MathExpression::operator=(const MathExpression &a_other)
+{
+    if (this != &a_other) {
+        MathExpression copy(a_other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+/**
+ * @brief Move assignment, see the move constructor
+ * @param a_other The moved expression, cleared
+ * @return MathExpression& This object
+ */
+MathExpression &MathExpression::operator=(MathExpression &&a_other) noexcept
+{
+    if (this != &a_other) {
+        m_reversePolishError = std::move(a_other.m_reversePolishError);
+        m_reversePolishErrorString = std::move(a_other.m_reversePolishErrorString);
+        m_expressionError = std::move(a_other.m_expressionError);
+        m_expressionErrorString = std::move(a_other.m_expressionErrorString);
+        m_expression = std::move(a_other.m_expression);
+        m_reversePolish = std::move(a_other.m_reversePolish);
+        m_mathPrintPrecision = std::move(a_other.m_mathPrintPrecision);
+        m_argumentMap = std::move(a_other.m_argumentMap);
+        m_generatorVec = std::move(a_other.m_generatorVec);
+        m_math = std::move(a_other.m_math);
+        m_RPstack = std::move(a_other.m_RPstack);
+        m_variableNames = std::move(a_other.m_variableNames);
+        m_userConstantCount = std::move(a_other.m_userConstantCount);
+        m_compiled = std::move(a_other.m_compiled);
+        m_instructions = std::move(a_other.m_instructions);
+        m_values = std::move(a_other.m_values);
+        m_slotMap = std::move(a_other.m_slotMap);
+        m_resultSlot = std::move(a_other.m_resultSlot);
+        m_backend = std::move(a_other.m_backend);
+        m_native = std::move(a_other.m_native);
+        m_program = std::move(a_other.m_program);
+        m_schedule = std::move(a_other.m_schedule);
+        m_incremental = std::move(a_other.m_incremental);
+        m_changed = std::move(a_other.m_changed);
+        m_calculated = std::move(a_other.m_calculated);
+        m_resultMemoCapacity = std::move(a_other.m_resultMemoCapacity);
+        m_resultMemo = std::move(a_other.m_resultMemo);
+        a_other.clear();
+    }
+    return *this;
+}
+
+/**
+ * @brief Copies the expression through the MathParser interface
+ * @return *MathParser New object, deleted by the caller
+ */
+MathParser *MathExpression::clone() const
+{
+    return new MathExpression(*this);
+}
+
 /**
  * @brief Destructor
  */
@@ -565,6 +804,46 @@ void MathExpression::setMath(const string &a_expression)
     expandMathExpression();
 }
 
+/**
+ * @brief Does the steps of setMath() and returns the program or the error
+ * @details The expression stays loaded in this object as after setMath().
+ * Empty expressions give the error 6.
+ * @param a_expression The infix expression
+ * @return **CompiledExpression** The shared program and the variable names, or
+ * the error
+ */
+CompiledExpression MathExpression::compile(const string &a_expression)
+{
+    clear();
+    setExpression(a_expression);
+    bool compiled = expressionToReversePolish()
+            && m_expressionError == 0
+            && setArgumentMap()
+            && expandMathExpression();
+    if (compiled && m_resultSlot == UINT32_MAX) {
+        m_expressionError = 6;
+        m_expressionErrorString = string("The expression is empty");
+    }
+
+    CompiledExpression result;
+    result.expressionError = m_expressionError;
+    result.reversePolishError = m_reversePolishError;
+    if (compiled && m_expressionError == 0 && m_reversePolishError == 0) {
+        result.program = program();
+        result.variableNames = m_variableNames;
+    }
+    else if (m_expressionErrorString.empty() == false) {
+        result.errorString = m_expressionErrorString;
+    }
+    else if (m_reversePolishErrorString.empty() == false) {
+        result.errorString = m_reversePolishErrorString;
+    }
+    else {
+        result.errorString = string("The expression can't be compiled");
+    }
+    return result;
+}
+
 /**
  * @brief Getter of the expression in reverse Polish notation
  * @return m_reversePolish The string that is the reverse polish of the
@@ -831,29 +1110,403 @@ bool MathExpression::expressionToReversePolish()
 
 /**
  * @brief Calculates the expression
- * @details This function calculates all the generators from the generator map
- * going successively which yields in the end the result of the calculation of
- * the whole expression.
+ * @details This function runs the compiled program (the flat form of the
+ * generator vector) going successively which yields in the end the result of
+ * the calculation of the whole expression. The program runs as native code if
+ * a native EvaluationBackend is set, or in the interpreter otherwise. With
+ * EvaluationBackend::Parallel the independent instructions are calculated by
+ * the workers of ThreadPool::instance(), see LevelSchedule. With
+ * EvaluationBackend::Incremental only the instructions downstream of the
+ * variables changed since the previous call are calculated, the others keep
+ * their values, see IncrementalSchedule.
  * @return **double** The result of the calculation, i.e. the value of the last
  * argument in the map
  */
 double MathExpression::calculateExpression()
 {
-    double dvalue=0.0;
-    if (m_generatorVec.size() == 0) {
-        if (m_math.size() > 0)
-            dvalue = m_argumentMap.at(m_math[m_math.size()-1]).getDoubleValue();
-        else
-            dvalue = 0;
+    if (m_compiled == false)
+        compileProgram();
+    double result;
+    if (m_resultMemo && m_resultMemo->find(m_values.data(), result))
+        return result;
+    if (m_native) {
+        result = m_native->scalarEntry()(m_values.data());
+    }
+    else if (m_schedule) {
+        result = m_schedule->run(m_values.data(), ThreadPool::instance());
+    }
+    else if (m_incremental) {
+        result = m_calculated
+                ? m_incremental->run(m_values.data(), m_changed)
+                : m_incremental->run(m_values.data());
+        m_changed.clear();
+        m_calculated = true;
     }
     else {
-        for (vector <Generator>::iterator igen = m_generatorVec.begin();
-             igen != m_generatorVec.end() - 1; ++igen) {
-            igen->generateDoubleValue();
-        }       
-        dvalue = m_generatorVec.back().generateDoubleValue();
+        result = runProgram(m_values.data());
     }
-    return dvalue;
+    if (m_resultMemo)
+        m_resultMemo->insert(m_values.data(), result);
+    return result;
+}
+
+/**
+ * @brief Calculates the expression for many sets of variables
+ * @details The variables are given as columns, one column for each variable in
+ * the order of getVariableName(). The result of the row i is written to
+ * a_results[i]. After the call the variables keep the values of the last row.
+ *
+ * ```c++
+ * mp->setMath("x*y");
+ * const double *columns[] = { xValues, yValues };
+ * mp->calculateBatch(columns, results, size);
+ * ```
+ *
+ * @param a_variables Array of getVariableSize() columns of a_size values
+ * @param a_results Array of a_size values for the results
+ * @param a_size Number of rows
+ */
+void MathExpression::calculateBatch(const double *const *a_variables,
+                                    double *a_results,
+                                    const size_t a_size)
+{
+    if (m_compiled == false)
+        compileProgram();
+    if (m_native) {
+        m_native->batchEntry()(m_values.data(), a_variables,
+                               a_results, a_size);
+        return;
+    }
+    const size_t variableSize = m_variableNames.size();
+    for (size_t i = 0; i < a_size; i++) {
+        for (size_t j = 0; j < variableSize; j++) {
+            m_values[j] = a_variables[j][i];
+        }
+        a_results[i] = runProgram(m_values.data());
+    }
+}
+
+/**
+ * @brief calculateBatch() that can be cancelled and reports its progress
+ * @details The rows are calculated in chunks of ThreadPool::chunkSize() rows.
+ * The token is checked before every chunk and the progress is called after
+ * it. After a cancel the results of the returned number of rows are written,
+ * the other results are not touched.
+ *
+ * ```c++
+ * CancellationToken stop; // stop.cancel() from another thread
+ * size_t done = mp->calculateBatch(columns, results, size,
+ *                                  BatchControl(&stop, showProgress));
+ * ```
+ *
+ * @param a_variables Array of getVariableSize() columns of a_size values
+ * @param a_results Array of a_size values for the results
+ * @param a_size Number of rows
+ * @param a_control The cancellation token and the progress
+ * @return **size_t** Number of the calculated rows, a_size if it wasn't
+ * cancelled
+ */
+size_t MathExpression::calculateBatch(const double *const *a_variables,
+                                      double *a_results,
+                                      const size_t a_size,
+                                      const BatchControl &a_control)
+{
+    const size_t variableSize = m_variableNames.size();
+    const size_t chunk = ThreadPool::chunkSize(uint32_t(variableSize));
+    vector<const double *> columns(variableSize);
+    size_t done = 0;
+    while (done < a_size && a_control.isCancelled() == false) {
+        const size_t rows = min(chunk, a_size - done);
+        for (size_t j = 0; j < variableSize; j++) {
+            columns[j] = a_variables[j] + done;
+        }
+        calculateBatch(columns.data(), a_results + done, rows);
+        done += rows;
+        a_control.report(done, a_size);
+    }
+    return done;
+}
+
+/**
+ * @brief Calculates the expression for many sets of variables on all cores
+ * @details Same as calculateBatch(), but the rows are split in chunks that are
+ * calculated on the workers of the thread pool, every worker with its own
+ * EvaluationContext. The results are the same as from calculateBatch(). The
+ * variables of this object are not changed. The chunks are queued to the
+ * workers and the calling thread waits for them, unless it is a worker of the
+ * pool, which calculates queued chunks while it waits. Only when all rows fit
+ * in one chunk or the pool has one worker they are calculated on the calling
+ * thread.
+ *
+ * ```c++
+ * ThreadPool pool(8);
+ * mp->calculateBatchParallel(columns, results, size, &pool);
+ * ```
+ *
+ * @param a_variables Array of getVariableSize() columns of a_size values
+ * @param a_results Array of a_size values for the results
+ * @param a_size Number of rows
+ * @param a_pool The pool of threads, nullptr for ThreadPool::instance()
+ */
+void MathExpression::calculateBatchParallel(const double *const *a_variables,
+                                            double *a_results,
+                                            const size_t a_size,
+                                            ThreadPool *a_pool)
+{
+    ThreadPool &pool = a_pool != nullptr ? *a_pool : ThreadPool::instance();
+    pool.calculateBatch(program(), a_variables, a_results, a_size);
+}
+
+/**
+ * @brief calculateBatchParallel() that can be cancelled and reports its
+ * progress
+ * @details See ThreadPool::calculateBatch(). After a cancel the rows from 0 to
+ * the returned number are calculated and the other results are not touched.
+ * @param a_variables Array of getVariableSize() columns of a_size values
+ * @param a_results Array of a_size values for the results
+ * @param a_size Number of rows
+ * @param a_control The cancellation token and the progress
+ * @param a_pool The pool of threads, nullptr for ThreadPool::instance()
+ * @return **size_t** Number of the first rows that are calculated, a_size if
+ * it wasn't cancelled
+ */
+size_t MathExpression::calculateBatchParallel(
+        const double *const *a_variables,
+        double *a_results,
+        const size_t a_size,
+        const BatchControl &a_control,
+        ThreadPool *a_pool)
+{
+    ThreadPool &pool = a_pool != nullptr ? *a_pool : ThreadPool::instance();
+    return pool.calculateBatch(program(), a_variables, a_results, a_size,
+                               a_control);
+}
+
+/**
+ * @brief calculateBatchParallel() that returns at once
+ * @details The calculation uses the program of the current expression, later
+ * changes of the parser don't affect it. The columns and the results must
+ * live until the future is ready.
+ *
+ * ```c++
+ * future<void> done = mp->calculateBatchAsync(columns, results, size);
+ * // Read the next input here
+ * done.get();
+ * ```
+ *
+ * @param a_variables Array of getVariableSize() columns of a_size values
+ * @param a_results Array of a_size values for the results
+ * @param a_size Number of rows
+ * @param a_pool The pool of threads, nullptr for ThreadPool::instance()
+ * @return **future<void>** Ready when the results are written
+ */
+future<void> MathExpression::calculateBatchAsync(
+        const double *const *a_variables,
+        double *a_results,
+        const size_t a_size,
+        ThreadPool *a_pool)
+{
+    shared_ptr<promise<void>> done = make_shared<promise<void>>();
+    future<void> result = done->get_future();
+    calculateBatchAsync(a_variables, a_results, a_size,
+                        [done](exception_ptr a_error) {
+        if (a_error)
+            done->set_exception(a_error);
+        else
+            done->set_value();
+    }, a_pool);
+    return result;
+}
+
+/**
+ * @brief calculateBatchParallel() that calls the callback when it is done
+ * @details Returns at once. The callback is called on a worker of the pool
+ * with nullptr or the exception of the calculation. The columns and the
+ * results must live until the callback is called.
+ * @param a_variables Array of getVariableSize() columns of a_size values
+ * @param a_results Array of a_size values for the results
+ * @param a_size Number of rows
+ * @param a_callback Called when the results are written
+ * @param a_pool The pool of threads, nullptr for ThreadPool::instance()
+ */
+void MathExpression::calculateBatchAsync(const double *const *a_variables,
+                                         double *a_results,
+                                         const size_t a_size,
+                                         const ThreadPool::Callback &a_callback,
+                                         ThreadPool *a_pool)
+{
+    ThreadPool &pool = a_pool != nullptr ? *a_pool : ThreadPool::instance();
+    pool.calculateBatchAsync(program(), a_variables, a_results, a_size,
+                             a_callback);
+}
+
+/**
+ * @brief Writes the expression as C++ source of an inline batch function
+ * @details The function has the signature of calculateBatch() and calculates
+ * the expression without the parser, so it can be built into the program and
+ * inlined by the compiler. Constants are written as exact literals and the
+ * functions are called by their math.h names. Including `<math.h>` and
+ * `<stddef.h>` before the function is up to the caller.
+ *
+ * ```c++
+ * mp->setMath("x*y");
+ * cout << mp->batchSource("product");
+ * // inline void product(const double *const *variables,
+ * //                     double *results, const size_t size)
+ * ```
+ *
+ * @param a_functionName Name of the function, must be a C++ identifier
+ * @return **string** The source or empty string if the expression has an
+ * error or can't be translated
+ */
+const string MathExpression::batchSource(const string &a_functionName)
+{
+    // A broken expression is still compiled from what was parsed
+    if (m_expressionError != 0 || m_reversePolishError != 0)
+        return string();
+    if (m_compiled == false && compileProgram() == false)
+        return string();
+    CodeGenerator generator(*m_instructions, m_values,
+                            uint32_t(m_variableNames.size()), m_resultSlot);
+    if (generator.isValid() == false)
+        return string();
+
+    string str;
+    string indent(a_functionName.size() + 13, ' ');
+    str += "/**\n";
+    str += " * @brief " + CodeGenerator::comment(m_expression) + "\n";
+    str += " * @details Columns of the variables:";
+    for (size_t v = 0; v < m_variableNames.size(); v++) {
+        str += string(v == 0 ? " " : ", ") + to_string(v) + " "
+                + CodeGenerator::comment(m_variableNames[v]);
+    }
+    if (m_variableNames.empty())
+        str += " none";
+    str += "\n */\n";
+    str += "inline void " + a_functionName + "(const double *const *variables,\n"
+            + indent + "double *results,\n"
+            + indent + "const size_t size)\n{\n";
+    if (m_variableNames.empty())
+        str += "    (void)variables;\n";
+    str += "    for (size_t i = 0; i < size; i++) {\n";
+    str += generator.statements("variables[%u][i]", "        ");
+    str += "        results[i] = " + generator.result() + ";\n";
+    str += "    }\n}\n";
+    return str;
+}
+
+/**
+ * @brief Context of the program() for calculating it in the caller's loop
+ * @details The CompiledFunction is defined in the header pssmathcore.h, so its
+ * calculation can be inlined into the loop of the caller instead of calling
+ * calculateExpression() through this interface. It doesn't change when this
+ * expression changes.
+ * @return CompiledFunction The context, of an empty program on errors
+ */
+CompiledFunction MathExpression::compiledFunction()
+{
+    return CompiledFunction(program());
+}
+
+/**
+ * @brief Immutable copy of the compiled program
+ * @details The Program is shared, it is made once and returned until the
+ * expression, the backend or a constant changes. Every thread calculates it
+ * with its own EvaluationContext, which costs no parsing:
+ *
+ * ```c++
+ * shared_ptr<const Program> program = mp->program();
+ * // In every thread
+ * EvaluationContext context(program);
+ * double result = context.calculate(variables);
+ * ```
+ *
+ * The initial variables of the contexts are the variables of this expression
+ * when the program was made. Setting a variable later doesn't change the
+ * shared program, so the threads should pass their variables to calculate().
+ * @return shared_ptr<const Program> The program, empty on errors
+ */
+shared_ptr<const Program> MathExpression::program()
+{
+    if (m_compiled == false && compileProgram() == false)
+        return Program::empty();
+    if (m_program == nullptr) {
+        m_program = make_shared<const Program>(
+                    m_instructions, m_values,
+                    uint32_t(m_variableNames.size()), m_resultSlot,
+                    m_native,
+                    m_native ? m_native->scalarEntry() : nullptr,
+                    m_native ? m_native->batchEntry() : nullptr);
+    }
+    return m_program;
+}
+
+/**
+ * @brief Selects the engine that calculates the expression
+ * @details The selection is kept for all the following expressions. If the
+ * requested backend can't be used (unsupported architecture, the system
+ * doesn't allow executable memory...) the interpreter is used instead.
+ * @param a_backend The requested EvaluationBackend
+ * @return **true** The requested backend is in use
+ * @return **false** The interpreter is used instead
+ */
+bool MathExpression::setBackend(const EvaluationBackend a_backend)
+{
+    m_backend = a_backend;
+    if (m_compiled == false) {
+        if (m_backend == EvaluationBackend::Jit)
+            return JitFunction::isSupported();
+        if (m_backend == EvaluationBackend::SystemCompiler)
+            return CompilerFunction::isSupported();
+        return true;
+    }
+    compileNative();
+    return backend() == m_backend;
+}
+
+/**
+ * @brief Getter of the engine that calculates the current expression
+ * @return EvaluationBackend The backend in use
+ */
+EvaluationBackend MathExpression::backend() const
+{
+    if (m_native)
+        return m_native->backend();
+    if (m_schedule)
+        return EvaluationBackend::Parallel;
+    if (m_incremental)
+        return EvaluationBackend::Incremental;
+    return EvaluationBackend::Interpreter;
+}
+
+/**
+ * @brief Memoizes the results of calculateExpression() on the variables
+ * @details The results are kept in a MemoTable whose keys are the values of
+ * the variables, so a calculation with the values of an earlier one returns
+ * its result without running the program. The memo is emptied when the
+ * expression is compiled again or a constant is changed. Like the backend
+ * the capacity is kept for the following expressions.
+ * @param a_capacity Results kept, 0 stops the memoization
+ */
+void MathExpression::setResultMemo(const size_t a_capacity)
+{
+    m_resultMemoCapacity = a_capacity;
+    m_resultMemo.reset();
+    if (m_compiled && m_resultMemoCapacity > 0)
+        m_resultMemo = make_shared<MemoTable>(
+                    uint32_t(m_variableNames.size()), m_resultMemoCapacity);
+}
+
+/**
+ * @brief Counters of the memo of the results
+ * @return **MemoTable::Statistics** The counters, zero if there is no memo
+ */
+MemoTable::Statistics MathExpression::resultMemoStatistics() const
+{
+    if (m_resultMemo)
+        return m_resultMemo->statistics();
+    MemoTable::Statistics statistics = { 0, 0, 0, 0, 0 };
+    return statistics;
 }
 
 /**
@@ -1092,7 +1745,25 @@ bool MathExpression::generateArgOp(const string &a_key1,
 
 bool MathExpression::expandMathExpression()
 {
+    // Every pass over the tokens copies the unfinished ones to the end of
+    // m_math. A pass that generates no arg only drops tokens, so it must get
+    // shorter or the operators have no args
+    size_t passEnd = m_math.size();
+    size_t passSize = m_math.size();
+    bool generated = false;
     for (size_t i=0; i<m_math.size(); i++) {
+        if (i == passEnd) {
+            const size_t size = m_math.size() - passEnd;
+            if (generated == false && size >= passSize) {
+                m_expressionError = 2;
+                m_expressionErrorString = string(
+                            "The RP expression has operator without args");
+                return false;
+            }
+            passEnd = m_math.size();
+            passSize = size;
+            generated = false;
+        }
         if (isOperator(m_math.at(i))) { // is (i) operator
             if (i>0) { // is i>0
                 if (isArgument(m_math.at(i-1))  // is(i-1, i) of type (arg op)
@@ -1114,6 +1785,7 @@ bool MathExpression::expandMathExpression()
                     // Generate new arg of type (arg op) and push new arg to
                     // m_math
                     generateArgOp(m_math.at(i-1), m_math.at(i));
+                    generated = true;
                     continue;
                 }
                 else if (isOperator(m_math.at(i-1)) // is(i-1, i) of
@@ -1144,6 +1816,7 @@ bool MathExpression::expandMathExpression()
                         generateArgArgOp(m_math.at(i-2),
                                          m_math.at(i-1),
                                          m_math.at(i));
+                        generated = true;
                         continue;
                     }
                     else if (isOperator(m_math.at(i-2))  // is(i-2, i-1, i) of
@@ -1173,7 +1846,7 @@ bool MathExpression::expandMathExpression()
             continue;
         }
     }
-    return true;
+    return compileProgram();
 }
 
 /**
@@ -1181,7 +1854,9 @@ bool MathExpression::expandMathExpression()
  */
 void MathExpression::clear()
 {
+    m_reversePolishError = 0;
     m_reversePolishErrorString.clear();
+    m_expressionError = 0;
     m_expressionErrorString.clear();
     m_expression.clear();
     m_reversePolish.clear();
@@ -1189,6 +1864,20 @@ void MathExpression::clear()
     m_generatorVec.clear();
     m_math.clear();
     m_RPstack.clear();
+    m_variableNames.clear();
+    m_userConstantCount = 0;
+    m_compiled = false;
+    m_instructions = Program::empty()->instructionStream();
+    m_values.clear();
+    m_slotMap.clear();
+    m_resultSlot = UINT32_MAX;
+    m_native.reset();
+    m_program.reset();
+    m_schedule.reset();
+    m_incremental.reset();
+    m_changed.clear();
+    m_calculated = false;
+    m_resultMemo.reset();
 }
 
 /**
@@ -1211,6 +1900,51 @@ bool MathExpression::hasOperatorMap(const string &a_operatorName) const
     return (operatorMap.find(a_operatorName) != operatorMap.end());
 }
 
+/**
+ * @brief Name of the operator that the instruction calls
+ * @details The function behind a memo wrapper (OperatorMemo::original()) is
+ * looked up in the operatorMap. Of the names of one function the identifier is
+ * preferred, so "pow" is found for "^".
+ * @param a_instruction A call instruction of a compiled program
+ * @param a_identifier Finds only names that can be called from C
+ * @return **string** The operator name, empty if the instruction is no call
+ * or the function has no such name
+ */
+const string MathExpression::operatorName(const Instruction &a_instruction,
+                                          const bool a_identifier)
+{
+    DDFunction ddFunction = nullptr;
+    DDDFunction dddFunction = nullptr;
+    if (a_instruction.code == OpCode::CallOneArg)
+        ddFunction = OperatorMemo::original(a_instruction.ddFunction);
+    else if (a_instruction.code == OpCode::CallTwoArg)
+        dddFunction = OperatorMemo::original(a_instruction.dddFunction);
+    if (ddFunction == nullptr && dddFunction == nullptr)
+        return string();
+    // Identifiers (sin, pow...) can be called from C, symbols (+, ^...) not
+    auto isIdentifier = [](const string &a_name) {
+        if (a_name.empty() || isalpha(a_name[0]) == false)
+            return false;
+        for (char c : a_name) {
+            if (isalnum(c) == false && c != '_')
+                return false;
+        }
+        return true;
+    };
+    string name;
+    for (const auto &iop : operatorMap) {
+        if ((ddFunction != nullptr && iop.second.ddFunction() == ddFunction)
+                || (dddFunction != nullptr
+                    && iop.second.dddFunction() == dddFunction)) {
+            if (isIdentifier(iop.first))
+                return iop.first;
+            if (a_identifier == false && name.empty())
+                name = iop.first;
+        }
+    }
+    return name;
+}
+
 /**
  * @brief Tests if the constantMap has a constant with the given name
  * @param a_constantName Name of the tested constant
@@ -1325,35 +2059,22 @@ bool MathExpression::isOperatorTwoArg(const string a_entityName) const
 
 /**
  * @brief Gets the number of specific entities
- * @details This is used to count the Arguments for creating a new argument.
+ * @details The arguments made by createNewUserConstantName() and the variables
+ * are counted while they are made, the other entities are counted in the
+ * m_argumentMap.
  * @param a_entityType This is one of the entities
- * @return **uint16_t** Number of entities
- */
-uint16_t MathExpression::getEntitySize(EntityType a_entityType) const
-{
-    uint16_t count=0;
-    // Count all arguments
-    if (a_entityType == EntityType::Argument) {
-        for (auto const &argmap : m_argumentMap) {
-            if( argmap.second.entityType()
-                    == EntityType::Argument
-                    || argmap.second.entityType()
-                    == EntityType::ArgumentGenerated
-                    || argmap.second.entityType()
-                    == EntityType::ArgumentGeneratedFromOneArg
-                    || argmap.second.entityType()
-                    == EntityType::ArgumentGeneratedFromTwoArg
-                    || argmap.second.entityType()
-                    == EntityType::ArgumentUserConstant )
-                count++;
-        }
-    }    
-    // Count only speciffic arguments
-    else {
-        for (auto const &argmap : m_argumentMap) {
-            if(argmap.second.entityType() == a_entityType)
-                count++;
-        }
+ * @return **uint32_t** Number of entities
+ */
+uint32_t MathExpression::getEntitySize(EntityType a_entityType) const
+{
+    if (a_entityType == EntityType::Argument)
+        return m_userConstantCount;
+    if (a_entityType == EntityType::ArgumentVariable)
+        return uint32_t(m_variableNames.size());
+    uint32_t count=0;
+    for (auto const &argmap : m_argumentMap) {
+        if(argmap.second.entityType() == a_entityType)
+            count++;
     }
     return count;
 }
@@ -1402,6 +2123,12 @@ bool MathExpression::setArgumentMap()
     m_math.clear();
     m_argumentMap.clear();
     m_generatorVec.clear();
+    m_variableNames.clear();
+    m_userConstantCount = 0;
+    m_compiled = false;
+    m_native.reset();
+    m_program.reset();
+    m_schedule.reset();
     string entity;
     for(size_t i=0; i<m_reversePolish.size(); i++) {
         // If it is end of entity - start parsing
@@ -1436,6 +2163,7 @@ bool MathExpression::setArgumentMap()
                             EntityType::ArgumentVariable,
                             0,
                             0.0}));
+                        m_variableNames.push_back(entity);
                     }
                     m_math.push_back(entity);
                 }
@@ -1479,24 +2207,20 @@ bool MathExpression::setArgumentMap()
 
 /**
  * @brief Creates new names for internaly defined arguments
- * @details Counts how many arguments are there and creates one from the new
- * available name. Available names are of the form #AA, #AB, #AC, ..., #BA,
- * #BB, ...
+ * @details Takes the next number from m_userConstantCount and writes it with
+ * the letters A-Z as digits, with at least two letters. Available names are of
+ * the form #AA, #AB, #AC, ..., #BA, #BB, ..., #ZZ, #BAA, #BAB, ...
  * @return **string** The new name
  */
-const string MathExpression::createNewUserConstantName() const
+const string MathExpression::createNewUserConstantName()
 {
-    string cstName;
-    cstName.push_back('#');
-    cstName.push_back(char(int('A')
-                           + getEntitySize(
-                               EntityType::Argument
-                               )/26));
-    cstName.push_back(char(int('A')
-                           + getEntitySize(
-                               EntityType::Argument
-                               )%26));
-    return cstName;
+    uint32_t number = m_userConstantCount++;
+    string letters;
+    do {
+        letters.push_back(char(int('A') + number % 26));
+        number /= 26;
+    } while (number > 0 || letters.size() < 2);
+    return "#" + string(letters.rbegin(), letters.rend());
 }
 
 /**
@@ -1573,18 +2297,16 @@ bool MathExpression::pushToReversePolish(
         }
         // If it is a ) push stack to output until (
         else if (a_str == ")") {
-            for(; m_RPstack[0] != "(";) {
+            while (m_RPstack.size() > 0 && m_RPstack[0] != "(") {
                 appendToReversePolishString(m_RPstack[0]);
-                if (m_RPstack.size()>0) {
-                    m_RPstack.erase(m_RPstack.begin());
-                }
-                else {
-                    m_expressionError = 4;
-                    m_expressionErrorString = string(
-                                "The expression doesn't "
-                                "have matching parenthesis");
-                    return false;
-                }
+                m_RPstack.erase(m_RPstack.begin());
+            }
+            if (m_RPstack.size() == 0) {
+                m_expressionError = 4;
+                m_expressionErrorString = string(
+                            "The expression doesn't "
+                            "have matching parenthesis");
+                return false;
             }
             m_RPstack.erase(m_RPstack.begin());
         }
@@ -1592,6 +2314,14 @@ bool MathExpression::pushToReversePolish(
     // If it is the last entry from the infix
     if (a_char == 'N' || a_char == 'A' || a_char == 'S') {
         for(size_t i=0; i<m_RPstack.size(); i++) {
+            if (m_RPstack[i] == "(") {
+                m_expressionError = 4;
+                m_expressionErrorString = string(
+                            "The expression doesn't "
+                            "have matching parenthesis");
+                m_RPstack.clear();
+                return false;
+            }
             appendToReversePolishString(m_RPstack[i]);
         }
         m_RPstack.clear();
@@ -1611,6 +2341,193 @@ void MathExpression::appendToReversePolishString(const string &a_str)
     m_reversePolish += a_str;
 }
 
+/**
+ * @brief Compiles the generator vector into a flat program
+ * @details Every argument gets a slot in the m_values array. The variables are
+ * placed first, in order of appearance, so the slot of a variable is also its
+ * column in calculateBatch(). Then come constants and generated arguments in
+ * order of appearance in m_math. Each Generator becomes one Instruction that
+ * reads and writes slots instead of Arguments.
+ *
+ * The program is then made canonical and its instructions are shared with the
+ * equivalent programs of other expressions through InstructionPool, the
+ * constants and the generated arguments move to their canonical slots. If a
+ * native backend is requested the program is also translated to native code.
+ * @return **true** Program compiled
+ * @return **false** Some generator could not be compiled, the expression
+ * error is 7
+ */
+bool MathExpression::compileProgram()
+{
+    m_instructions = Program::empty()->instructionStream();
+    m_values.clear();
+    m_slotMap.clear();
+    m_resultSlot = UINT32_MAX;
+    m_native.reset();
+    m_program.reset();
+    m_schedule.reset();
+    m_compiled = false;
+    // The expression stays not compiled, setVariableDouble() keeps using the
+    // m_argumentMap and the calculation gives the empty program
+    auto fail = [this]() {
+        m_incremental.reset();
+        m_resultMemo.reset();
+        m_expressionError = 7;
+        m_expressionErrorString = string(
+                    "The expression has an argument without a slot");
+        return false;
+    };
+
+    // Constants in generators point into the constantMap and other arguments
+    // point into the m_argumentMap, so the slot is found by the pointer
+    unordered_map<const Argument *, uint32_t> slotOfArgument;
+    for (const string &name : m_variableNames) {
+        const Argument *arg = getArgument(name);
+        slotOfArgument[arg] = uint32_t(m_values.size());
+        m_slotMap[name] = uint32_t(m_values.size());
+        m_values.push_back(arg->getDoubleValue());
+    }
+    for (const string &name : m_math) {
+        if (hasArgumentMap(name) == false || m_slotMap.count(name) > 0)
+            continue;
+        const Argument *arg = getArgument(name);
+        uint32_t slot = uint32_t(m_values.size());
+        slotOfArgument[arg] = slot;
+        if (hasConstantMap(name))
+            slotOfArgument[getConstant(name)] = slot;
+        m_slotMap[name] = slot;
+        m_values.push_back(arg->getDoubleValue());
+    }
+
+    vector<Instruction> instructions;
+    instructions.reserve(m_generatorVec.size());
+    for (const Generator &igen : m_generatorVec) {
+        const Operator *op = igen.getOperator();
+        Instruction ins = { OpCode::CallTwoArg, 0, 0, 0, nullptr, nullptr };
+        auto iarg1 = slotOfArgument.find(igen.getFirstArgument());
+        auto iresult = slotOfArgument.find(igen.getGeneratedArgument());
+        if (op == nullptr
+                || iarg1 == slotOfArgument.end()
+                || iresult == slotOfArgument.end()) {
+            return fail();
+        }
+        ins.arg1 = iarg1->second;
+        ins.result = iresult->second;
+        if (igen.entityType() == EntityType::ArgumentGeneratedFromOneArg) {
+            ins.code = OpCode::CallOneArg;
+            ins.ddFunction = OperatorMemo::memoized(op->ddFunction());
+        }
+        else {
+            auto iarg2 = slotOfArgument.find(igen.getSecondArgument());
+            if (iarg2 == slotOfArgument.end()) {
+                return fail();
+            }
+            ins.arg2 = iarg2->second;
+            ins.dddFunction = op->dddFunction();
+            // The arithmetic is done inline, without the function call
+            if (ins.dddFunction == &MathExpression::add)
+                ins.code = OpCode::Add;
+            else if (ins.dddFunction == &MathExpression::subtract)
+                ins.code = OpCode::Subtract;
+            else if (ins.dddFunction == &MathExpression::multiply)
+                ins.code = OpCode::Multiply;
+            else if (ins.dddFunction == &MathExpression::divide)
+                ins.code = OpCode::Divide;
+            else
+                ins.dddFunction = OperatorMemo::memoized(ins.dddFunction);
+        }
+        instructions.push_back(ins);
+    }
+
+    // The result is the last generated argument or the only argument
+    if (instructions.size() > 0) {
+        m_resultSlot = instructions.back().result;
+    }
+    else if (m_math.size() > 0) {
+        auto islot = m_slotMap.find(m_math.back());
+        if (islot != m_slotMap.end())
+            m_resultSlot = islot->second;
+    }
+
+    vector<uint32_t> slots;
+    if (InstructionPool::canonicalize(instructions, slots,
+                                      uint32_t(m_values.size()),
+                                      uint32_t(m_variableNames.size()),
+                                      m_resultSlot)) {
+        vector<double> values(m_values.size());
+        for (size_t i = 0; i < m_values.size(); i++)
+            values[slots[i]] = m_values[i];
+        m_values.swap(values);
+        for (auto &islot : m_slotMap)
+            islot.second = slots[islot.second];
+        m_resultSlot = slots[m_resultSlot];
+    }
+    m_instructions = InstructionPool::instance().intern(instructions);
+    m_compiled = true;
+
+    compileNative();
+    return true;
+}
+
+/**
+ * @brief Translates the compiled program to the requested native backend
+ * @details On failure the native code is released and the interpreter is used.
+ * For EvaluationBackend::Parallel the program is sorted in a LevelSchedule,
+ * for EvaluationBackend::Incremental the dependents of the variables are
+ * found in an IncrementalSchedule.
+ */
+void MathExpression::compileNative()
+{
+    m_native.reset();
+    m_program.reset();
+    m_schedule.reset();
+    m_incremental.reset();
+    m_changed.clear();
+    m_calculated = false;
+    m_resultMemo.reset();
+    if (m_resultMemoCapacity > 0)
+        m_resultMemo = make_shared<MemoTable>(
+                    uint32_t(m_variableNames.size()), m_resultMemoCapacity);
+    if (m_backend == EvaluationBackend::Parallel) {
+        m_schedule = make_shared<const LevelSchedule>(*m_instructions,
+                                                      m_resultSlot);
+    }
+    else if (m_backend == EvaluationBackend::Incremental) {
+        m_incremental = make_shared<const IncrementalSchedule>(
+                    m_instructions, uint32_t(m_variableNames.size()),
+                    m_resultSlot);
+    }
+    else if (m_backend == EvaluationBackend::Jit
+             && JitFunction::isSupported()) {
+        shared_ptr<JitFunction> jit(new JitFunction);
+        if (jit->compile(*m_instructions,
+                         uint32_t(m_variableNames.size()),
+                         m_resultSlot))
+            m_native = jit;
+    }
+    else if (m_backend == EvaluationBackend::SystemCompiler
+             && CompilerFunction::isSupported()) {
+        shared_ptr<CompilerFunction> function(new CompilerFunction);
+        if (function->compile(*m_instructions,
+                              m_values,
+                              uint32_t(m_variableNames.size()),
+                              m_resultSlot,
+                              m_expression))
+            m_native = function;
+    }
+}
+
+/**
+ * @brief Interpreter of the compiled program
+ * @param a_values The slots of the program
+ * @return **double** Value of the result slot
+ */
+double MathExpression::runProgram(double *a_values) const
+{
+    return Program::run(m_instructions->data(), m_instructions->size(),
+                        a_values, m_resultSlot);
+}
+
 /**
  * @brief Get the math precision for printing
  * @return **uint16_t** The precision when printing
@@ -1622,13 +2539,41 @@ uint16_t MathExpression::getMathPrintPrecision() const
 
 /**
  * @brief Sets the value of the variable from the argument map
+ * @details With EvaluationBackend::Incremental the variable is marked as
+ * changed if the value is different, a changed constant makes the next
+ * calculation run the whole program. The values are compared bit by bit.
  * @param a_name Name of the variable
  * @param a_value Value of the variable (double)
  */
 void MathExpression::setVariableDouble(const string &a_name,
                                        const double a_value)
 {
-    if (hasArgumentMap(a_name)) {
+    if (m_compiled) {
+        auto islot = m_slotMap.find(a_name);
+        if (islot != m_slotMap.end()) {
+            const uint32_t slot = islot->second;
+            const bool isVariable = slot < m_variableNames.size();
+            // Bits are compared, -0.0 and 0.0 give different results of 1/x
+            // and a NaN is never equal to itself
+            const bool changed = memcmp(&m_values[slot], &a_value,
+                                        sizeof(double)) != 0;
+            if (m_incremental && changed) {
+                if (isVariable == false)
+                    m_calculated = false;
+                else if (find(m_changed.begin(), m_changed.end(), slot)
+                         == m_changed.end())
+                    m_changed.push_back(slot);
+            }
+            // The memo has only the variables in its keys
+            if (m_resultMemo && isVariable == false && changed)
+                m_resultMemo->clear();
+            m_values[slot] = a_value;
+            // Constants are part of the shared program
+            if (isVariable == false)
+                m_program.reset();
+        }
+    }
+    else if (hasArgumentMap(a_name)) {
         m_argumentMap.find(a_name)->second.setDoubleValue(a_value);
     }
 }
@@ -1641,6 +2586,20 @@ uint16_t MathExpression::getVariableSize() const
     return getEntitySize(EntityType::ArgumentVariable);
 }
 
+/**
+ * @brief Return the name of the variable
+ * @details Variables are ordered as they first appear in the expression. This
+ * is also the order of the columns in calculateBatch().
+ * @param a_index Index of the variable, less than getVariableSize()
+ * @return **string** Name of the variable or empty string
+ */
+const string MathExpression::getVariableName(const uint16_t a_index) const
+{
+    if (a_index < m_variableNames.size())
+        return m_variableNames[a_index];
+    return string();
+}
+
 /**
  * @brief Sets the precission (digits after comma) when printing numbers
  * @param mathPrintPrecision Integer of precission default is 7
@@ -1657,6 +2616,11 @@ void MathExpression::setMathPrintPrecision(const uint16_t &mathPrintPrecision)
  */
 double MathExpression::getArgumentDoubleValue(const string &a_key) const
 {
+    if (m_compiled) {
+        auto islot = m_slotMap.find(a_key);
+        if (islot != m_slotMap.end())
+            return m_values[islot->second];
+    }
     Argument arg = m_argumentMap.find(a_key)->second;
     return arg.getDoubleValue();
 }
@@ -1776,12 +2740,59 @@ double Generator::generateDoubleValue() const
 }
 
 /**
- * @brief Getter of the generator name
- * @details This is a name that also exists in the m_argumentMap. This name
- * connects the generator and the argument which value is generated.
- * @return **string** Name of the generator
+ * @brief Getter of the generator's operator
+ * @return *Operator Pointer to the operator
  */
-const string &Generator::getName() const
+const Operator *Generator::getOperator() const
 {
-    return m_name;
+    return m_op;
+}
+
+/**
+ * @brief Getter of the first argument
+ * @return *Argument Pointer to the first argument
+ */
+const Argument *Generator::getFirstArgument() const
+{
+    return m_arg1;
+}
+
+/**
+ * @brief Getter of the second argument
+ * @return *Argument Pointer to the second argument or nullptr
+ */
+const Argument *Generator::getSecondArgument() const
+{
+    return m_arg2;
+}
+
+/**
+ * @brief Getter of the argument which value is generated
+ * @details The name of this argument is the same as the generator's name.
+ * This name connects the generator and the argument in the m_argumentMap.
+ * @return *Argument Pointer to the generated argument
+ */
+const Argument *Generator::getGeneratedArgument() const
+{
+    return m_myArg;
+}
+
+/**
+ * @brief Points the generator to other arguments
+ * @details Used when the m_argumentMap is copied. Arguments that are not in
+ * the map (constants in the constantMap) are not changed.
+ * @param a_arguments Map from the old to the new argument
+ */
+void Generator::remapArguments(
+        const unordered_map<const Argument *, Argument *> &a_arguments)
+{
+    auto iarg = a_arguments.find(m_arg1);
+    if (iarg != a_arguments.end())
+        m_arg1 = iarg->second;
+    iarg = a_arguments.find(m_arg2);
+    if (iarg != a_arguments.end())
+        m_arg2 = iarg->second;
+    iarg = a_arguments.find(m_myArg);
+    if (iarg != a_arguments.end())
+        m_myArg = iarg->second;
 }
@@ -24,6 +24,9 @@
 #define PSSMATHPARSER_H
 
 #include "pssmathparser_global.h"
+#include "pssmathcore.h"
+#include "pssmaththreadpool.h"
+#include "pssmathmemo.h"
 #include <math.h>
 #include <stdlib.h>
 #include <iostream>
@@ -35,6 +38,8 @@
 #include <algorithm>
 #include <iomanip>
 #include <sstream>
+#include <memory>
+#include <future>
 
 /**
  * @brief Library for parsing math expression strings
@@ -50,6 +55,10 @@ namespace PssMathParser {
 
 using namespace std;
 
+class NativeFunction;
+class LevelSchedule;
+class IncrementalSchedule;
+
 /**
  * @brief Enum defines all the types of functions for the operator
  */
@@ -69,6 +78,17 @@ enum class EntityType {
     ArgumentGeneratedFromTwoArg
 };
 
+/**
+ * @brief Enum defines the engines that can calculate the compiled program
+ */
+enum class EvaluationBackend {
+    Interpreter,
+    Jit,
+    SystemCompiler,
+    Parallel,
+    Incremental
+};
+
 /**
  * @brief Enum defines precedence of operators
  */
@@ -92,7 +112,8 @@ public:
     ~Entity();
 
     const Entity *getEntity() const;
-    EntityType entityType() const;    
+    EntityType entityType() const;
+    const string &getName() const;
 
 protected:
     string  m_name; /**< Name of func or arg */
@@ -120,6 +141,8 @@ public:
 
     double dddOperator(double a_arg1, double a_arg2) const;
     double ddOperator(double a_arg1) const;
+    DDFunction ddFunction() const;
+    DDDFunction dddFunction() const;
     uint16_t precedence() const;
 private:
     OperatorPrecedence m_precedence;  /**< Higher number operates first */
@@ -169,7 +192,12 @@ public:
                Argument *a_myArg = nullptr);
 
     double generateDoubleValue() const;
-    const string &getName() const;
+    const Operator *getOperator() const;
+    const Argument *getFirstArgument() const;
+    const Argument *getSecondArgument() const;
+    const Argument *getGeneratedArgument() const;
+    void remapArguments(
+            const unordered_map<const Argument *, Argument *> &a_arguments);
 
 private:
     const Operator *m_op; /**< Points to the operator of the genrator */
@@ -178,6 +206,21 @@ private:
     Argument *m_myArg; /**< Points to the generated argument */
 };
 
+/**
+ * @brief One expression compiled by MathParser::compile()
+ * @details On success the program is set and the error numbers are zero. On
+ * failure the program is nullptr and the error numbers and the string tell
+ * what went wrong, as expressionErrorNum() and reversePolishErrorNum() of the
+ * parser.
+ */
+struct CompiledExpression {
+    shared_ptr<const Program> program; /**< The program, nullptr on error */
+    vector<string> variableNames; /**< Variables in the order of the slots */
+    uint32_t expressionError; /**< Error num in the infix notation */
+    uint32_t reversePolishError; /**< Error num in the RP notation */
+    string errorString; /**< Description of the error */
+};
+
 /**
  * @brief The export point of this library.
  * @details Class is used to be implemented by other class internal to the
@@ -191,10 +234,15 @@ public:
     virtual ~MathParser() = 0;
 
     static MathParser *makeMathParser();
+    static vector<CompiledExpression> compileAll(
+            const vector<string> &a_expressions,
+            ThreadPool *a_pool = nullptr);
+    virtual MathParser *clone() const = 0;
 
     virtual const string expression() const = 0;
     virtual void setExpression(const string &a_expression) = 0;
     virtual void setMath(const string &a_expression) = 0;
+    virtual CompiledExpression compile(const string &a_expression) = 0;
     virtual const string reversePolish() const = 0;
     virtual bool setArgumentMap(const string &a_reversePolish) = 0;
     virtual bool setArgumentMap() = 0;
@@ -205,9 +253,43 @@ public:
                                    const double a_value) = 0;
     virtual bool expandMathExpression() = 0;
     virtual double calculateExpression() = 0;
+    virtual void calculateBatch(const double *const *a_variables,
+                                double *a_results,
+                                const size_t a_size) = 0;
+    virtual void calculateBatchParallel(const double *const *a_variables,
+                                        double *a_results,
+                                        const size_t a_size,
+                                        ThreadPool *a_pool = nullptr) = 0;
+    virtual size_t calculateBatch(const double *const *a_variables,
+                                  double *a_results,
+                                  const size_t a_size,
+                                  const BatchControl &a_control) = 0;
+    virtual size_t calculateBatchParallel(const double *const *a_variables,
+                                          double *a_results,
+                                          const size_t a_size,
+                                          const BatchControl &a_control,
+                                          ThreadPool *a_pool = nullptr) = 0;
+    virtual future<void> calculateBatchAsync(
+            const double *const *a_variables,
+            double *a_results,
+            const size_t a_size,
+            ThreadPool *a_pool = nullptr) = 0;
+    virtual void calculateBatchAsync(const double *const *a_variables,
+                                     double *a_results,
+                                     const size_t a_size,
+                                     const ThreadPool::Callback &a_callback,
+                                     ThreadPool *a_pool = nullptr) = 0;
+    virtual const string batchSource(const string &a_functionName) = 0;
+    virtual CompiledFunction compiledFunction() = 0;
+    virtual shared_ptr<const Program> program() = 0;
+    virtual bool setBackend(const EvaluationBackend a_backend) = 0;
+    virtual EvaluationBackend backend() const = 0;
+    virtual void setResultMemo(const size_t a_capacity) = 0;
+    virtual MemoTable::Statistics resultMemoStatistics() const = 0;
     virtual void setMathPrintPrecision(const uint16_t &mathPrintPrecision) = 0;
     virtual uint16_t getMathPrintPrecision() const = 0;
     virtual uint16_t getVariableSize() const = 0;
+    virtual const string getVariableName(const uint16_t a_index) const = 0;
     virtual void clear() = 0;
 };
 
@@ -223,8 +305,14 @@ class MathExpression : public MathParser
 public:
 
     MathExpression();
+    MathExpression(const MathExpression &a_other);
+    MathExpression(MathExpression &&a_other) noexcept;
     ~MathExpression();
 
+    MathExpression &operator=(const MathExpression &a_other);
+    MathExpression &operator=(MathExpression &&a_other) noexcept;
+    MathParser *clone() const;
+
     static vector<char> specialChars; /**< Special characters */
     static unordered_map<string, Operator> operatorMap; /**< Defined operators */
     static unordered_map<string, Argument> constantMap; /**< Defined constants */
@@ -241,11 +329,14 @@ public:
             double a_arg1,
             double a_arg2,
             const string &a_operatorKey);
+    static const string operatorName(const Instruction &a_instruction,
+                                     const bool a_identifier = false);
 
     const string expression() const;
     void setExpression(const string &a_expression);
 
     void setMath(const string &a_expression);
+    CompiledExpression compile(const string &a_expression);
 
     const string reversePolish() const;
     bool setArgumentMap(const string &a_reversePolish);
@@ -254,6 +345,40 @@ public:
     bool expressionToReversePolish();
 
     double calculateExpression();
+    void calculateBatch(const double *const *a_variables,
+                        double *a_results,
+                        const size_t a_size);
+    void calculateBatchParallel(const double *const *a_variables,
+                                double *a_results,
+                                const size_t a_size,
+                                ThreadPool *a_pool = nullptr);
+    size_t calculateBatch(const double *const *a_variables,
+                          double *a_results,
+                          const size_t a_size,
+                          const BatchControl &a_control);
+    size_t calculateBatchParallel(const double *const *a_variables,
+                                  double *a_results,
+                                  const size_t a_size,
+                                  const BatchControl &a_control,
+                                  ThreadPool *a_pool = nullptr);
+    future<void> calculateBatchAsync(const double *const *a_variables,
+                                     double *a_results,
+                                     const size_t a_size,
+                                     ThreadPool *a_pool = nullptr);
+    void calculateBatchAsync(const double *const *a_variables,
+                             double *a_results,
+                             const size_t a_size,
+                             const ThreadPool::Callback &a_callback,
+                             ThreadPool *a_pool = nullptr);
+    const string batchSource(const string &a_functionName);
+    CompiledFunction compiledFunction();
+    shared_ptr<const Program> program();
+
+    bool setBackend(const EvaluationBackend a_backend);
+    EvaluationBackend backend() const;
+
+    void setResultMemo(const size_t a_capacity);
+    MemoTable::Statistics resultMemoStatistics() const;
 
     uint32_t reversePolishErrorNum();
     const string reversePolishErrorString();
@@ -274,6 +399,7 @@ public:
     void setVariableDouble(const string &a_name, const double a_value);
 
     uint16_t getVariableSize() const;
+    const string getVariableName(const uint16_t a_index) const;
 
 private:
     size_t operatorMapSize();
@@ -297,12 +423,15 @@ private:
     const Operator *getOperator(const string &a_key) const;
     Generator *getGenerator(const string &a_key);
     const Argument *getArgument(const string &a_key) const;
-    uint16_t getEntitySize(EntityType a_entityType) const;
+    uint32_t getEntitySize(EntityType a_entityType) const;
     EntityType entityType(const string &a_key) const;
     void setDoubleValueToArgument(const string &a_key, const double a_value);
-    const string createNewUserConstantName() const;
+    const string createNewUserConstantName();
     bool pushToReversePolish(const string &a_str, const char &a_char);
     void appendToReversePolishString(const string &a_str);
+    bool compileProgram();
+    void compileNative();
+    double runProgram(double *a_values) const;
 
     uint32_t m_reversePolishError; /**< Error num in the RP notation */
     string m_reversePolishErrorString; /**< Error string in the RP notation */
@@ -315,8 +444,120 @@ private:
     vector<Generator> m_generatorVec;/**< Vector of generators */
     vector<string> m_math; /**< The expression in entities */
     vector<string> m_RPstack; /**< Stack for the Shunting-yard algorithm */
+    vector<string> m_variableNames; /**< Variables in order of appearance */
+    uint32_t m_userConstantCount; /**< Names made for internal arguments */
+    bool m_compiled; /**< The program is built from the generators */
+    InstructionStream m_instructions; /**< Compiled program, shared */
+    vector<double> m_values; /**< Slots of the compiled program */
+    unordered_map<string, uint32_t> m_slotMap; /**< Argument name to slot */
+    uint32_t m_resultSlot; /**< Slot holding the result of the program */
+    EvaluationBackend m_backend; /**< Backend requested by the user */
+    shared_ptr<NativeFunction> m_native; /**< Native code of the program */
+    shared_ptr<const Program> m_program; /**< Shared copy of the program */
+    shared_ptr<const LevelSchedule> m_schedule; /**< Levels of the program */
+    shared_ptr<const IncrementalSchedule> m_incremental; /**< Dependents */
+    vector<uint32_t> m_changed; /**< Variables changed since calculation */
+    bool m_calculated; /**< The slots hold the previous calculation */
+    size_t m_resultMemoCapacity; /**< Entries of the memo, 0 if disabled */
+    shared_ptr<MemoTable> m_resultMemo; /**< Results by the variables */
 };
 
 }
 
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#include <coroutine>
+
+namespace PssMathParser {
+
+/**
+ * @brief Batch calculation for `co_await` in C++20 coroutines
+ * @details Made by calculateBatchAwaitable(). The coroutine is suspended while
+ * MathParser::calculateBatchAsync() runs and it is resumed on the worker that
+ * finished the last row. An exception of the calculation is thrown from the
+ * `co_await`. Only in the header, so the library itself needs only C++11.
+ */
+class BatchAwaitable {
+public:
+    /**
+     * @brief Constructor, nothing is calculated before `co_await`
+     */
+    BatchAwaitable(MathParser &a_parser,
+                   const double *const *a_variables,
+                   double *a_results,
+                   const size_t a_size,
+                   ThreadPool *a_pool):
+        m_parser(a_parser),
+        m_variables(a_variables),
+        m_results(a_results),
+        m_size(a_size),
+        m_pool(a_pool)
+    {
+    }
+
+    /**
+     * @brief An empty batch doesn't suspend
+     */
+    bool await_ready() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    /**
+     * @brief Starts the calculation, the callback resumes the coroutine
+     */
+    void await_suspend(coroutine_handle<> a_handle)
+    {
+        m_parser.calculateBatchAsync(
+                    m_variables, m_results, m_size,
+                    [this, a_handle](exception_ptr a_error) {
+            m_error = a_error;
+            a_handle.resume();
+        }, m_pool);
+    }
+
+    /**
+     * @brief Throws the exception of the calculation
+     */
+    void await_resume() const
+    {
+        if (m_error)
+            rethrow_exception(m_error);
+    }
+
+private:
+    MathParser &m_parser; /**< The calculated expression */
+    const double *const *m_variables; /**< The variable columns */
+    double *m_results; /**< The results */
+    size_t m_size; /**< Number of rows */
+    ThreadPool *m_pool; /**< The workers */
+    exception_ptr m_error; /**< Exception of the calculation */
+};
+
+/**
+ * @brief calculateBatch() for `co_await`
+ * @details
+ *
+ * ```c++
+ * co_await calculateBatchAwaitable(*mp, columns, results, size);
+ * ```
+ *
+ * @param a_parser The calculated expression
+ * @param a_variables Array of getVariableSize() columns of a_size values
+ * @param a_results Array of a_size values for the results
+ * @param a_size Number of rows
+ * @param a_pool The pool of threads, nullptr for ThreadPool::instance()
+ * @return **BatchAwaitable** The awaitable calculation
+ */
+inline BatchAwaitable calculateBatchAwaitable(MathParser &a_parser,
+                                              const double *const *a_variables,
+                                              double *a_results,
+                                              const size_t a_size,
+                                              ThreadPool *a_pool = nullptr)
+{
+    return BatchAwaitable(a_parser, a_variables, a_results, a_size, a_pool);
+}
+
+}
+#endif
+
 #endif // PSSMATHPARSER_H
@@ -0,0 +1,685 @@
+/**
+ *  @file pssmathprocess.cpp
+ *  @brief Calculation in worker processes of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathprocess.h"
+#include "pssmathparser.h"
+#include <atomic>
+#include <climits>
+#include <new>
+#include <string.h>
+#include <thread>
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace PssMathParser {
+
+/**
+ * @brief Enum defines what the workers do on a new job
+ */
+enum class ProcessCommand : uint32_t {
+    Run,
+    Exit
+};
+
+/**
+ * @brief State of one worker in the control block, on its own cache line
+ */
+struct WorkerSlot {
+    atomic<uint32_t> done; /**< Last job the worker finished */
+    atomic<uint32_t> counted; /**< Last job taken from the pending count */
+    atomic<uint32_t> error; /**< Last job the worker couldn't calculate */
+    char padding[64 - 3 * sizeof(atomic<uint32_t>)];
+};
+
+/**
+ * @brief Block shared by the caller and the workers, the slots of the
+ * workers follow it
+ */
+struct ProcessControl {
+    atomic<uint32_t> job; /**< Futex of the workers, counts the jobs */
+    atomic<uint32_t> pending; /**< Futex of the caller, workers not done */
+    ProcessCommand command; /**< What the workers do on the job */
+    uint32_t columns; /**< Columns reserved in the data region */
+    uint64_t stride; /**< Rows of every column in the data region */
+    uint64_t rows; /**< Rows of the job */
+    uint64_t programSize; /**< Bytes of the serialized program */
+    uint32_t programVersion; /**< Changes with every sent program */
+};
+
+/**
+ * @brief One mapping of shared memory, inherited by the forked workers
+ */
+struct SharedRegion {
+    SharedRegion();
+    ~SharedRegion();
+
+    bool create(const size_t a_size);
+
+    char *data; /**< Start of the mapping */
+    size_t size; /**< Bytes of the mapping */
+};
+
+}
+
+using namespace PssMathParser;
+
+namespace {
+
+static_assert(sizeof(ProcessControl) <= 64, "ProcessControl is one line");
+static_assert(sizeof(WorkerSlot) == 64, "WorkerSlot is one line");
+static_assert(sizeof(atomic<uint32_t>) == sizeof(uint32_t),
+              "Futex words are plain integers");
+
+/**
+ * @brief Beginning of the serialized program
+ */
+struct WireHeader {
+    uint32_t instructionSize; /**< Number of instructions */
+    uint32_t valueSize; /**< Number of slots */
+    uint32_t variableSize; /**< Number of variables */
+    uint32_t resultSlot; /**< Slot of the result */
+    uint32_t nameSize; /**< Bytes of the function names */
+    uint32_t reserved; /**< Keeps the instructions aligned */
+};
+
+/**
+ * @brief Serialized instruction, the function is the offset of its name
+ */
+struct WireInstruction {
+    uint32_t code; /**< The OpCode */
+    uint32_t arg1; /**< Slot of the first argument */
+    uint32_t arg2; /**< Slot of the second argument */
+    uint32_t result; /**< Slot of the generated argument */
+    uint32_t function; /**< Offset of the name or UINT32_MAX */
+    uint32_t reserved; /**< Keeps the values aligned */
+};
+
+/**
+ * @brief Writes the program without pointers, the functions by their names
+ * @return **bool** false if a function has no name
+ */
+bool serialize(const Program &a_program, vector<char> &a_bytes)
+{
+    const vector<Instruction> &instructions = a_program.instructions();
+    const vector<double> &values = a_program.values();
+    vector<WireInstruction> wire(instructions.size());
+    string names;
+    unordered_map<string, uint32_t> offsets;
+    for (size_t i = 0; i < instructions.size(); i++) {
+        const Instruction &ins = instructions[i];
+        wire[i].code = uint32_t(ins.code);
+        wire[i].arg1 = ins.arg1;
+        wire[i].arg2 = ins.arg2;
+        wire[i].result = ins.result;
+        wire[i].function = UINT32_MAX;
+        wire[i].reserved = 0;
+        if (ins.code != OpCode::CallOneArg && ins.code != OpCode::CallTwoArg)
+            continue;
+        const string name = MathExpression::operatorName(ins);
+        if (name.empty())
+            return false;
+        if (offsets.count(name) == 0) {
+            offsets[name] = uint32_t(names.size());
+            names += name;
+            names += '\0';
+        }
+        wire[i].function = offsets[name];
+    }
+    WireHeader header = { uint32_t(instructions.size()),
+                          uint32_t(values.size()),
+                          a_program.variableSize(),
+                          a_program.resultSlot(),
+                          uint32_t(names.size()), 0 };
+    a_bytes.resize(sizeof(header) + wire.size() * sizeof(WireInstruction)
+                   + values.size() * sizeof(double) + names.size());
+    char *out = a_bytes.data();
+    memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    memcpy(out, wire.data(), wire.size() * sizeof(WireInstruction));
+    out += wire.size() * sizeof(WireInstruction);
+    memcpy(out, values.data(), values.size() * sizeof(double));
+    out += values.size() * sizeof(double);
+    memcpy(out, names.data(), names.size());
+    return true;
+}
+
+/**
+ * @brief Makes the program from serialize(), the functions are found in the
+ * operatorMap
+ * @return **shared_ptr<const Program>** The program, nullptr if it is broken
+ */
+shared_ptr<const Program> deserialize(const char *a_bytes, const size_t a_size)
+{
+    WireHeader header;
+    if (a_size < sizeof(header))
+        return nullptr;
+    memcpy(&header, a_bytes, sizeof(header));
+    const size_t instructionBytes =
+            size_t(header.instructionSize) * sizeof(WireInstruction);
+    const size_t valueBytes = size_t(header.valueSize) * sizeof(double);
+    if (a_size != sizeof(header) + instructionBytes + valueBytes
+            + header.nameSize)
+        return nullptr;
+    const char *in = a_bytes + sizeof(header);
+    vector<WireInstruction> wire(header.instructionSize);
+    memcpy(wire.data(), in, instructionBytes);
+    in += instructionBytes;
+    vector<double> values(header.valueSize);
+    memcpy(values.data(), in, valueBytes);
+    in += valueBytes;
+    const string names(in, header.nameSize);
+
+    vector<Instruction> instructions(wire.size());
+    for (size_t i = 0; i < wire.size(); i++) {
+        Instruction &ins = instructions[i];
+        ins.code = OpCode(wire[i].code);
+        ins.arg1 = wire[i].arg1;
+        ins.arg2 = wire[i].arg2;
+        ins.result = wire[i].result;
+        ins.ddFunction = nullptr;
+        ins.dddFunction = nullptr;
+        if (wire[i].function == UINT32_MAX)
+            continue;
+        if (wire[i].function >= names.size())
+            return nullptr;
+        auto iop = MathExpression::operatorMap.find(
+                    string(names.c_str() + wire[i].function));
+        if (iop == MathExpression::operatorMap.end())
+            return nullptr;
+        ins.ddFunction = iop->second.ddFunction();
+        ins.dddFunction = iop->second.dddFunction();
+    }
+    return make_shared<const Program>(instructions, values,
+                                      header.variableSize, header.resultSlot);
+}
+
+/**
+ * @brief Slot of the worker in the control block
+ */
+WorkerSlot &workerSlot(ProcessControl *a_control, const unsigned a_index)
+{
+    return reinterpret_cast<WorkerSlot *>(
+                reinterpret_cast<char *>(a_control) + 64)[a_index];
+}
+
+/**
+ * @brief Rows of the worker, the shards are multiples of one cache line
+ */
+ProcessPool::Shard shardOf(const unsigned a_index, const unsigned a_workers,
+                           const size_t a_rows)
+{
+    size_t shard = (a_rows + a_workers - 1) / a_workers;
+    shard = (shard + 7) / 8 * 8;
+    const size_t begin = min(a_rows, a_index * shard);
+    return ProcessPool::Shard(begin, min(a_rows, begin + shard));
+}
+
+#ifdef __linux__
+/**
+ * @brief Sleeps while the futex word has the value
+ * @param a_timeout Longest sleep, nullptr for no limit
+ */
+void futexWait(atomic<uint32_t> *a_word, const uint32_t a_value,
+               const timespec *a_timeout)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(a_word), FUTEX_WAIT,
+            a_value, a_timeout, nullptr, 0);
+}
+
+/**
+ * @brief Wakes the processes sleeping on the futex word
+ */
+void futexWake(atomic<uint32_t> *a_word, const int a_count)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(a_word), FUTEX_WAKE,
+            a_count, nullptr, nullptr, 0);
+}
+#endif
+
+atomic<unsigned> regionCount(0); /**< Makes the names of the regions */
+
+}
+
+/**
+ * @brief Constructor of an empty region
+ */
+SharedRegion::SharedRegion():
+    data(nullptr),
+    size(0)
+{
+}
+
+/**
+ * @brief Destructor, unmaps the memory
+ */
+SharedRegion::~SharedRegion()
+{
+#ifdef __linux__
+    if (data != nullptr)
+        munmap(data, size);
+#else
+    delete[] data;
+#endif
+}
+
+/**
+ * @brief Maps a new POSIX shared memory object of the size
+ * @details The name is removed at once, the memory is reached only through
+ * the mapping and the forks of this process.
+ * @return **bool** false if it can't be made
+ */
+bool SharedRegion::create(const size_t a_size)
+{
+#ifdef __linux__
+    const string name = "/pssmathparser-" + to_string(getpid()) + "-"
+            + to_string(regionCount++);
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+        return false;
+    shm_unlink(name.c_str());
+    void *memory = MAP_FAILED;
+    if (ftruncate(fd, off_t(a_size)) == 0) {
+        memory = mmap(nullptr, a_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd, 0);
+    }
+    close(fd);
+    if (memory == MAP_FAILED)
+        return false;
+    data = static_cast<char *>(memory);
+#else
+    data = new (nothrow) char[a_size]();
+    if (data == nullptr)
+        return false;
+#endif
+    size = a_size;
+    return true;
+}
+
+/**
+ * @brief Constructor, makes the control block
+ * @details The workers are forked on the first calculation.
+ * @param a_size Number of workers, 0 for one worker for every core
+ */
+ProcessPool::ProcessPool(unsigned a_size):
+    m_size(a_size != 0 ? a_size : max(1u, thread::hardware_concurrency())),
+    m_pids(m_size, 0),
+    m_controlRegion(new SharedRegion),
+    m_control(nullptr),
+    m_columns(0),
+    m_rows(0)
+{
+#ifdef __linux__
+    if (m_controlRegion->create(64 * (1 + size_t(m_size)))) {
+        m_control = new (m_controlRegion->data) ProcessControl();
+        for (unsigned i = 0; i < m_size; i++) {
+            new (&workerSlot(m_control, i)) WorkerSlot();
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Destructor, stops the workers
+ */
+ProcessPool::~ProcessPool()
+{
+    stopWorkers();
+}
+
+/**
+ * @brief Tells if the calculation runs in worker processes
+ */
+bool ProcessPool::isValid() const
+{
+    return m_control != nullptr;
+}
+
+/**
+ * @brief Return the number of workers
+ */
+unsigned ProcessPool::size() const
+{
+    return m_size;
+}
+
+/**
+ * @brief Process ids of the workers, 0 for the workers that don't run
+ */
+vector<int> ProcessPool::processIds() const
+{
+    return m_pids;
+}
+
+/**
+ * @brief Makes the shared columns and results for at least the rows
+ * @details The values in the columns are not kept if the memory grows. Then
+ * the running workers are stopped and forked again on the next calculation.
+ * @param a_columns Number of the variable columns
+ * @param a_rows Number of rows in every column
+ * @return **bool** false if the shared memory can't be made
+ */
+bool ProcessPool::reserve(const uint32_t a_columns, const size_t a_rows)
+{
+    const size_t stride = (a_rows + 7) / 8 * 8;
+    const size_t bytes = (size_t(a_columns) + 1) * stride * sizeof(double);
+    if (!m_data || m_data->size < bytes) {
+        stopWorkers();
+        m_data.reset(new SharedRegion);
+        if (m_data->create(max<size_t>(bytes, 64)) == false) {
+            m_data.reset();
+            m_columns = 0;
+            m_rows = 0;
+            return false;
+        }
+    }
+    m_columns = a_columns;
+    m_rows = stride;
+    return true;
+}
+
+/**
+ * @brief Shared column of the variable, reserve() rows long
+ */
+double *ProcessPool::column(const uint32_t a_index)
+{
+    return reinterpret_cast<double *>(m_data->data) + a_index * m_rows;
+}
+
+/**
+ * @brief Shared results, reserve() rows long
+ */
+double *ProcessPool::results()
+{
+    return column(m_columns);
+}
+
+/**
+ * @brief Calculates the first rows of the shared columns in the workers
+ * @details Every worker calculates its shard of the rows into results(). The
+ * call returns when all the workers are done or dead.
+ * @param a_program The compiled program, its variables are the first columns
+ * @param a_size Number of rows, not more than reserve()
+ * @return **bool** false if some shards are not calculated, see
+ * failedShards()
+ */
+bool ProcessPool::calculateBatch(const shared_ptr<const Program> &a_program,
+                                 const size_t a_size)
+{
+    m_failed.clear();
+    if (a_size == 0)
+        return true;
+    if (!m_data || a_size > m_rows || a_program->variableSize() > m_columns
+            || sendProgram(a_program) == false) {
+        m_failed.push_back(Shard(0, a_size));
+        return false;
+    }
+    vector<const double *> variables(a_program->variableSize());
+    for (uint32_t j = 0; j < variables.size(); j++) {
+        variables[j] = column(j);
+    }
+    if (isValid() == false) {
+        EvaluationContext context(a_program);
+        context.calculateBatch(variables.data(), results(), a_size);
+        return true;
+    }
+#ifdef __linux__
+    startWorkers();
+    ProcessControl &control = *m_control;
+    const uint32_t job = control.job.load() + 1;
+    uint32_t running = 0;
+    for (unsigned i = 0; i < m_size; i++) {
+        if (m_pids[i] != 0)
+            running++;
+        else
+            workerSlot(m_control, i).counted.store(job);
+    }
+    control.command = ProcessCommand::Run;
+    control.columns = m_columns;
+    control.stride = m_rows;
+    control.rows = a_size;
+    control.pending.store(running);
+    control.job.store(job);
+    futexWake(&control.job, INT_MAX);
+
+    // Waits for the workers and looks for the dead ones
+    while (true) {
+        uint32_t pending = control.pending.load();
+        if (pending == 0)
+            break;
+        timespec timeout = { 0, 20000000 };
+        futexWait(&control.pending, pending, &timeout);
+        for (unsigned i = 0; i < m_size; i++) {
+            int status;
+            if (m_pids[i] == 0 || waitpid(m_pids[i], &status, WNOHANG) <= 0)
+                continue;
+            m_pids[i] = 0;
+            if (workerSlot(m_control, i).counted.exchange(job) != job)
+                control.pending.fetch_sub(1);
+        }
+    }
+    for (unsigned i = 0; i < m_size; i++) {
+        const WorkerSlot &slot = workerSlot(m_control, i);
+        Shard shard = shardOf(i, m_size, a_size);
+        if (shard.first < shard.second
+                && (slot.done.load() != job || slot.error.load() == job))
+            m_failed.push_back(shard);
+    }
+#endif
+    return m_failed.empty();
+}
+
+/**
+ * @brief Calculates the columns of the caller in the workers
+ * @details The columns are copied to the shared memory and the results of
+ * the calculated shards are copied back, the failed shards of a_results are
+ * not written.
+ * @param a_program The compiled program
+ * @param a_variables Array of variableSize() columns of a_size values
+ * @param a_results Array of a_size values for the results
+ * @param a_size Number of rows
+ * @return **bool** false if some shards are not calculated, see
+ * failedShards()
+ */
+bool ProcessPool::calculateBatch(const shared_ptr<const Program> &a_program,
+                                 const double *const *a_variables,
+                                 double *a_results,
+                                 const size_t a_size)
+{
+    const uint32_t variableSize = a_program->variableSize();
+    if ((variableSize > m_columns || a_size > m_rows)
+            && reserve(variableSize, a_size) == false) {
+        m_failed.assign(1, Shard(0, a_size));
+        return false;
+    }
+    for (uint32_t j = 0; j < variableSize; j++) {
+        memcpy(column(j), a_variables[j], a_size * sizeof(double));
+    }
+    bool done = calculateBatch(a_program, a_size);
+    size_t begin = 0;
+    for (const Shard &failed : m_failed) {
+        memcpy(a_results + begin, results() + begin,
+               (failed.first - begin) * sizeof(double));
+        begin = failed.second;
+    }
+    memcpy(a_results + begin, results() + begin,
+           (a_size - begin) * sizeof(double));
+    return done;
+}
+
+/**
+ * @brief Shards of the last calculation that are not calculated
+ */
+const vector<ProcessPool::Shard> &ProcessPool::failedShards() const
+{
+    return m_failed;
+}
+
+/**
+ * @brief Writes the program to the shared memory if it is a new one
+ * @return **bool** false if the program can't be serialized
+ */
+bool ProcessPool::sendProgram(const shared_ptr<const Program> &a_program)
+{
+    if (m_sent == a_program)
+        return true;
+    vector<char> bytes;
+    if (serialize(*a_program, bytes) == false)
+        return false;
+    if (isValid() == false) {
+        m_sent = a_program;
+        return true;
+    }
+    if (!m_program || m_program->size < bytes.size()) {
+        stopWorkers();
+        m_program.reset(new SharedRegion);
+        if (m_program->create(max<size_t>(64 * 1024, 2 * bytes.size()))
+                == false) {
+            m_program.reset();
+            m_sent.reset();
+            return false;
+        }
+    }
+    memcpy(m_program->data, bytes.data(), bytes.size());
+    m_control->programSize = bytes.size();
+    m_control->programVersion++;
+    m_sent = a_program;
+    return true;
+}
+
+/**
+ * @brief Forks the workers that don't run
+ * @details The children get the shared regions with the fork and never return
+ * from here. They die with this process.
+ */
+void ProcessPool::startWorkers()
+{
+#ifdef __linux__
+    for (unsigned i = 0; i < m_size; i++) {
+        if (m_pids[i] != 0)
+            continue;
+        const uint32_t seen = m_control->job.load();
+        const pid_t pid = fork();
+        if (pid == 0) {
+            prctl(PR_SET_PDEATHSIG, SIGKILL);
+            runWorker(i, seen);
+            _exit(0);
+        }
+        if (pid > 0)
+            m_pids[i] = pid;
+    }
+#endif
+}
+
+/**
+ * @brief Tells the workers to exit and waits for them
+ * @details A worker that doesn't exit in one second is killed.
+ */
+void ProcessPool::stopWorkers()
+{
+#ifdef __linux__
+    if (m_control == nullptr
+            || count(m_pids.begin(), m_pids.end(), 0) == int(m_size))
+        return;
+    m_control->command = ProcessCommand::Exit;
+    m_control->job.fetch_add(1);
+    futexWake(&m_control->job, INT_MAX);
+    for (unsigned i = 0; i < m_size; i++) {
+        if (m_pids[i] == 0)
+            continue;
+        int status;
+        int waited = 0;
+        while (waitpid(m_pids[i], &status, WNOHANG) == 0) {
+            if (++waited == 100) {
+                kill(m_pids[i], SIGKILL);
+                waitpid(m_pids[i], &status, 0);
+                break;
+            }
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+        m_pids[i] = 0;
+    }
+#endif
+}
+
+/**
+ * @brief Loop of a worker process, calculates its shard of every job
+ * @param a_index Index of the worker
+ * @param a_seen The last job before the fork
+ */
+void ProcessPool::runWorker(const unsigned a_index, uint32_t a_seen)
+{
+#ifdef __linux__
+    ProcessControl &control = *m_control;
+    WorkerSlot &slot = workerSlot(m_control, a_index);
+    uint32_t programVersion = 0;
+    shared_ptr<const Program> program;
+    EvaluationContext context;
+    vector<const double *> variables;
+    while (true) {
+        const uint32_t job = control.job.load();
+        if (job == a_seen) {
+            futexWait(&control.job, job, nullptr);
+            continue;
+        }
+        a_seen = job;
+        if (control.command == ProcessCommand::Exit)
+            return;
+        if (control.programVersion != programVersion) {
+            programVersion = control.programVersion;
+            program = deserialize(m_program->data, control.programSize);
+            if (program)
+                context = EvaluationContext(program);
+        }
+        if (program && program->variableSize() <= control.columns) {
+            const Shard shard = shardOf(a_index, m_size, control.rows);
+            double *data = reinterpret_cast<double *>(m_data->data);
+            variables.resize(program->variableSize());
+            for (size_t j = 0; j < variables.size(); j++) {
+                variables[j] = data + j * control.stride + shard.first;
+            }
+            context.calculateBatch(variables.data(),
+                                   data + control.columns * control.stride
+                                   + shard.first,
+                                   shard.second - shard.first);
+        }
+        else {
+            slot.error.store(job);
+        }
+        slot.done.store(job);
+        if (slot.counted.exchange(job) != job
+                && control.pending.fetch_sub(1) == 1)
+            futexWake(&control.pending, 1);
+    }
+#else
+    (void)a_index;
+    (void)a_seen;
+#endif
+}
@@ -0,0 +1,109 @@
+/**
+ *  @file pssmathprocess.h
+ *  @brief Headers for the calculation in worker processes of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHPROCESS_H
+#define PSSMATHPROCESS_H
+
+#include "pssmathparser_global.h"
+#include "pssmathcore.h"
+#include <utility>
+
+namespace PssMathParser {
+
+struct ProcessControl;
+struct SharedRegion;
+
+/**
+ * @brief Batch calculation in forked worker processes
+ * @details A crash in a worker doesn't stop the program that uses the parser.
+ * The pool forks size() workers. The input columns and the results are in
+ * POSIX shared memory that the workers got with the fork, so every worker
+ * reads and writes its shard of the rows in place. The program is sent to
+ * the workers in a serialized form (the functions by their operator names)
+ * through a second shared region. The workers sleep on a futex in a shared
+ * control block and the last worker wakes the caller with another futex,
+ * no data goes through pipes.
+ *
+ * The workers calculate with the interpreter, native code is not sent. A
+ * worker that dies during a calculation is found while the caller waits, its
+ * shard is reported by failedShards() and the worker is forked again on the
+ * next call. When the shared memory grows, the workers are forked again so
+ * they get the new mapping.
+ *
+ * ```c++
+ * ProcessPool pool(4);
+ * pool.reserve(2, size); // then fill pool.column(0) and pool.column(1)
+ * if (pool.calculateBatch(mp->program(), size) == false)
+ *     recalculate(pool.failedShards());
+ * use(pool.results());
+ * ```
+ *
+ * A pool is used by one thread at a time. Works only on Linux, elsewhere
+ * isValid() is false and the calculation runs in the calling process.
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC ProcessPool {
+public:
+    typedef pair<size_t, size_t> Shard; /**< First row, one after the last */
+
+    explicit ProcessPool(unsigned a_size = 0);
+    ~ProcessPool();
+
+    ProcessPool(const ProcessPool &) = delete;
+    ProcessPool &operator=(const ProcessPool &) = delete;
+
+    bool isValid() const;
+    unsigned size() const;
+    vector<int> processIds() const;
+
+    bool reserve(const uint32_t a_columns, const size_t a_rows);
+    double *column(const uint32_t a_index);
+    double *results();
+
+    bool calculateBatch(const shared_ptr<const Program> &a_program,
+                        const size_t a_size);
+    bool calculateBatch(const shared_ptr<const Program> &a_program,
+                        const double *const *a_variables,
+                        double *a_results,
+                        const size_t a_size);
+    const vector<Shard> &failedShards() const;
+
+private:
+    bool sendProgram(const shared_ptr<const Program> &a_program);
+    void startWorkers();
+    void stopWorkers();
+    void runWorker(const unsigned a_index, uint32_t a_seen);
+
+    unsigned m_size; /**< Number of workers */
+    vector<int> m_pids; /**< Process ids of the workers, 0 if not running */
+    unique_ptr<SharedRegion> m_controlRegion; /**< Memory of m_control */
+    ProcessControl *m_control; /**< Shared control block */
+    unique_ptr<SharedRegion> m_data; /**< Shared columns and results */
+    unique_ptr<SharedRegion> m_program; /**< Shared serialized program */
+    uint32_t m_columns; /**< Columns in m_data */
+    size_t m_rows; /**< Rows of every column in m_data */
+    shared_ptr<const Program> m_sent; /**< Program in m_program */
+    vector<Shard> m_failed; /**< Shards of the last calculation not done */
+};
+
+}
+
+#endif // PSSMATHPROCESS_H
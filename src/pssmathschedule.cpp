@@ -0,0 +1,171 @@
+/**
+ *  @file pssmathschedule.cpp
+ *  @brief Parallel schedule of one compiled program
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathschedule.h"
+#include <algorithm>
+
+using namespace PssMathParser;
+
+namespace {
+
+/**
+ * @brief Fewest instructions of one job on a worker, one job takes a few
+ * microseconds, about as much as handing it to a worker
+ */
+const size_t minimumPart = 256;
+
+/**
+ * @brief Fewest instructions in the parallel levels, below this the program
+ * is run on the calling thread
+ */
+const size_t minimumParallel = 8 * minimumPart;
+
+}
+
+/**
+ * @brief Constructor, sorts the instructions by levels
+ * @param a_instructions The compiled program in the order of the generators
+ * @param a_resultSlot Slot of the result, UINT32_MAX if the result is zero
+ */
+LevelSchedule::LevelSchedule(const vector<Instruction> &a_instructions,
+                             const uint32_t a_resultSlot):
+    m_resultSlot(a_resultSlot),
+    m_levelSize(0),
+    m_maxWidth(0),
+    m_parallel(false)
+{
+    // Level of every instruction from the levels of the slots it reads
+    uint32_t slotSize = 0;
+    for (const Instruction &ins : a_instructions) {
+        slotSize = max(slotSize, max(ins.arg1, max(ins.arg2, ins.result)) + 1);
+    }
+    vector<uint32_t> slotLevel(slotSize, 0);
+    vector<uint32_t> levels;
+    levels.reserve(a_instructions.size());
+    for (const Instruction &ins : a_instructions) {
+        uint32_t level = slotLevel[ins.arg1];
+        if (ins.code != OpCode::CallOneArg)
+            level = max(level, slotLevel[ins.arg2]);
+        slotLevel[ins.result] = level + 1;
+        levels.push_back(level);
+        m_levelSize = max<size_t>(m_levelSize, level + 1);
+    }
+
+    // Stable counting sort by the level
+    vector<size_t> offsets(m_levelSize + 1, 0);
+    for (uint32_t level : levels) {
+        offsets[level + 1]++;
+    }
+    for (size_t l = 0; l < m_levelSize; l++) {
+        m_maxWidth = max(m_maxWidth, offsets[l + 1]);
+        offsets[l + 1] += offsets[l];
+    }
+    m_instructions.resize(a_instructions.size());
+    vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < a_instructions.size(); i++) {
+        m_instructions[next[levels[i]]++] = a_instructions[i];
+    }
+
+    // Wide levels are split on the workers, the rest is joined
+    size_t parallelSize = 0;
+    for (size_t l = 0; l < m_levelSize; l++) {
+        bool parallel = offsets[l + 1] - offsets[l] >= 2 * minimumPart;
+        if (parallel)
+            parallelSize += offsets[l + 1] - offsets[l];
+        if (m_segments.empty() || parallel || m_segments.back().parallel) {
+            m_segments.push_back({ offsets[l], offsets[l + 1], parallel });
+        }
+        else {
+            m_segments.back().end = offsets[l + 1];
+        }
+    }
+    m_parallel = parallelSize >= minimumParallel
+            && parallelSize * 2 >= m_instructions.size();
+}
+
+/**
+ * @brief Fewest instructions given to one worker
+ */
+size_t LevelSchedule::partSize()
+{
+    return minimumPart;
+}
+
+/**
+ * @brief Return the number of levels, the longest chain of instructions
+ */
+size_t LevelSchedule::levelSize() const
+{
+    return m_levelSize;
+}
+
+/**
+ * @brief Return the number of instructions in the widest level
+ */
+size_t LevelSchedule::maxWidth() const
+{
+    return m_maxWidth;
+}
+
+/**
+ * @brief Tells if run() uses the workers
+ * @details The workers are used when at least half of the instructions are in
+ * wide levels and there are enough of them to pay for waking the workers.
+ */
+bool LevelSchedule::isParallel() const
+{
+    return m_parallel;
+}
+
+/**
+ * @brief Calculates the program once
+ * @param a_values The slots of the program with the variables set
+ * @param a_pool The workers for the wide levels
+ * @return **double** Value of the result slot
+ */
+double LevelSchedule::run(double *a_values, ThreadPool &a_pool) const
+{
+    const Instruction *instructions = m_instructions.data();
+    if (m_parallel == false || a_pool.size() == 1) {
+        return Program::run(instructions, m_instructions.size(), a_values,
+                            m_resultSlot);
+    }
+    const size_t maxParts = 4 * a_pool.size();
+    for (const Segment &segment : m_segments) {
+        const size_t size = segment.end - segment.begin;
+        if (segment.parallel == false) {
+            Program::run(instructions + segment.begin, size, a_values,
+                         UINT32_MAX);
+            continue;
+        }
+        const size_t parts = min(maxParts, size / minimumPart);
+        a_pool.parallelFor(parts, [&](size_t a_part, unsigned) {
+            const size_t begin = segment.begin + a_part * size / parts;
+            const size_t end = segment.begin + (a_part + 1) * size / parts;
+            Program::run(instructions + begin, end - begin, a_values,
+                         UINT32_MAX);
+        });
+    }
+    if (m_resultSlot == UINT32_MAX)
+        return 0.0;
+    return a_values[m_resultSlot];
+}
@@ -0,0 +1,76 @@
+/**
+ *  @file pssmathschedule.h
+ *  @brief Headers for the parallel schedule of one compiled program
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHSCHEDULE_H
+#define PSSMATHSCHEDULE_H
+
+#include "pssmaththreadpool.h"
+
+namespace PssMathParser {
+
+/**
+ * @brief The compiled program ordered in levels that can run in parallel
+ * @details Every slot is written by one instruction only, so the program is a
+ * graph of the instructions. The level of an instruction is one more than the
+ * highest level of the instructions that write its arguments, the variables
+ * and constants are on level zero. The instructions of one level don't depend
+ * on each other and are calculated on the workers of a ThreadPool, split in
+ * parts of at least partSize() instructions. Levels that are too narrow are
+ * run on the calling thread together with their neighbours.
+ *
+ * Small programs are always run on the calling thread, because waking the
+ * workers costs more than the whole calculation, see isParallel(). Only the
+ * order of independent instructions differs from the interpreter.
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC LevelSchedule {
+public:
+    LevelSchedule(const vector<Instruction> &a_instructions,
+                  const uint32_t a_resultSlot);
+
+    static size_t partSize();
+
+    size_t levelSize() const;
+    size_t maxWidth() const;
+    bool isParallel() const;
+    double run(double *a_values, ThreadPool &a_pool) const;
+
+private:
+    /**
+     * @brief Neighbouring instructions that are run in one way
+     */
+    struct Segment {
+        size_t begin; /**< First instruction */
+        size_t end; /**< One after the last instruction */
+        bool parallel; /**< Split on the workers */
+    };
+
+    vector<Instruction> m_instructions; /**< Instructions ordered by level */
+    vector<Segment> m_segments; /**< The runs of the levels */
+    uint32_t m_resultSlot; /**< Slot of the result, UINT32_MAX for zero */
+    size_t m_levelSize; /**< Number of levels */
+    size_t m_maxWidth; /**< Instructions in the widest level */
+    bool m_parallel; /**< The workers are used */
+};
+
+}
+
+#endif // PSSMATHSCHEDULE_H
@@ -0,0 +1,299 @@
+/**
+ *  @file pssmathshare.cpp
+ *  @brief Sharing the instructions of equal compiled programs
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathshare.h"
+#include <algorithm>
+
+using namespace PssMathParser;
+
+namespace {
+
+/** @brief Slot or instruction that doesn't exist */
+const uint32_t NoSlot = UINT32_MAX;
+
+/**
+ * @brief Adds a value to a hash
+ * @param a_hash The hash so far
+ * @param a_value The added value
+ * @return **uint64_t** The new hash
+ */
+uint64_t mix(uint64_t a_hash, const uint64_t a_value)
+{
+    a_hash ^= a_value + 0x9e3779b97f4a7c15ULL + (a_hash << 6) + (a_hash >> 2);
+    a_hash ^= a_hash >> 31;
+    a_hash *= 0xbf58476d1ce4e5b9ULL;
+    a_hash ^= a_hash >> 27;
+    return a_hash;
+}
+
+/**
+ * @brief Tells if the operands of the instruction can be swapped
+ */
+bool isCommutative(const OpCode a_code)
+{
+    return a_code == OpCode::Add || a_code == OpCode::Multiply;
+}
+
+/**
+ * @brief Compares all the fields of two instructions
+ */
+bool isEqual(const Instruction &a_first, const Instruction &a_second)
+{
+    return a_first.code == a_second.code
+            && a_first.arg1 == a_second.arg1
+            && a_first.arg2 == a_second.arg2
+            && a_first.result == a_second.result
+            && a_first.ddFunction == a_second.ddFunction
+            && a_first.dddFunction == a_second.dddFunction;
+}
+
+}
+
+/**
+ * @brief Constructor of an empty pool
+ */
+InstructionPool::InstructionPool():
+    m_interned(0)
+{
+}
+
+/**
+ * @brief The pool of the process, used by every MathExpression
+ */
+InstructionPool &InstructionPool::instance()
+{
+    static InstructionPool pool;
+    return pool;
+}
+
+/**
+ * @brief Rewrites the program in the canonical form
+ * @details The variables keep their slots. The other slots are renumbered in
+ * the order of a depth first walk from the result slot, in which the operands
+ * of OpCode::Add and OpCode::Multiply are visited in the order of their
+ * structural hashes. The constants only count as constants, their values
+ * don't change the instructions. Slots that the walk doesn't reach are
+ * numbered last, in their old order.
+ *
+ * Programs that aren't a DAG in the parser's form (a slot written twice, an
+ * argument written after it is read, an instruction not used by the result)
+ * are not changed.
+ * @param a_instructions The program, replaced by the canonical program
+ * @param a_slots Filled with the new slot of every old slot
+ * @param a_slotSize Number of slots of the program
+ * @param a_variableSize Number of variables, the first slots
+ * @param a_resultSlot Slot of the result
+ * @return **true** The program and a_slots are changed
+ * @return **false** The program can't be made canonical, nothing changed
+ */
+bool InstructionPool::canonicalize(vector<Instruction> &a_instructions,
+                                   vector<uint32_t> &a_slots,
+                                   const uint32_t a_slotSize,
+                                   const uint32_t a_variableSize,
+                                   const uint32_t a_resultSlot)
+{
+    if (a_instructions.empty() || a_resultSlot >= a_slotSize)
+        return false;
+
+    // Which instruction writes every slot, the reads must come after it
+    vector<uint32_t> writer(a_slotSize, NoSlot);
+    for (size_t i = 0; i < a_instructions.size(); i++) {
+        const Instruction &ins = a_instructions[i];
+        if (ins.result >= a_slotSize || ins.result < a_variableSize
+                || writer[ins.result] != NoSlot)
+            return false;
+        writer[ins.result] = uint32_t(i);
+    }
+    for (size_t i = 0; i < a_instructions.size(); i++) {
+        const Instruction &ins = a_instructions[i];
+        bool oneArg = ins.code == OpCode::CallOneArg;
+        if (ins.arg1 >= a_slotSize
+                || (writer[ins.arg1] != NoSlot && writer[ins.arg1] >= i))
+            return false;
+        if (oneArg == false && (ins.arg2 >= a_slotSize
+                || (writer[ins.arg2] != NoSlot && writer[ins.arg2] >= i)))
+            return false;
+    }
+    if (writer[a_resultSlot] == NoSlot)
+        return false;
+
+    // Structural hash of the value of every slot
+    vector<uint64_t> hash(a_slotSize, mix(2, 0));
+    for (uint32_t v = 0; v < a_variableSize; v++)
+        hash[v] = mix(1, v);
+    for (const Instruction &ins : a_instructions) {
+        uint64_t first = hash[ins.arg1];
+        uint64_t second = ins.code == OpCode::CallOneArg ? 0 : hash[ins.arg2];
+        if (isCommutative(ins.code) && second < first)
+            swap(first, second);
+        uint64_t h = mix(3, uint64_t(ins.code));
+        h = mix(h, uint64_t(uintptr_t(ins.ddFunction)));
+        h = mix(h, uint64_t(uintptr_t(ins.dddFunction)));
+        hash[ins.result] = mix(mix(h, first), second);
+    }
+
+    // Depth first walk, an instruction is added after its operands
+    vector<uint32_t> slots(a_slotSize, NoSlot);
+    for (uint32_t v = 0; v < a_variableSize; v++)
+        slots[v] = v;
+    uint32_t nextSlot = a_variableSize;
+    vector<Instruction> canonical;
+    canonical.reserve(a_instructions.size());
+    vector<uint8_t> state(a_slotSize, 0); // 0 new, 1 open, 2 done
+    vector<uint32_t> stack(1, a_resultSlot);
+    while (stack.empty() == false) {
+        uint32_t slot = stack.back();
+        if (state[slot] == 2) {
+            stack.pop_back();
+            continue;
+        }
+        if (writer[slot] == NoSlot) {
+            if (slots[slot] == NoSlot)
+                slots[slot] = nextSlot++;
+            state[slot] = 2;
+            stack.pop_back();
+            continue;
+        }
+        const Instruction &ins = a_instructions[writer[slot]];
+        bool oneArg = ins.code == OpCode::CallOneArg;
+        uint32_t first = ins.arg1;
+        uint32_t second = ins.arg2;
+        if (isCommutative(ins.code) && hash[second] < hash[first])
+            swap(first, second);
+        if (state[slot] == 0) {
+            state[slot] = 1;
+            if (oneArg == false)
+                stack.push_back(second);
+            stack.push_back(first);
+            continue;
+        }
+        Instruction out = ins;
+        out.arg1 = slots[first];
+        out.arg2 = oneArg ? 0 : slots[second];
+        slots[slot] = nextSlot++;
+        out.result = slots[slot];
+        canonical.push_back(out);
+        state[slot] = 2;
+        stack.pop_back();
+    }
+    if (canonical.size() != a_instructions.size())
+        return false;
+
+    for (uint32_t &slot : slots) {
+        if (slot == NoSlot)
+            slot = nextSlot++;
+    }
+    a_instructions.swap(canonical);
+    a_slots.swap(slots);
+    return true;
+}
+
+/**
+ * @brief Hash of the instructions, equal for equal instructions
+ * @details The functions are hashed by their address, so the hash is only
+ * meaningful inside one process.
+ * @param a_instructions The program
+ * @return **uint64_t** The hash
+ */
+uint64_t InstructionPool::structuralHash(
+        const vector<Instruction> &a_instructions)
+{
+    uint64_t h = mix(4, a_instructions.size());
+    for (const Instruction &ins : a_instructions) {
+        h = mix(h, uint64_t(ins.code));
+        h = mix(h, ins.arg1);
+        h = mix(h, ins.arg2);
+        h = mix(h, ins.result);
+        h = mix(h, uint64_t(uintptr_t(ins.ddFunction)));
+        h = mix(h, uint64_t(uintptr_t(ins.dddFunction)));
+    }
+    return h;
+}
+
+/**
+ * @brief The shared stream of the instructions
+ * @details Returns the stream held by another program if its instructions are
+ * equal, or a new stream that the next equal programs will share. Call it
+ * with canonical instructions to share the equivalent programs too.
+ * @param a_instructions The program
+ * @return **InstructionStream** The shared instructions
+ */
+InstructionStream InstructionPool::intern(
+        const vector<Instruction> &a_instructions)
+{
+    uint64_t hash = structuralHash(a_instructions);
+    lock_guard<mutex> lock(m_mutex);
+    auto range = m_streams.equal_range(hash);
+    for (auto istream = range.first; istream != range.second; ) {
+        InstructionStream stream = istream->second.lock();
+        if (stream == nullptr) {
+            istream = m_streams.erase(istream);
+            continue;
+        }
+        if (stream->size() == a_instructions.size()
+                && equal(stream->begin(), stream->end(),
+                         a_instructions.begin(), isEqual))
+            return stream;
+        ++istream;
+    }
+
+    InstructionStream stream =
+            make_shared<const vector<Instruction>>(a_instructions);
+    m_streams.emplace(hash, stream);
+
+    // The freed streams are removed now and then
+    if (++m_interned >= max<size_t>(64, m_streams.size() / 2)) {
+        m_interned = 0;
+        for (auto istream = m_streams.begin(); istream != m_streams.end(); ) {
+            if (istream->second.expired())
+                istream = m_streams.erase(istream);
+            else
+                ++istream;
+        }
+    }
+    return stream;
+}
+
+/**
+ * @brief Counts the streams alive and their owners
+ * @details The owners are the MathExpressions and the Programs holding the
+ * stream, each of them would hold its own copy of the instructions without
+ * the pool. The counters are a snapshot, the owners change concurrently.
+ * @return **Statistics** The counters
+ */
+InstructionPool::Statistics InstructionPool::statistics() const
+{
+    Statistics statistics = { 0, 0, 0, 0 };
+    lock_guard<mutex> lock(m_mutex);
+    for (const auto &istream : m_streams) {
+        InstructionStream stream = istream.second.lock();
+        if (stream == nullptr)
+            continue;
+        size_t owners = size_t(max<long>(1, stream.use_count() - 1));
+        size_t bytes = stream->size() * sizeof(Instruction);
+        statistics.streams++;
+        statistics.references += owners;
+        statistics.bytes += bytes;
+        statistics.bytesSaved += (owners - 1) * bytes;
+    }
+    return statistics;
+}
@@ -0,0 +1,85 @@
+/**
+ *  @file pssmathshare.h
+ *  @brief Headers for sharing the instructions of equal compiled programs
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHSHARE_H
+#define PSSMATHSHARE_H
+
+#include "pssmathparser_global.h"
+#include "pssmathcore.h"
+#include <mutex>
+#include <unordered_map>
+
+namespace PssMathParser {
+
+/**
+ * @brief Process wide set of the instruction streams of compiled programs
+ * @details The instructions only name slots, the constants are in the values
+ * of every program. So `2.0*x` and `x*2`, or even `x*3`, are calculated by the
+ * same instructions once the program is canonical: the operands of `+` and
+ * `*` are sorted by their structural hash, the instructions are ordered by a
+ * depth first walk from the result and the slots that aren't variables are
+ * numbered in the order of that walk. canonicalize() gives the new slot of
+ * every old slot, so the owner of the program moves its values with it.
+ *
+ * intern() returns the stream already held by another program if the
+ * canonical instructions are equal, so every MathExpression keeps only its own
+ * values. The pool holds the streams weakly, they are freed with the last
+ * program.
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC InstructionPool {
+public:
+    /**
+     * @brief Counters of the pool
+     */
+    struct Statistics {
+        size_t streams; /**< Streams alive in the pool */
+        size_t references; /**< Owners of these streams */
+        size_t bytes; /**< Bytes of the instructions of these streams */
+        size_t bytesSaved; /**< Bytes the owners would hold in copies */
+    };
+
+    InstructionPool();
+
+    InstructionPool(const InstructionPool &) = delete;
+    InstructionPool &operator=(const InstructionPool &) = delete;
+
+    static InstructionPool &instance();
+    static bool canonicalize(vector<Instruction> &a_instructions,
+                             vector<uint32_t> &a_slots,
+                             const uint32_t a_slotSize,
+                             const uint32_t a_variableSize,
+                             const uint32_t a_resultSlot);
+    static uint64_t structuralHash(const vector<Instruction> &a_instructions);
+
+    InstructionStream intern(const vector<Instruction> &a_instructions);
+    Statistics statistics() const;
+
+private:
+    mutable mutex m_mutex; /**< Guards m_streams */
+    unordered_multimap<uint64_t, weak_ptr<const vector<Instruction>>>
+            m_streams; /**< Streams by their structural hash */
+    size_t m_interned; /**< Streams added since the last cleaning */
+};
+
+}
+
+#endif // PSSMATHSHARE_H
@@ -0,0 +1,274 @@
+/**
+ *  @file pssmathtable.cpp
+ *  @brief Table of an expression of one variable
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmathtable.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace PssMathParser;
+
+namespace {
+
+/** @brief Segments of the domain */
+const size_t SegmentSize = 64;
+/** @brief Largest number of intervals of a table */
+const size_t MaxIntervals = size_t(1) << 28;
+/** @brief Points of an interval where the error is measured */
+const uint32_t CheckPoints = 7;
+
+/**
+ * @brief Value of the program at a_x
+ */
+double sample(EvaluationContext &a_context, const double a_x)
+{
+    a_context.setVariable(0, a_x);
+    return a_context.calculate();
+}
+
+}
+
+/**
+ * @brief Constructor of a table that is 0 in [0, 1]
+ */
+TableFunction::TableFunction():
+    m_lower(0.0),
+    m_upper(1.0),
+    m_scale(1.0),
+    m_segmentSize(1.0),
+    m_lastSegment(0.0),
+    m_segments(1, Segment { 1.0, 0, 0 }),
+    m_coefficients(4, 0.0),
+    m_maxError(0.0)
+{
+}
+
+/**
+ * @brief Builds the table of the program in [a_lower, a_upper]
+ * @details The intervals of every segment are halved until the absolute error
+ * measured in the segment is at most a_maxError, or until the table would
+ * have more than a_maxSize intervals. In the second case the table is still
+ * built, with its error in maxError(), and the call returns false. The
+ * program is calculated about 11 times per interval.
+ * @param a_program Program of at most one variable
+ * @param a_lower Lower end of the domain
+ * @param a_upper Upper end of the domain
+ * @param a_maxError Target of the largest absolute error
+ * @param a_maxSize Largest number of intervals
+ * @return **true** The error of the table is at most a_maxError
+ * @return **false** The table can't be built or is less accurate, see
+ * errorString()
+ */
+bool TableFunction::build(const shared_ptr<const Program> &a_program,
+                          const double a_lower,
+                          const double a_upper,
+                          const double a_maxError,
+                          const size_t a_maxSize)
+{
+    m_errorString.clear();
+    if (a_program == nullptr) {
+        m_errorString = "There is no program";
+        return false;
+    }
+    if (a_program->variableSize() > 1) {
+        m_errorString = "The program has "
+                + to_string(a_program->variableSize())
+                + " variables, a table has one";
+        return false;
+    }
+    if (isfinite(a_lower) == false || isfinite(a_upper) == false
+            || !(a_lower < a_upper)) {
+        m_errorString = "The domain isn't a finite interval";
+        return false;
+    }
+    if (!(a_maxError > 0.0) || a_maxSize == 0) {
+        m_errorString = "The error and the size must be more than 0";
+        return false;
+    }
+
+    const size_t maxSize = min(a_maxSize, MaxIntervals);
+    const size_t segmentSize = min(SegmentSize, maxSize);
+    const double width = (a_upper - a_lower) / double(segmentSize);
+    EvaluationContext context(a_program);
+    vector<Segment> segments;
+    segments.reserve(segmentSize);
+    vector<double> coefficients;
+    vector<double> segmentCoefficients;
+    double maxError = 0.0;
+    size_t used = 0;
+    for (size_t s = 0; s < segmentSize; s++) {
+        const double lower = a_lower + width * double(s);
+        const double upper = s + 1 == segmentSize ? a_upper : lower + width;
+        const size_t available = maxSize - used - (segmentSize - s - 1);
+        uint32_t intervals = 1;
+        double error = fit(context, lower, upper, intervals,
+                           segmentCoefficients);
+        while (error > a_maxError && intervals * size_t(2) <= available) {
+            intervals *= 2;
+            error = fit(context, lower, upper, intervals,
+                        segmentCoefficients);
+        }
+        segments.push_back(Segment { double(intervals), intervals - 1,
+                                     uint32_t(used) });
+        coefficients.insert(coefficients.end(), segmentCoefficients.begin(),
+                            segmentCoefficients.end());
+        used += intervals;
+        maxError = max(maxError, error);
+    }
+
+    m_lower = a_lower;
+    m_upper = a_upper;
+    m_scale = double(segmentSize) / (a_upper - a_lower);
+    m_segmentSize = double(segmentSize);
+    m_lastSegment = double(segmentSize - 1);
+    m_segments.swap(segments);
+    m_coefficients.swap(coefficients);
+    m_maxError = maxError;
+    if (maxError <= a_maxError)
+        return true;
+    if (isfinite(maxError) == false)
+        m_errorString = "The program isn't finite in the domain";
+    else
+        m_errorString = "The error " + to_string(maxError)
+                + " is over the target with " + to_string(used)
+                + " intervals";
+    return false;
+}
+
+/**
+ * @brief Calculates a_size values from the table
+ * @details The loop has no calls, so the compiler can unroll and vectorize
+ * the calculation of the cubics.
+ * @param a_x Array of a_size values of the variable
+ * @param a_results Array of a_size results
+ * @param a_size Number of values
+ */
+void TableFunction::calculateBatch(const double *a_x,
+                                   double *a_results,
+                                   const size_t a_size) const
+{
+    for (size_t i = 0; i < a_size; i++)
+        a_results[i] = calculate(a_x[i]);
+}
+
+/**
+ * @brief Lower end of the domain
+ */
+double TableFunction::lower() const
+{
+    return m_lower;
+}
+
+/**
+ * @brief Upper end of the domain
+ */
+double TableFunction::upper() const
+{
+    return m_upper;
+}
+
+/**
+ * @brief Largest absolute error of the table measured by build()
+ * @details The error is measured at 7 points inside every interval, so the
+ * true error can be slightly more.
+ */
+double TableFunction::maxError() const
+{
+    return m_maxError;
+}
+
+/**
+ * @brief Number of the intervals of the table
+ */
+size_t TableFunction::size() const
+{
+    return m_coefficients.size() / 4;
+}
+
+/**
+ * @brief Memory of the table in bytes
+ */
+size_t TableFunction::bytes() const
+{
+    return m_coefficients.size() * sizeof(double)
+            + m_segments.size() * sizeof(Segment);
+}
+
+/**
+ * @brief Description of the error of the last build()
+ */
+const string TableFunction::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * @brief Fits the cubics of equal intervals in [a_lower, a_upper]
+ * @details The cubic of an interval goes through the values of the program at
+ * t = 0, 1/3, 2/3 and 1, where t is the position in the interval. Its
+ * coefficients come from the finite differences of the 4 values.
+ * @param a_context Context of the program
+ * @param a_lower Lower end of the segment
+ * @param a_upper Upper end of the segment
+ * @param a_intervals Number of the intervals
+ * @param a_coefficients Filled with 4 coefficients per interval
+ * @return **double** Largest absolute error at the check points, infinity if
+ * the program or the cubic isn't finite there
+ */
+double TableFunction::fit(EvaluationContext &a_context,
+                          const double a_lower,
+                          const double a_upper,
+                          const uint32_t a_intervals,
+                          vector<double> &a_coefficients) const
+{
+    const double width = a_upper - a_lower;
+    const size_t sampleSize = size_t(a_intervals) * 3;
+    vector<double> samples(sampleSize + 1);
+    for (size_t k = 0; k <= sampleSize; k++) {
+        samples[k] = sample(a_context, a_lower
+                            + width * double(k) / double(sampleSize));
+    }
+
+    a_coefficients.resize(size_t(a_intervals) * 4);
+    double maxError = 0.0;
+    for (uint32_t i = 0; i < a_intervals; i++) {
+        const double *f = &samples[size_t(i) * 3];
+        const double d1 = f[1] - f[0];
+        const double d2 = f[2] - 2.0 * f[1] + f[0];
+        const double d3 = f[3] - 3.0 * f[2] + 3.0 * f[1] - f[0];
+        double *c = &a_coefficients[size_t(i) * 4];
+        c[0] = f[0];
+        c[1] = 3.0 * d1 - 1.5 * d2 + d3;
+        c[2] = 4.5 * d2 - 4.5 * d3;
+        c[3] = 4.5 * d3;
+        for (uint32_t j = 1; j <= CheckPoints; j++) {
+            const double t = double(j) / double(CheckPoints + 1);
+            const double x = a_lower
+                    + width * (double(i) + t) / double(a_intervals);
+            const double cubic = ((c[3] * t + c[2]) * t + c[1]) * t + c[0];
+            double error = fabs(cubic - sample(a_context, x));
+            if (isfinite(error) == false)
+                error = HUGE_VAL;
+            maxError = max(maxError, error);
+        }
+    }
+    return maxError;
+}
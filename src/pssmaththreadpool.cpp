@@ -0,0 +1,489 @@
+/**
+ *  @file pssmaththreadpool.cpp
+ *  @brief Thread pool of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "pssmaththreadpool.h"
+#include <algorithm>
+#include <exception>
+
+using namespace PssMathParser;
+
+namespace {
+
+atomic<unsigned> defaultSize(0); /**< Size of the pool from instance() */
+thread_local const ThreadPool *currentPool = nullptr; /**< Pool of thread */
+thread_local int currentIndex = -1; /**< Worker index of the thread */
+
+/**
+ * @brief Bytes of the rows of one chunk of calculateBatch(), it is half of a
+ * typical L2 cache
+ */
+const size_t chunkBytes = 128 * 1024;
+
+/**
+ * @brief Shared state of one parallelFor() call
+ */
+struct RangeState {
+    RangeState(const ThreadPool::RangeJob &a_job, const size_t a_count):
+        job(a_job),
+        remaining(a_count)
+    {
+    }
+
+    const ThreadPool::RangeJob &job; /**< Job of the caller */
+    atomic<size_t> remaining; /**< Indices that are not finished */
+    mutex doneMutex; /**< Guards done */
+    condition_variable done; /**< Wakes the caller */
+    mutex errorMutex; /**< Guards error */
+    exception_ptr error; /**< First exception thrown by the job */
+};
+
+/**
+ * @brief Context of one worker in calculateBatch()
+ */
+struct BatchWorker {
+    unique_ptr<EvaluationContext> context; /**< Slots of the worker */
+    vector<const double *> columns; /**< Columns moved to the chunk */
+};
+
+}
+
+/**
+ * @brief Constructor, the token is not cancelled
+ */
+CancellationToken::CancellationToken():
+    m_cancelled(false)
+{
+}
+
+/**
+ * @brief Stops the calculations that check this token
+ */
+void CancellationToken::cancel()
+{
+    m_cancelled.store(true, memory_order_relaxed);
+}
+
+/**
+ * @brief Clears the cancellation, so the token can be used again
+ */
+void CancellationToken::reset()
+{
+    m_cancelled.store(false, memory_order_relaxed);
+}
+
+/**
+ * @brief Tells if cancel() was called
+ */
+bool CancellationToken::isCancelled() const
+{
+    return m_cancelled.load(memory_order_relaxed);
+}
+
+/**
+ * @brief Constructor
+ * @param a_token Stops the calculation, nullptr if it can't be stopped
+ * @param a_progress Called after every chunk, empty for no reporting
+ */
+BatchControl::BatchControl(const CancellationToken *a_token,
+                           const Progress &a_progress):
+    token(a_token),
+    progress(a_progress)
+{
+}
+
+/**
+ * @brief Tells if the token is set and cancelled
+ */
+bool BatchControl::isCancelled() const
+{
+    return token != nullptr && token->isCancelled();
+}
+
+/**
+ * @brief Calls the progress if it is set
+ * @param a_done Number of finished rows
+ * @param a_size Number of all rows
+ */
+void BatchControl::report(const size_t a_done, const size_t a_size) const
+{
+    if (progress)
+        progress(a_done, a_size);
+}
+
+/**
+ * @brief Constructor, starts the workers
+ * @param a_size Number of workers, 0 for one worker for every core
+ */
+ThreadPool::ThreadPool(unsigned a_size):
+    m_queued(0),
+    m_next(0),
+    m_stop(false)
+{
+    if (a_size == 0)
+        a_size = max(1u, thread::hardware_concurrency());
+    for (unsigned i = 0; i < a_size; i++) {
+        m_workers.push_back(unique_ptr<Worker>(new Worker));
+    }
+    for (unsigned i = 0; i < a_size; i++) {
+        m_workers[i]->worker = thread(&ThreadPool::run, this, i);
+    }
+}
+
+/**
+ * @brief Destructor, finishes the queued jobs and joins the workers
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(m_sleepMutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (unique_ptr<Worker> &worker : m_workers) {
+        worker->worker.join();
+    }
+}
+
+/**
+ * @brief The pool owned by the library
+ * @details It is made on the first call with setDefaultSize() workers and
+ * lives until the end of the program.
+ * @return **ThreadPool&** The pool
+ */
+ThreadPool &ThreadPool::instance()
+{
+    static ThreadPool pool(defaultSize.load());
+    return pool;
+}
+
+/**
+ * @brief Sets the number of workers of instance()
+ * @details Has no effect after instance() is used for the first time.
+ * @param a_size Number of workers, 0 for one worker for every core
+ */
+void ThreadPool::setDefaultSize(unsigned a_size)
+{
+    defaultSize = a_size;
+}
+
+/**
+ * @brief Number of rows calculated in one job of calculateBatch()
+ * @details The variable columns and the results of a chunk fit in half of the
+ * L2 cache, it is never less than 256 rows.
+ * @param a_columns Number of variables
+ * @return **size_t** Rows of a chunk
+ */
+size_t ThreadPool::chunkSize(const uint32_t a_columns)
+{
+    size_t rows = chunkBytes / (sizeof(double) * (a_columns + 1));
+    return max<size_t>(256, rows - rows % 64);
+}
+
+/**
+ * @brief Return the number of workers
+ */
+unsigned ThreadPool::size() const
+{
+    return static_cast<unsigned>(m_workers.size());
+}
+
+/**
+ * @brief Index of the worker running on the calling thread
+ * @return **int** Index of the worker, -1 if the thread is not from this pool
+ */
+int ThreadPool::currentWorker() const
+{
+    if (currentPool != this)
+        return -1;
+    return currentIndex;
+}
+
+/**
+ * @brief Runs the job on one of the workers
+ * @details The pool doesn't tell when the job is finished. A job that throws
+ * an exception is stopped and the exception is lost.
+ * @param a_job The job
+ */
+void ThreadPool::submit(Job a_job)
+{
+    push(std::move(a_job));
+}
+
+/**
+ * @brief Calls the job for every index from 0 to a_count-1 on the workers
+ * @details Returns when all the calls are finished. The job gets the index
+ * and the index of the worker calling it, so it can keep data for every
+ * worker. The first exception thrown by the job is thrown again from here
+ * after all the calls. It can be called from a job running on this pool, then
+ * the calling worker also runs the jobs while it waits.
+ * @param a_count Number of indices
+ * @param a_job Called for every index
+ */
+void ThreadPool::parallelFor(const size_t a_count, const RangeJob &a_job)
+{
+    if (a_count == 0)
+        return;
+    shared_ptr<RangeState> state = make_shared<RangeState>(a_job, a_count);
+    struct Range {
+        static void run(ThreadPool *a_pool,
+                        const shared_ptr<RangeState> &a_state,
+                        size_t a_begin, size_t a_end)
+        {
+            while (a_end - a_begin > 1) {
+                size_t middle = a_begin + (a_end - a_begin) / 2;
+                a_pool->push(bind(&Range::run, a_pool, a_state,
+                                  middle, a_end));
+                a_end = middle;
+            }
+            try {
+                a_state->job(a_begin,
+                             static_cast<unsigned>(a_pool->currentWorker()));
+            }
+            catch (...) {
+                lock_guard<mutex> lock(a_state->errorMutex);
+                if (!a_state->error)
+                    a_state->error = current_exception();
+            }
+            if (a_state->remaining.fetch_sub(1) == 1) {
+                lock_guard<mutex> lock(a_state->doneMutex);
+                a_state->done.notify_all();
+            }
+        }
+    };
+    push(bind(&Range::run, this, state, size_t(0), a_count));
+
+    int self = currentWorker();
+    if (self >= 0) {
+        Job job;
+        while (state->remaining > 0) {
+            if (take(static_cast<unsigned>(self), job))
+                job();
+            else
+                this_thread::yield();
+        }
+    }
+    else {
+        unique_lock<mutex> lock(state->doneMutex);
+        state->done.wait(lock, [&state]() { return state->remaining == 0; });
+    }
+    if (state->error)
+        rethrow_exception(state->error);
+}
+
+/**
+ * @brief Calculates the program for many sets of variables on the workers
+ * @details Same as EvaluationContext::calculateBatch(), but the rows are
+ * split in chunks of chunkSize() rows and every worker calculates the chunks
+ * with its own EvaluationContext. The results are the same as from one
+ * thread, bit by bit.
+ * @param a_program The compiled program
+ * @param a_variables Array of variableSize() columns of a_size values
+ * @param a_results Array of a_size values for the results
+ * @param a_size Number of rows
+ */
+void ThreadPool::calculateBatch(const shared_ptr<const Program> &a_program,
+                                const double *const *a_variables,
+                                double *a_results,
+                                const size_t a_size)
+{
+    const uint32_t variableSize = a_program->variableSize();
+    const size_t chunk = chunkSize(variableSize);
+    const size_t chunks = (a_size + chunk - 1) / chunk;
+    if (chunks <= 1 || size() == 1) {
+        EvaluationContext context(a_program);
+        context.calculateBatch(a_variables, a_results, a_size);
+        return;
+    }
+    vector<unique_ptr<BatchWorker>> workers(size());
+    parallelFor(chunks, [&](size_t a_chunk, unsigned a_worker) {
+        unique_ptr<BatchWorker> &worker = workers[a_worker];
+        if (!worker) {
+            worker.reset(new BatchWorker);
+            worker->context.reset(new EvaluationContext(a_program));
+            worker->columns.resize(variableSize);
+        }
+        const size_t begin = a_chunk * chunk;
+        for (uint32_t j = 0; j < variableSize; j++) {
+            worker->columns[j] = a_variables[j] + begin;
+        }
+        worker->context->calculateBatch(worker->columns.data(),
+                                        a_results + begin,
+                                        min(chunk, a_size - begin));
+    });
+}
+
+/**
+ * @brief calculateBatch() that can be cancelled and reports its progress
+ * @details The workers take the chunks in the order of the rows and check the
+ * token before every chunk, a chunk that is taken is finished. So after a
+ * cancel the rows from 0 to the returned number are calculated and the other
+ * results are not touched.
+ * @param a_program The compiled program
+ * @param a_variables Array of variableSize() columns of a_size values
+ * @param a_results Array of a_size values for the results
+ * @param a_size Number of rows
+ * @param a_control The cancellation token and the progress
+ * @return **size_t** Number of the first rows that are calculated, a_size if
+ * it wasn't cancelled
+ */
+size_t ThreadPool::calculateBatch(const shared_ptr<const Program> &a_program,
+                                  const double *const *a_variables,
+                                  double *a_results,
+                                  const size_t a_size,
+                                  const BatchControl &a_control)
+{
+    const uint32_t variableSize = a_program->variableSize();
+    const size_t chunk = chunkSize(variableSize);
+    const size_t chunks = (a_size + chunk - 1) / chunk;
+    atomic<size_t> next(0);
+    mutex progressMutex;
+    size_t rowsDone = 0;
+    parallelFor(min<size_t>(size(), chunks), [&](size_t, unsigned) {
+        EvaluationContext context(a_program);
+        vector<const double *> columns(variableSize);
+        size_t index;
+        while (a_control.isCancelled() == false
+               && (index = next++) < chunks) {
+            const size_t begin = index * chunk;
+            const size_t rows = min(chunk, a_size - begin);
+            for (uint32_t j = 0; j < variableSize; j++) {
+                columns[j] = a_variables[j] + begin;
+            }
+            context.calculateBatch(columns.data(), a_results + begin, rows);
+            if (a_control.progress) {
+                lock_guard<mutex> lock(progressMutex);
+                rowsDone += rows;
+                a_control.report(rowsDone, a_size);
+            }
+        }
+    });
+    return min(a_size, min<size_t>(next, chunks) * chunk);
+}
+
+/**
+ * @brief Starts calculateBatch() on the workers and returns at once
+ * @details The column pointers are copied, the columns and the results must
+ * live until the callback is called. The callback runs on a worker after the
+ * last row with nullptr or the exception of the calculation. It should be
+ * short, an exception thrown by the callback is lost.
+ * @param a_program The compiled program
+ * @param a_variables Array of variableSize() columns of a_size values
+ * @param a_results Array of a_size values for the results
+ * @param a_size Number of rows
+ * @param a_callback Called when the results are ready
+ */
+void ThreadPool::calculateBatchAsync(const shared_ptr<const Program> &a_program,
+                                     const double *const *a_variables,
+                                     double *a_results,
+                                     const size_t a_size,
+                                     const Callback &a_callback)
+{
+    vector<const double *> columns(a_variables,
+                                   a_variables + a_program->variableSize());
+    submit([this, a_program, columns, a_results, a_size, a_callback]() {
+        exception_ptr error;
+        try {
+            calculateBatch(a_program, columns.data(), a_results, a_size);
+        }
+        catch (...) {
+            error = current_exception();
+        }
+        if (a_callback)
+            a_callback(error);
+    });
+}
+
+/**
+ * @brief Puts the job to the queue of the calling worker or, from outside of
+ * the pool, to the queues in turn
+ */
+void ThreadPool::push(Job a_job)
+{
+    int self = currentWorker();
+    unsigned index = self >= 0 ? static_cast<unsigned>(self)
+                               : m_next++ % size();
+    {
+        lock_guard<mutex> lock(m_workers[index]->queueMutex);
+        m_workers[index]->queue.push_back(std::move(a_job));
+    }
+    m_queued++;
+    {
+        lock_guard<mutex> lock(m_sleepMutex);
+    }
+    m_wake.notify_one();
+}
+
+/**
+ * @brief Takes the newest job of the worker or steals the oldest job of
+ * another worker
+ * @return **true** a_job is set
+ * @return **false** All the queues are empty
+ */
+bool ThreadPool::take(const unsigned a_worker, Job &a_job)
+{
+    {
+        Worker &own = *m_workers[a_worker];
+        lock_guard<mutex> lock(own.queueMutex);
+        if (own.queue.empty() == false) {
+            a_job = std::move(own.queue.back());
+            own.queue.pop_back();
+            m_queued--;
+            return true;
+        }
+    }
+    for (unsigned i = 1; i < size(); i++) {
+        Worker &other = *m_workers[(a_worker + i) % size()];
+        lock_guard<mutex> lock(other.queueMutex);
+        if (other.queue.empty() == false) {
+            a_job = std::move(other.queue.front());
+            other.queue.pop_front();
+            m_queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Loop of the worker, runs jobs and sleeps when there are none
+ */
+void ThreadPool::run(const unsigned a_worker)
+{
+    currentPool = this;
+    currentIndex = static_cast<int>(a_worker);
+    Job job;
+    while (true) {
+        if (take(a_worker, job)) {
+            try {
+                job();
+            }
+            catch (...) {
+            }
+            job = nullptr;
+            continue;
+        }
+        unique_lock<mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this]() { return m_stop || m_queued > 0; });
+        if (m_stop && m_queued == 0)
+            return;
+    }
+}
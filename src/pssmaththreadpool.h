@@ -0,0 +1,151 @@
+/**
+ *  @file pssmaththreadpool.h
+ *  @brief Headers for the thread pool of the PssMathParser
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PSSMATHTHREADPOOL_H
+#define PSSMATHTHREADPOOL_H
+
+#include "pssmathparser_global.h"
+#include "pssmathcore.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace PssMathParser {
+
+/**
+ * @brief Flag that stops a running batch calculation
+ * @details The calculation checks it before every chunk of rows, so it stops
+ * within one chunk after cancel() is called from any thread.
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC CancellationToken {
+public:
+    CancellationToken();
+
+    CancellationToken(const CancellationToken &) = delete;
+    CancellationToken &operator=(const CancellationToken &) = delete;
+
+    void cancel();
+    void reset();
+    bool isCancelled() const;
+
+private:
+    atomic<bool> m_cancelled; /**< Set by cancel() */
+};
+
+/**
+ * @brief Cancellation and progress reporting of a batch calculation
+ * @details Both are optional. The progress is called after every chunk with
+ * the number of finished rows and the number of all rows. The parallel
+ * calculation calls it from the workers, one call at a time.
+ */
+struct PSSMATHPARSER_EXPORT_PUBLIC BatchControl {
+    typedef function<void(size_t, size_t)> Progress; /**< Rows done, all */
+
+    explicit BatchControl(const CancellationToken *a_token = nullptr,
+                          const Progress &a_progress = Progress());
+
+    bool isCancelled() const;
+    void report(const size_t a_done, const size_t a_size) const;
+
+    const CancellationToken *token; /**< Stops the calculation, can be null */
+    Progress progress; /**< Called after every chunk, can be empty */
+};
+
+/**
+ * @brief Work stealing pool of threads
+ * @details Every worker has its own queue of jobs. A worker takes the newest
+ * job from its own queue and when it is empty it steals the oldest job from
+ * the queue of another worker. parallelFor() gives every worker one half of
+ * the range it has and the worker keeps splitting its part in halves, pushing
+ * the second half to its queue. So the idle workers steal big parts of the
+ * range and the busy worker only runs the small parts at the end.
+ *
+ * The library owns one pool, instance(), with one worker for every core. Its
+ * size can be changed with setDefaultSize() before it is first used. Other
+ * pools can be made for a fixed number of threads.
+ */
+class PSSMATHPARSER_EXPORT_PUBLIC ThreadPool {
+public:
+    typedef function<void()> Job; /**< Job for submit() */
+    typedef function<void(size_t, unsigned)> RangeJob; /**< parallelFor() */
+    typedef function<void(exception_ptr)> Callback; /**< Job finished */
+
+    explicit ThreadPool(unsigned a_size = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    static ThreadPool &instance();
+    static void setDefaultSize(unsigned a_size);
+    static size_t chunkSize(const uint32_t a_columns);
+
+    unsigned size() const;
+    int currentWorker() const;
+    void submit(Job a_job);
+    void parallelFor(const size_t a_count, const RangeJob &a_job);
+    void calculateBatch(const shared_ptr<const Program> &a_program,
+                        const double *const *a_variables,
+                        double *a_results,
+                        const size_t a_size);
+    size_t calculateBatch(const shared_ptr<const Program> &a_program,
+                          const double *const *a_variables,
+                          double *a_results,
+                          const size_t a_size,
+                          const BatchControl &a_control);
+    void calculateBatchAsync(const shared_ptr<const Program> &a_program,
+                             const double *const *a_variables,
+                             double *a_results,
+                             const size_t a_size,
+                             const Callback &a_callback);
+
+private:
+    /**
+     * @brief Queue of one worker, the owner works on the back and the
+     * thieves on the front
+     */
+    struct Worker {
+        mutex queueMutex; /**< Guards the queue */
+        deque<Job> queue; /**< Jobs of the worker */
+        thread worker; /**< The thread */
+    };
+
+    void push(Job a_job);
+    bool take(const unsigned a_worker, Job &a_job);
+    void run(const unsigned a_worker);
+
+    vector<unique_ptr<Worker>> m_workers; /**< The workers */
+    atomic<size_t> m_queued; /**< Jobs in all the queues */
+    atomic<unsigned> m_next; /**< Worker for the next outside job */
+    mutex m_sleepMutex; /**< Guards the sleeping of the workers */
+    condition_variable m_wake; /**< Wakes the workers */
+    bool m_stop; /**< The workers finish */
+};
+
+}
+
+#endif // PSSMATHTHREADPOOL_H
@@ -0,0 +1,213 @@
+#define TESTFILE "../test/input10.txt"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <fstream>
+#include <iomanip>
+#include <deque>
+#include <memory>
+#include <type_traits>
+#include <string.h>
+#include "pssmathparser.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+static_assert(is_nothrow_move_constructible<MathExpression>::value,
+              "vector must move and not copy when it reallocates");
+static_assert(is_nothrow_move_assignable<MathExpression>::value, "");
+
+// One expression from the input file
+struct TestCase {
+    string expression;
+    vector<string> names;
+    vector<double> values;
+    string expectedOutput;
+};
+
+// Formats the result as in the input file
+string formatResult(double a_result)
+{
+    ostringstream s;
+    s.setf(ios::scientific);
+    s << setprecision(7) << a_result;
+
+    // Here we add another digit in the exponent if it has only two
+    string stmp = s.str();
+    if(stmp.size() - stmp.find('e') == 4)
+        stmp.insert(stmp.find('e') + 2, "0");
+    return stmp;
+}
+
+// Sets the variables of the test case and calculates
+double calculate(MathParser &mp, const TestCase &testCase)
+{
+    for (size_t i=0; i<testCase.names.size(); i++) {
+        mp.setVariableDouble(testCase.names[i], testCase.values[i]);
+    }
+    return mp.calculateExpression();
+}
+
+// Checks all expressions in the container against the test cases
+template <class Container>
+bool testContainer(const string &name, Container &container,
+                   const vector<TestCase> &testCases)
+{
+    bool passed = true;
+    for (size_t i=0; i<testCases.size(); i++) {
+        string result = formatResult(calculate(container[i], testCases[i]));
+        if (result != testCases[i].expectedOutput
+                || container[i].expression() != testCases[i].expression) {
+            cout << "  - " << name << " " << i+1 << ": '" << result
+                 << "' expected '" << testCases[i].expectedOutput << "'"
+                 << endl;
+            passed = false;
+        }
+    }
+    cout << name << (passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+    return passed;
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 10 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+
+    // Check if file exists
+    ifstream infile(TESTFILE);
+    if (infile.is_open() == false) {
+        testFailed = true;
+        cout << "Error: Could not open input file '" << TESTFILE << "'" << endl;
+        cout << endl;
+        return 1;
+    }
+
+    // Read the test cases, every expression is parsed once into a vector that
+    // grows one by one, so it reallocates and moves the expressions
+    vector<TestCase> testCases;
+    vector<MathExpression> parsed;
+    string line;
+    while(getline(infile, line)) {
+        if(line[0] == '#')
+            continue;
+        TestCase testCase;
+        MathExpression mp;
+        mp.setMath(line);
+        testCase.expression = mp.expression();
+        for(uint16_t i=0; i<mp.getVariableSize(); i++) {
+            getline(infile, line);
+            size_t eq = line.find('=');
+            testCase.names.push_back(line.substr(0, eq));
+            testCase.values.push_back(atof(line.substr(eq + 1).data()));
+        }
+        getline(infile, line);
+        testCase.expectedOutput = line;
+        testCases.push_back(testCase);
+        parsed.push_back(std::move(mp));
+    }
+    infile.close();
+    cout << "Parsed " << testCases.size() << " expressions" << endl << endl;
+    if (testContainer("moved into vector", parsed, testCases) == false)
+        testFailed = true;
+
+    // Copies in a vector that reallocates on every copy
+    vector<MathExpression> copies;
+    for (const MathExpression &mp : parsed) {
+        copies.push_back(mp);
+        copies.shrink_to_fit();
+    }
+    if (testContainer("copied into vector", copies, testCases) == false)
+        testFailed = true;
+
+    // Copies must not depend on the original
+    vector<MathExpression> independent(parsed);
+    for (size_t i=0; i<parsed.size(); i++) {
+        for (const string &name : testCases[i].names) {
+            parsed[i].setVariableDouble(name, 1.0e10);
+        }
+    }
+    parsed.clear();
+    parsed.shrink_to_fit();
+    if (testContainer("copy of destroyed", independent, testCases) == false)
+        testFailed = true;
+
+    // Copy assignment over other expressions and move assignment when erasing
+    deque<MathExpression> assigned(testCases.size() + 1);
+    for (size_t i=0; i<testCases.size(); i++) {
+        assigned[i+1] = copies[testCases.size()-1-i];
+    }
+    for (size_t i=0; i<testCases.size(); i++) {
+        assigned[i+1] = copies[i];
+    }
+    assigned.erase(assigned.begin());
+    if (testContainer("assigned in deque", assigned, testCases) == false)
+        testFailed = true;
+
+    // Native code is shared by the copies
+    for (MathExpression &mp : copies) {
+        mp.setBackend(EvaluationBackend::Jit);
+    }
+    vector<MathExpression> nativeCopies(copies.begin(), copies.end());
+    copies.clear();
+    if (testContainer("copied native", nativeCopies, testCases) == false)
+        testFailed = true;
+
+    // Copy through the interface
+    vector<unique_ptr<MathParser>> clones;
+    for (MathExpression &mp : nativeCopies) {
+        clones.push_back(unique_ptr<MathParser>(mp.clone()));
+    }
+    nativeCopies.clear();
+    bool clonesPassed = true;
+    for (size_t i=0; i<testCases.size(); i++) {
+        if (formatResult(calculate(*clones[i], testCases[i]))
+                != testCases[i].expectedOutput)
+            clonesPassed = false;
+    }
+    cout << "cloned" << (clonesPassed ? ": TEST PASSED" : ": TEST FAILED")
+         << endl;
+    if (clonesPassed == false)
+        testFailed = true;
+
+    // The moved-from expressions are empty and can be used again
+    {
+        MathExpression source;
+        source.setMath("x*2+1");
+        source.setVariableDouble("x", 3.0);
+        MathExpression moved(std::move(source));
+        bool passed = moved.calculateExpression() == 7.0
+                && source.calculateExpression() == 0.0
+                && source.program() != nullptr
+                && source.getVariableSize() == 0;
+        MathExpression assigned;
+        assigned = std::move(moved);
+        double column[2] = { 1.0, 2.0 };
+        const double *columns[1] = { column };
+        double results[2] = { -1.0, -1.0 };
+        moved.calculateBatch(columns, results, 2);
+        passed = passed && assigned.calculateExpression() == 7.0
+                && moved.calculateExpression() == 0.0;
+        moved.setMath("y-1");
+        moved.setVariableDouble("y", 5.0);
+        passed = passed && moved.calculateExpression() == 4.0;
+        cout << "moved from" << (passed ? ": TEST PASSED" : ": TEST FAILED")
+             << endl;
+        if (passed == false)
+            testFailed = true;
+    }
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
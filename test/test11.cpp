@@ -0,0 +1,234 @@
+#define TESTFILE "../test/input11.txt"
+#define BATCHSIZE 100003
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <fstream>
+#include <iomanip>
+#include <atomic>
+#include <stdexcept>
+#include <string.h>
+#include "pssmathparser.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Formats the result as in the input file
+string formatResult(double a_result)
+{
+    ostringstream s;
+    s.setf(ios::scientific);
+    s << setprecision(7) << a_result;
+
+    // Here we add another digit in the exponent if it has only two
+    string stmp = s.str();
+    if(stmp.size() - stmp.find('e') == 4)
+        stmp.insert(stmp.find('e') + 2, "0");
+    return stmp;
+}
+
+// Every index must be given exactly once, also from nested calls
+bool testParallelFor(ThreadPool &pool)
+{
+    const size_t count = 1000;
+    vector<atomic<int>> calls(count + count / 10 * (count / 10));
+    for (atomic<int> &call : calls)
+        call = 0;
+    pool.parallelFor(count, [&](size_t a_index, unsigned a_worker) {
+        if (a_worker >= pool.size() || (int)a_worker != pool.currentWorker())
+            calls[0] = -1000;
+        calls[a_index]++;
+        if (a_index % 10 == 0) {
+            pool.parallelFor(count / 10, [&](size_t a_inner, unsigned) {
+                calls[count + a_index / 10 * (count / 10) + a_inner]++;
+            });
+        }
+    });
+    for (size_t i = 0; i < count + count / 10 * (count / 10); i++) {
+        if (calls[i] != 1) {
+            cout << "  - index " << i << " called " << calls[i] << " times"
+                 << endl;
+            return false;
+        }
+    }
+
+    // The exception of the job comes to the caller
+    bool thrown = false;
+    try {
+        pool.parallelFor(count, [](size_t a_index, unsigned) {
+            if (a_index == 17)
+                throw runtime_error("job failed");
+        });
+    }
+    catch (const runtime_error &) {
+        thrown = true;
+    }
+    if (thrown == false)
+        cout << "  - exception of the job is lost" << endl;
+    return thrown;
+}
+
+// Compares the parallel batch with the batch in one thread bit by bit
+bool testPools(MathParser *mp, const vector<double> &values, double &dout)
+{
+    uint16_t numVariables = mp->getVariableSize();
+    vector<vector<double>> columns(numVariables);
+    vector<const double *> columnPointers;
+    for (uint16_t j=0; j<numVariables; j++) {
+        for (uint32_t i=0; i<BATCHSIZE; i++) {
+            columns[j].push_back(values[j]*(1.0 + i*1.0e-6));
+        }
+        columnPointers.push_back(columns[j].data());
+    }
+    vector<double> expected(BATCHSIZE);
+    mp->calculateBatch(columnPointers.data(), expected.data(), BATCHSIZE);
+    dout = expected[0];
+
+    const unsigned sizes[] = { 1, 2, 3, 8 };
+    for (unsigned size : sizes) {
+        ThreadPool pool(size);
+        vector<double> results(BATCHSIZE, 0.0);
+        mp->calculateBatchParallel(columnPointers.data(), results.data(),
+                                   BATCHSIZE, &pool);
+        if (memcmp(results.data(), expected.data(),
+                   BATCHSIZE*sizeof(double)) != 0) {
+            cout << "  - pool of " << size << " threads differs" << endl;
+            return false;
+        }
+    }
+
+    // The library pool and a batch smaller than one chunk
+    vector<double> results(BATCHSIZE, 0.0);
+    mp->calculateBatchParallel(columnPointers.data(), results.data(),
+                               BATCHSIZE);
+    mp->calculateBatchParallel(columnPointers.data(), results.data(), 10);
+    if (memcmp(results.data(), expected.data(),
+               BATCHSIZE*sizeof(double)) != 0) {
+        cout << "  - library pool differs" << endl;
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 11 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool output = false, testFailed = false;
+
+    // Check if file exists
+    ifstream infile(TESTFILE);
+    if (infile.is_open() == false) {
+        testFailed = true;
+        cout << "Error: Could not open input file '" << TESTFILE << "'" << endl;
+        cout << endl;
+        return 1;
+    }
+
+    // Test the pool itself
+    const unsigned sizes[] = { 1, 4 };
+    for (unsigned size : sizes) {
+        ThreadPool pool(size);
+        if (testParallelFor(pool)) {
+            cout << "parallelFor on " << size << " threads: TEST PASSED"
+                 << endl;
+        }
+        else {
+            cout << "parallelFor on " << size << " threads: TEST FAILED"
+                 << endl;
+            testFailed = true;
+        }
+    }
+    cout << endl;
+
+    // Run tests
+    const EvaluationBackend backends[] = {
+        EvaluationBackend::Interpreter,
+        EvaluationBackend::Jit,
+        EvaluationBackend::SystemCompiler
+    };
+    const char *backendNames[] = { "interpreter", "jit", "compiler" };
+    string line;
+    vector<string> outputLines;
+    vector<double> values;
+    double dout;
+    MathParser *mp = MathParser::makeMathParser();
+    uint16_t counter = 1, numVariables=0;
+    while(getline(infile, line)) {
+        if(line[0] != '#') {
+            if(output == false) {
+                // Input
+                cout << counter << ".test line: '" << line << "'" << endl;
+                mp->setMath(line);
+
+                // Read variables, ordered as in the expression
+                numVariables = mp->getVariableSize();
+                values.assign(numVariables, 0.0);
+                for(uint16_t i=0; i<numVariables; i++) {
+                    getline(infile, line);
+                    size_t eq = line.find('=');
+                    for(uint16_t j=0; j<numVariables; j++) {
+                        if (mp->getVariableName(j) == line.substr(0, eq))
+                            values[j] = atof(line.substr(eq + 1).data());
+                    }
+                }
+
+                // Calculate the expression with every backend
+                outputLines.clear();
+                for (size_t b=0; b<sizeof(backends)/sizeof(backends[0]); b++) {
+                    if (mp->setBackend(backends[b]) == false) {
+                        cout << "  - backend not available, using interpreter"
+                             << endl;
+                    }
+                    if (testPools(mp, values, dout) == false) {
+                        cout << "  - " << backendNames[b]
+                             << " parallel batch differs" << endl;
+                        testFailed = true;
+                    }
+                    outputLines.push_back(formatResult(dout));
+                    cout << "  - result (" << backendNames[b] << ") = "
+                         << outputLines.back() << endl;
+                }
+                output = true;
+            }
+            else {
+                // Output
+                cout << counter << ".expected output: '" << line
+                     << "'" << endl;
+                for (const string &outputLine : outputLines) {
+                    if (outputLine != line)
+                        testFailed = true;
+                }
+                if (testFailed == false) {
+                    cout << counter << ".TEST PASSED" << endl;
+                }
+                else {
+                    cout << counter << ".TEST FAILED" << endl;
+                    break;
+                }
+                cout << endl;
+                counter++;
+                output = false;
+                mp->clear();
+            }
+        }
+    }
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+
+    // Clear used data
+    infile.close();
+    delete mp;
+    return 0;
+}
@@ -0,0 +1,150 @@
+#define TERMS 30000
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <iomanip>
+#include <string.h>
+#include "pssmathparser.h"
+#include "pssmathschedule.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// One term of the generated expression
+string term(int a_index)
+{
+    return "sin(x*" + to_string(1 + a_index % 97) + ".5+y)";
+}
+
+// Value of the term in C++
+double termValue(int a_index, double x, double y)
+{
+    return sin(x * (1 + a_index % 97 + 0.5) + y);
+}
+
+// Sum of the terms from a_begin to a_end as a balanced tree of additions
+string tree(int a_begin, int a_end)
+{
+    if (a_end - a_begin == 1)
+        return term(a_begin);
+    int middle = (a_begin + a_end) / 2;
+    return "(" + tree(a_begin, middle) + "+" + tree(middle, a_end) + ")";
+}
+
+// Value of the tree in C++
+double treeValue(int a_begin, int a_end, double x, double y)
+{
+    if (a_end - a_begin == 1)
+        return termValue(a_begin, x, y);
+    int middle = (a_begin + a_end) / 2;
+    return treeValue(a_begin, middle, x, y) + treeValue(middle, a_end, x, y);
+}
+
+// Compares the parallel calculation with the interpreter bit by bit
+bool testExpression(const string &a_expression, double a_expected,
+                    bool a_parallel)
+{
+    MathExpression mp;
+    mp.setMath(a_expression);
+    shared_ptr<const Program> program = mp.program();
+    LevelSchedule schedule(program->instructions(), program->resultSlot());
+    cout << "  - " << program->instructions().size() << " instructions in "
+         << schedule.levelSize() << " levels, widest level "
+         << schedule.maxWidth() << endl;
+    if (schedule.isParallel() != a_parallel) {
+        cout << "  - expected the schedule to be "
+             << (a_parallel ? "parallel" : "serial") << endl;
+        return false;
+    }
+
+    const double xs[] = { 0.3, -1.25, 7.0 };
+    for (double x : xs) {
+        mp.setBackend(EvaluationBackend::Interpreter);
+        mp.setVariableDouble("x", x);
+        mp.setVariableDouble("y", 0.1);
+        double expected = mp.calculateExpression();
+        if (mp.setBackend(EvaluationBackend::Parallel) == false
+                || mp.backend() != EvaluationBackend::Parallel) {
+            cout << "  - parallel backend is not used" << endl;
+            return false;
+        }
+        double result = mp.calculateExpression();
+        if (memcmp(&result, &expected, sizeof(double)) != 0) {
+            cout << "  - parallel " << result << " interpreter " << expected
+                 << endl;
+            return false;
+        }
+        // Same schedule on a pool with a different number of workers
+        vector<double> slots(program->values());
+        slots[0] = x;
+        slots[1] = 0.1;
+        ThreadPool pool(3);
+        result = schedule.run(slots.data(), pool);
+        if (memcmp(&result, &expected, sizeof(double)) != 0) {
+            cout << "  - pool of 3 gives " << result << endl;
+            return false;
+        }
+    }
+    mp.setVariableDouble("x", 0.3);
+    mp.setVariableDouble("y", 0.1);
+    double result = mp.calculateExpression();
+    if (fabs(result - a_expected) > 1.0e-9 * max(1.0, fabs(a_expected))) {
+        cout << "  - result " << setprecision(17) << result << " expected "
+             << a_expected << endl;
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 12 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+
+    // Small expressions stay on the calling thread
+    const int sizes[] = { 1, 40, TERMS };
+    for (int size : sizes) {
+        cout << "Sum of " << size << " terms" << endl;
+        if (testExpression(tree(0, size), treeValue(0, size, 0.3, 0.1),
+                           size == TERMS)) {
+            cout << "TEST PASSED" << endl << endl;
+        }
+        else {
+            cout << "TEST FAILED" << endl << endl;
+            testFailed = true;
+        }
+    }
+
+    // A chain has no independent instructions
+    string chain = "x";
+    for (int i = 0; i < 1000; i++) {
+        chain = "sin(" + chain + "+y)";
+    }
+    double chainValue = 0.3;
+    for (int i = 0; i < 1000; i++) {
+        chainValue = sin(chainValue + 0.1);
+    }
+    cout << "Chain of 1000 functions" << endl;
+    if (testExpression(chain, chainValue, false)) {
+        cout << "TEST PASSED" << endl << endl;
+    }
+    else {
+        cout << "TEST FAILED" << endl << endl;
+        testFailed = true;
+    }
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
@@ -0,0 +1,183 @@
+#define TESTFILE "../test/input13.txt"
+#define COPIES 400
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <fstream>
+#include <iomanip>
+#include <string.h>
+#include "pssmathparser.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Formats the result as in the input file
+string formatResult(double a_result)
+{
+    ostringstream s;
+    s.setf(ios::scientific);
+    s << setprecision(7) << a_result;
+
+    // Here we add another digit in the exponent if it has only two
+    string stmp = s.str();
+    if(stmp.size() - stmp.find('e') == 4)
+        stmp.insert(stmp.find('e') + 2, "0");
+    return stmp;
+}
+
+// One expression from the input file
+struct TestCase {
+    string expression;
+    vector<string> names;
+    vector<double> values;
+    string expectedOutput;
+};
+
+// Expression with an error and the expected error number
+struct ErrorCase {
+    string expression;
+    uint32_t expressionError;
+};
+
+// Calculates the compiled expression with the variables of the test case
+double calculate(const CompiledExpression &a_compiled,
+                 const TestCase &a_testCase)
+{
+    EvaluationContext context(a_compiled.program);
+    for (size_t i=0; i<a_compiled.variableNames.size(); i++) {
+        for (size_t j=0; j<a_testCase.names.size(); j++) {
+            if (a_compiled.variableNames[i] == a_testCase.names[j])
+                context.setVariable(uint32_t(i), a_testCase.values[j]);
+        }
+    }
+    return context.calculate();
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 13 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+
+    // Check if file exists
+    ifstream infile(TESTFILE);
+    if (infile.is_open() == false) {
+        testFailed = true;
+        cout << "Error: Could not open input file '" << TESTFILE << "'" << endl;
+        cout << endl;
+        return 1;
+    }
+
+    // Read the test cases
+    vector<TestCase> testCases;
+    string line;
+    while(getline(infile, line)) {
+        if(line[0] == '#')
+            continue;
+        TestCase testCase;
+        testCase.expression = line;
+        MathExpression mp;
+        mp.setMath(line);
+        for(uint16_t i=0; i<mp.getVariableSize(); i++) {
+            getline(infile, line);
+            size_t eq = line.find('=');
+            testCase.names.push_back(line.substr(0, eq));
+            testCase.values.push_back(atof(line.substr(eq + 1).data()));
+        }
+        getline(infile, line);
+        testCase.expectedOutput = line;
+        testCases.push_back(testCase);
+    }
+    infile.close();
+
+    const ErrorCase errorCases[] = {
+        { "(x+y", 4 },
+        { "x+y)", 4 },
+        { ")", 5 },
+        { "x+", 2 },
+        { "1+*2", 2 },
+        { "1+*2+3", 2 },
+        { "x+*y+z", 2 },
+        { "a-*(x)+y", 2 },
+        { "-*(x)+(y)", 2 },
+        { "a-*((x/(y*(z+b)/c))-1)+(x-(y))", 2 },
+        { "", 6 }
+    };
+    const size_t numErrors = sizeof(errorCases)/sizeof(errorCases[0]);
+
+    // Many copies of the test cases with the errors in between
+    vector<string> expressions;
+    for (size_t c=0; c<COPIES; c++) {
+        for (const TestCase &testCase : testCases) {
+            expressions.push_back(testCase.expression);
+        }
+        expressions.push_back(errorCases[c % numErrors].expression);
+    }
+    const size_t stride = testCases.size() + 1;
+
+    const unsigned sizes[] = { 1, 4 };
+    for (unsigned size : sizes) {
+        ThreadPool pool(size);
+        vector<CompiledExpression> compiled =
+                MathParser::compileAll(expressions, &pool);
+        bool passed = compiled.size() == expressions.size();
+        for (size_t i=0; passed && i<compiled.size(); i++) {
+            if (i % stride == testCases.size()) {
+                const ErrorCase &errorCase = errorCases[i / stride % numErrors];
+                if (compiled[i].program != nullptr
+                        || compiled[i].expressionError
+                        != errorCase.expressionError
+                        || compiled[i].errorString.empty()) {
+                    cout << "  - '" << errorCase.expression << "' gives error "
+                         << compiled[i].expressionError << " '"
+                         << compiled[i].errorString << "'" << endl;
+                    passed = false;
+                }
+                continue;
+            }
+            const TestCase &testCase = testCases[i % stride];
+            if (compiled[i].program == nullptr) {
+                cout << "  - '" << testCase.expression << "' failed: "
+                     << compiled[i].errorString << endl;
+                passed = false;
+                continue;
+            }
+            string result = formatResult(calculate(compiled[i], testCase));
+            if (result != testCase.expectedOutput) {
+                cout << "  - '" << testCase.expression << "' = " << result
+                     << " expected " << testCase.expectedOutput << endl;
+                passed = false;
+            }
+        }
+        cout << "compileAll of " << expressions.size() << " expressions on "
+             << size << " threads" << (passed ? ": TEST PASSED"
+                                              : ": TEST FAILED") << endl;
+        if (passed == false)
+            testFailed = true;
+    }
+
+    // The parser is usable after a failed compile
+    MathParser *mp = MathParser::makeMathParser();
+    bool passed = mp->compile("(x").program == nullptr
+            && mp->compile(testCases[0].expression).program != nullptr
+            && mp->compile("").expressionError == 6;
+    cout << "compile after error" << (passed ? ": TEST PASSED"
+                                             : ": TEST FAILED") << endl;
+    if (passed == false)
+        testFailed = true;
+    delete mp;
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
@@ -0,0 +1,152 @@
+#define BIGSIZE 2000000
+#define SMALLSIZE 1000
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <iomanip>
+#include <string.h>
+#include "pssmathparser.h"
+#include "pssmathjobs.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Columns of one batch and the expected results
+struct Batch {
+    Batch(MathParser *mp, size_t a_size):
+        columns(mp->getVariableSize()),
+        expected(a_size),
+        results(a_size, -1.0)
+    {
+        for (size_t j=0; j<columns.size(); j++) {
+            for (size_t i=0; i<a_size; i++) {
+                columns[j].push_back(0.5 + 1.0e-6 * double(i + j));
+            }
+            pointers.push_back(columns[j].data());
+        }
+        mp->calculateBatch(pointers.data(), expected.data(), a_size);
+    }
+
+    bool isCorrect() const
+    {
+        return memcmp(results.data(), expected.data(),
+                      results.size()*sizeof(double)) == 0;
+    }
+
+    vector<vector<double>> columns;
+    vector<const double *> pointers;
+    vector<double> expected;
+    vector<double> results;
+};
+
+// Prints the result of one test
+bool report(const string &a_name, bool a_passed)
+{
+    cout << a_name << (a_passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+    return a_passed;
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 14 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+
+    MathParser *mp = MathParser::makeMathParser();
+    mp->setMath("2*sin(2*pi*f*t+phi)");
+    shared_ptr<const Program> program = mp->program();
+    Batch sweep(mp, BIGSIZE), interactive(mp, SMALLSIZE);
+
+    // The high priority job overtakes the sweep at a chunk boundary
+    {
+        ThreadPool pool(1);
+        JobScheduler scheduler(&pool);
+        shared_ptr<EvaluationJob> low = scheduler.submit(
+                    program, sweep.pointers.data(), sweep.results.data(),
+                    BIGSIZE, JobPriority::Low);
+        shared_ptr<EvaluationJob> high = scheduler.submit(
+                    program, interactive.pointers.data(),
+                    interactive.results.data(), SMALLSIZE, JobPriority::High);
+        high->wait();
+        bool overtaken = low->isFinished() == false;
+        low->wait();
+        if (report("high priority preempts the sweep", overtaken
+                   && high->status() == JobStatus::Done
+                   && low->status() == JobStatus::Done
+                   && sweep.isCorrect() && interactive.isCorrect()) == false)
+            testFailed = true;
+
+        JobScheduler::Statistics statistics = scheduler.statistics();
+        size_t h = size_t(JobPriority::High), l = size_t(JobPriority::Low);
+        if (report("statistics", statistics.done[h] == 1
+                   && statistics.done[l] == 1
+                   && statistics.queued[h] == 0
+                   && statistics.running[l] == 0
+                   && statistics.maxWait[h] >= statistics.meanWait[h]
+                   && statistics.meanWait[h] >= 0.0) == false)
+            testFailed = true;
+    }
+
+    // A job that can't start before its deadline is not calculated
+    {
+        JobScheduler scheduler;
+        Batch late(mp, SMALLSIZE);
+        shared_ptr<EvaluationJob> job = scheduler.submit(
+                    program, late.pointers.data(), late.results.data(),
+                    SMALLSIZE, JobPriority::Normal,
+                    JobScheduler::Clock::now() - chrono::milliseconds(1));
+        job->wait();
+        size_t normal = size_t(JobPriority::Normal);
+        if (report("expired job", job->status() == JobStatus::Expired
+                   && late.results[0] == -1.0
+                   && scheduler.statistics().expired[normal] == 1) == false)
+            testFailed = true;
+    }
+
+    // Many jobs of all classes on more workers
+    {
+        ThreadPool pool(4);
+        JobScheduler scheduler(&pool);
+        vector<unique_ptr<Batch>> batches;
+        vector<shared_ptr<EvaluationJob>> jobs;
+        for (size_t i=0; i<30; i++) {
+            size_t size = i % 3 == 2 ? 100000 : 7 + 1000 * i;
+            batches.push_back(unique_ptr<Batch>(new Batch(mp, size)));
+            jobs.push_back(scheduler.submit(
+                               program, batches.back()->pointers.data(),
+                               batches.back()->results.data(), size,
+                               JobPriority(i % 3),
+                               JobScheduler::Clock::now()
+                               + chrono::seconds(60 - i)));
+        }
+        scheduler.waitAll();
+        bool passed = true;
+        for (size_t i=0; i<jobs.size(); i++) {
+            if (jobs[i]->status() != JobStatus::Done
+                    || batches[i]->isCorrect() == false)
+                passed = false;
+        }
+        JobScheduler::Statistics statistics = scheduler.statistics();
+        for (size_t p=0; p<3; p++) {
+            if (statistics.done[p] != 10 || statistics.late[p] != 0)
+                passed = false;
+        }
+        if (report("30 jobs on 4 workers", passed) == false)
+            testFailed = true;
+    }
+    delete mp;
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
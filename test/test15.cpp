@@ -0,0 +1,180 @@
+#define SIZE 300000
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <iomanip>
+#include <string.h>
+#include <atomic>
+#include "pssmathparser.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Columns of one batch and the expected results
+struct Batch {
+    Batch(MathParser *mp, size_t a_size):
+        columns(mp->getVariableSize()),
+        expected(a_size),
+        results(a_size, -1.0)
+    {
+        for (size_t j=0; j<columns.size(); j++) {
+            for (size_t i=0; i<a_size; i++) {
+                columns[j].push_back(0.25 + 1.0e-5 * double(i + 3*j));
+            }
+            pointers.push_back(columns[j].data());
+        }
+        mp->calculateBatch(pointers.data(), expected.data(), a_size);
+    }
+
+    bool isCorrect() const
+    {
+        return memcmp(results.data(), expected.data(),
+                      results.size()*sizeof(double)) == 0;
+    }
+
+    vector<vector<double>> columns;
+    vector<const double *> pointers;
+    vector<double> expected;
+    vector<double> results;
+};
+
+// Prints the result of one test
+bool report(const string &a_name, bool a_passed)
+{
+    cout << a_name << (a_passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+    return a_passed;
+}
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+// Coroutine that starts at once and can't be awaited
+struct Task {
+    struct promise_type {
+        Task get_return_object() { return Task(); }
+        suspend_never initial_suspend() noexcept { return suspend_never(); }
+        suspend_never final_suspend() noexcept { return suspend_never(); }
+        void return_void() {}
+        void unhandled_exception() { terminate(); }
+    };
+};
+
+// Two batches one after the other, then the promise is set
+Task twoBatches(MathParser &a_first, Batch &a_firstBatch,
+                MathParser &a_second, Batch &a_secondBatch,
+                ThreadPool *a_pool, promise<bool> &a_done)
+{
+    co_await calculateBatchAwaitable(a_first, a_firstBatch.pointers.data(),
+                                     a_firstBatch.results.data(),
+                                     a_firstBatch.results.size(), a_pool);
+    bool firstReady = a_firstBatch.isCorrect();
+    co_await calculateBatchAwaitable(a_second, a_secondBatch.pointers.data(),
+                                     a_secondBatch.results.data(),
+                                     a_secondBatch.results.size(), a_pool);
+    a_done.set_value(firstReady && a_secondBatch.isCorrect());
+}
+#endif
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 15 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+
+    MathParser *mp = MathParser::makeMathParser();
+    mp->setMath("x^2/(1+y)-cos(x*y)");
+    MathParser *other = MathParser::makeMathParser();
+    other->setMath("sqrt(x+y+z)*exp(-x)");
+
+    // Futures on the library pool and on an own pool
+    {
+        Batch first(mp, SIZE), second(other, SIZE), small(mp, 10);
+        future<void> a = mp->calculateBatchAsync(first.pointers.data(),
+                                                 first.results.data(), SIZE);
+        ThreadPool pool(2);
+        future<void> b = other->calculateBatchAsync(second.pointers.data(),
+                                                    second.results.data(),
+                                                    SIZE, &pool);
+        future<void> c = mp->calculateBatchAsync(small.pointers.data(),
+                                                 small.results.data(), 10);
+        a.get();
+        b.get();
+        c.get();
+        if (report("futures", first.isCorrect() && second.isCorrect()
+                   && small.isCorrect()) == false)
+            testFailed = true;
+    }
+
+    // The calculation keeps the program of the call
+    {
+        MathParser *changed = mp->clone();
+        Batch batch(changed, SIZE);
+        future<void> done = changed->calculateBatchAsync(
+                    batch.pointers.data(), batch.results.data(), SIZE);
+        changed->setMath("x+y");
+        delete changed;
+        done.wait();
+        if (report("expression changed after the call",
+                   batch.isCorrect()) == false)
+            testFailed = true;
+    }
+
+    // Callbacks of many calls
+    {
+        vector<unique_ptr<Batch>> batches;
+        atomic<int> calls(0), errors(0);
+        promise<void> allDone;
+        const int count = 20;
+        for (int i=0; i<count; i++) {
+            batches.push_back(unique_ptr<Batch>(new Batch(mp, 1000 * i)));
+        }
+        for (int i=0; i<count; i++) {
+            mp->calculateBatchAsync(batches[i]->pointers.data(),
+                                    batches[i]->results.data(),
+                                    batches[i]->results.size(),
+                                    [&](exception_ptr a_error) {
+                if (a_error)
+                    errors++;
+                if (++calls == count)
+                    allDone.set_value();
+            });
+        }
+        allDone.get_future().wait();
+        bool passed = errors == 0;
+        for (int i=0; i<count; i++) {
+            if (batches[i]->isCorrect() == false)
+                passed = false;
+        }
+        if (report("callbacks", passed) == false)
+            testFailed = true;
+    }
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+    // Coroutine with two co_await
+    {
+        Batch first(mp, SIZE), second(other, SIZE);
+        ThreadPool pool(3);
+        promise<bool> done;
+        future<bool> result = done.get_future();
+        twoBatches(*mp, first, *other, second, &pool, done);
+        if (report("coroutine", result.get()) == false)
+            testFailed = true;
+    }
+#else
+    cout << "coroutine: TEST SKIPPED, needs C++20" << endl;
+#endif
+    delete mp;
+    delete other;
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
@@ -0,0 +1,169 @@
+#define SIZE 1000000
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <iomanip>
+#include <string.h>
+#include "pssmathparser.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Prints the result of one test
+bool report(const string &a_name, bool a_passed)
+{
+    cout << a_name << (a_passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+    return a_passed;
+}
+
+// The first a_done results are as expected and the others are untouched
+bool checkResults(const vector<double> &a_results,
+                  const vector<double> &a_expected, size_t a_done)
+{
+    if (memcmp(a_results.data(), a_expected.data(),
+               a_done*sizeof(double)) != 0) {
+        cout << "  - wrong results before row " << a_done << endl;
+        return false;
+    }
+    for (size_t i=a_done; i<a_results.size(); i++) {
+        if (a_results[i] != -1.0) {
+            cout << "  - row " << i << " is changed" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 16 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+
+    MathParser *mp = MathParser::makeMathParser();
+    mp->setMath("sin(x)*y+z/3");
+    vector<vector<double>> columns(3, vector<double>(SIZE));
+    for (size_t i=0; i<SIZE; i++) {
+        columns[0][i] = 0.001 * double(i);
+        columns[1][i] = 1.0 + 1.0e-6 * double(i);
+        columns[2][i] = -2.0 * double(i);
+    }
+    const double *pointers[] = { columns[0].data(), columns[1].data(),
+                                 columns[2].data() };
+    vector<double> expected(SIZE);
+    mp->calculateBatch(pointers, expected.data(), SIZE);
+    const size_t chunk = ThreadPool::chunkSize(3);
+
+    // Without a cancel all the rows are calculated and reported
+    {
+        vector<double> results(SIZE, -1.0);
+        vector<size_t> reports;
+        size_t done = mp->calculateBatch(pointers, results.data(), SIZE,
+                                         BatchControl(nullptr,
+                                                      [&](size_t a_done,
+                                                          size_t a_size) {
+            if (a_size == SIZE)
+                reports.push_back(a_done);
+        }));
+        bool passed = done == SIZE && reports.size() == (SIZE + chunk - 1)
+                / chunk && reports.back() == SIZE
+                && checkResults(results, expected, SIZE);
+        for (size_t i=1; i<reports.size(); i++) {
+            if (reports[i] <= reports[i - 1])
+                passed = false;
+        }
+        if (report("batch with progress", passed) == false)
+            testFailed = true;
+    }
+
+    // Cancelled from the progress after three chunks
+    {
+        vector<double> results(SIZE, -1.0);
+        CancellationToken stop;
+        size_t done = mp->calculateBatch(pointers, results.data(), SIZE,
+                                         BatchControl(&stop,
+                                                      [&](size_t a_done,
+                                                          size_t) {
+            if (a_done >= 3 * chunk)
+                stop.cancel();
+        }));
+        if (report("cancelled batch", done == 3 * chunk
+                   && checkResults(results, expected, done)) == false)
+            testFailed = true;
+
+        // The same token after a reset
+        stop.reset();
+        done = mp->calculateBatch(pointers, results.data(), SIZE,
+                                  BatchControl(&stop));
+        if (report("token reset", done == SIZE
+                   && checkResults(results, expected, SIZE)) == false)
+            testFailed = true;
+
+        // A cancelled token calculates nothing
+        stop.cancel();
+        vector<double> none(SIZE, -1.0);
+        done = mp->calculateBatchParallel(pointers, none.data(), SIZE,
+                                          BatchControl(&stop));
+        if (report("cancelled before the start", done == 0
+                   && checkResults(none, expected, 0)) == false)
+            testFailed = true;
+    }
+
+    // Parallel calculation cancelled from the progress and from a thread
+    const unsigned sizes[] = { 1, 4 };
+    for (unsigned size : sizes) {
+        ThreadPool pool(size);
+        vector<double> results(SIZE, -1.0);
+        CancellationToken stop;
+        size_t last = 0;
+        bool increasing = true;
+        size_t done = mp->calculateBatchParallel(
+                    pointers, results.data(), SIZE,
+                    BatchControl(&stop, [&](size_t a_done, size_t) {
+            if (a_done <= last)
+                increasing = false;
+            last = a_done;
+            if (a_done >= 10 * chunk)
+                stop.cancel();
+        }), &pool);
+        if (report("parallel cancel on " + to_string(size) + " threads",
+                   increasing && done >= 10 * chunk
+                   && done < SIZE && done % chunk == 0
+                   && checkResults(results, expected, done)) == false)
+            testFailed = true;
+
+        results.assign(SIZE, -1.0);
+        stop.reset();
+        thread canceller([&stop]() { stop.cancel(); });
+        done = mp->calculateBatchParallel(pointers, results.data(), SIZE,
+                                          BatchControl(&stop), &pool);
+        canceller.join();
+        if (report("cancel from a thread on " + to_string(size) + " threads",
+                   (done % chunk == 0 || done == SIZE)
+                   && checkResults(results, expected, done)) == false)
+            testFailed = true;
+
+        stop.reset();
+        done = mp->calculateBatchParallel(pointers, results.data(), SIZE,
+                                          BatchControl(&stop), &pool);
+        if (report("parallel without cancel on " + to_string(size)
+                   + " threads", done == SIZE
+                   && checkResults(results, expected, SIZE)) == false)
+            testFailed = true;
+    }
+    delete mp;
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
@@ -0,0 +1,147 @@
+#define READERS 4
+#define WRITERS 2
+#define VERSIONS 500
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <iomanip>
+#include <string.h>
+#include "pssmathparser.h"
+#include "pssmathhandle.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Prints the result of one test
+bool report(const string &a_name, bool a_passed)
+{
+    cout << a_name << (a_passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+    return a_passed;
+}
+
+// What one reader thread saw
+struct ReaderLog {
+    ReaderLog(): calculations(0), switches(0), errors(0) {}
+
+    size_t calculations;
+    size_t switches;
+    size_t errors;
+};
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 17 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+
+    vector<weak_ptr<const Program>> published;
+    mutex publishedMutex;
+    {
+        MathExpression first;
+        first.setMath("x+0");
+        ProgramHandle handle(first.program());
+        published.push_back(first.program());
+
+        // Readers calculate x+k and check that k is one of the published
+        atomic<bool> stop(false);
+        atomic<int> nextK(1);
+        vector<ReaderLog> logs(READERS);
+        vector<thread> readers;
+        for (int r=0; r<READERS; r++) {
+            readers.push_back(thread([&, r]() {
+                ProgramReader reader(handle);
+                ReaderLog &log = logs[r];
+                uint64_t version = 0;
+                for (size_t i=0; stop == false; i++) {
+                    EvaluationContext &context = reader.context();
+                    if (reader.version() < version)
+                        log.errors++;
+                    if (reader.version() != version)
+                        log.switches++;
+                    version = reader.version();
+                    double x = 0.5 * double(i % 1000);
+                    double k = context.calculate(&x) - x;
+                    if (context.variableSize() != 1 || k != floor(k)
+                            || k < 0 || k >= nextK)
+                        log.errors++;
+                    log.calculations++;
+                }
+            }));
+        }
+
+        // Writers compile and publish new versions
+        vector<thread> writers;
+        for (int w=0; w<WRITERS; w++) {
+            writers.push_back(thread([&]() {
+                MathExpression mp;
+                for (int v=0; v<VERSIONS; v++) {
+                    int k = nextK++;
+                    mp.setMath("x+" + to_string(k));
+                    shared_ptr<const Program> program = mp.program();
+                    {
+                        lock_guard<mutex> lock(publishedMutex);
+                        published.push_back(program);
+                    }
+                    handle.publish(program);
+                    this_thread::yield();
+                }
+            }));
+        }
+        for (thread &writer : writers) {
+            writer.join();
+        }
+        stop = true;
+        for (thread &reader : readers) {
+            reader.join();
+        }
+
+        size_t calculations = 0, switches = 0, errors = 0;
+        for (const ReaderLog &log : logs) {
+            calculations += log.calculations;
+            switches += log.switches;
+            errors += log.errors;
+        }
+        cout << "  - " << calculations << " calculations, " << switches
+             << " version switches" << endl;
+        if (report("readers see whole versions", errors == 0
+                   && handle.version() == 1 + WRITERS * VERSIONS
+                   && switches > READERS) == false)
+            testFailed = true;
+        if (report("retired versions freed", handle.retiredSize() == 0)
+                == false)
+            testFailed = true;
+
+        // The last version is read after the readers have gone
+        ProgramReader last(handle);
+        EvaluationContext loaded(handle.load());
+        double x = 1.0;
+        if (report("last version", last.version() == 0
+                   && last.context().calculate(&x) == loaded.calculate(&x)
+                   && last.version() == handle.version()) == false)
+            testFailed = true;
+    }
+
+    // Nothing holds the programs after the handle
+    size_t alive = 0;
+    for (const weak_ptr<const Program> &program : published) {
+        if (program.expired() == false)
+            alive++;
+    }
+    if (report("programs freed", alive == 0
+               && published.size() == 1 + WRITERS * VERSIONS) == false)
+        testFailed = true;
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
@@ -0,0 +1,160 @@
+#define SIZE 200000
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <iomanip>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include "pssmathparser.h"
+#include "pssmathprocess.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Prints the result of one test
+bool report(const string &a_name, bool a_passed)
+{
+    cout << a_name << (a_passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+    return a_passed;
+}
+
+// Results of the interpreter in this process
+vector<double> expected(const shared_ptr<const Program> &a_program,
+                        const double *const *a_variables, size_t a_size)
+{
+    vector<double> results(a_size);
+    EvaluationContext context(a_program);
+    context.calculateBatch(a_variables, results.data(), a_size);
+    return results;
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 18 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+
+    MathParser *mp = MathParser::makeMathParser();
+    mp->setMath("sin(x)*y^2+exp(y-x)-sqrt(y)/cos(x)");
+    shared_ptr<const Program> program = mp->program();
+    vector<double> x(SIZE), y(SIZE);
+    for (size_t i=0; i<SIZE; i++) {
+        x[i] = 1.0e-4 * double(i) - 3.0;
+        y[i] = 0.5 + 1.0e-5 * double(i);
+    }
+    const double *columns[] = { x.data(), y.data() };
+    vector<double> reference = expected(program, columns, SIZE);
+
+    ProcessPool pool(3);
+    if (report("process pool", pool.isValid() && pool.size() == 3) == false)
+        testFailed = true;
+
+    // Copies the columns of the caller
+    {
+        vector<double> results(SIZE, -1.0);
+        bool done = pool.calculateBatch(program, columns, results.data(),
+                                        SIZE);
+        vector<int> pids = pool.processIds();
+        bool forked = true;
+        for (int pid : pids) {
+            if (pid <= 0 || pid == getpid())
+                forked = false;
+        }
+        if (report("copied columns", done && forked
+                   && memcmp(results.data(), reference.data(),
+                             SIZE*sizeof(double)) == 0) == false)
+            testFailed = true;
+    }
+
+    // The columns are filled in the shared memory
+    {
+        pool.reserve(2, SIZE);
+        memcpy(pool.column(0), x.data(), SIZE*sizeof(double));
+        memcpy(pool.column(1), y.data(), SIZE*sizeof(double));
+        vector<int> pids = pool.processIds();
+        bool done = pool.calculateBatch(program, SIZE);
+        bool passed = done && pids == pool.processIds()
+                && memcmp(pool.results(), reference.data(),
+                          SIZE*sizeof(double)) == 0;
+
+        // Another program on the same columns and fewer rows
+        mp->setMath("x-y*3");
+        shared_ptr<const Program> other = mp->program();
+        vector<double> otherReference = expected(other, columns, 1001);
+        done = pool.calculateBatch(other, 1001);
+        if (report("shared columns", passed && done
+                   && memcmp(pool.results(), otherReference.data(),
+                             1001*sizeof(double)) == 0) == false)
+            testFailed = true;
+    }
+
+    // A worker dies during the calculation
+    {
+        vector<int> pids = pool.processIds();
+        kill(pids[1], SIGSTOP);
+        thread killer([&pids]() {
+            this_thread::sleep_for(chrono::milliseconds(100));
+            kill(pids[1], SIGKILL);
+        });
+        vector<double> results(SIZE, -1.0);
+        bool done = pool.calculateBatch(program, columns, results.data(),
+                                        SIZE);
+        killer.join();
+        vector<ProcessPool::Shard> failed = pool.failedShards();
+        bool passed = done == false && failed.size() == 1
+                && failed[0].first > 0 && failed[0].second < SIZE;
+        for (size_t i=0; passed && i<SIZE; i++) {
+            bool inFailed = i >= failed[0].first && i < failed[0].second;
+            if (inFailed ? results[i] != -1.0
+                         : memcmp(&results[i], &reference[i],
+                                  sizeof(double)) != 0)
+                passed = false;
+        }
+        if (report("dead worker", passed) == false)
+            testFailed = true;
+
+        // The worker is forked again
+        done = pool.calculateBatch(program, columns, results.data(), SIZE);
+        vector<int> newPids = pool.processIds();
+        if (report("worker restarted", done && pool.failedShards().empty()
+                   && newPids[0] == pids[0] && newPids[1] != pids[1]
+                   && newPids[1] > 0
+                   && memcmp(results.data(), reference.data(),
+                             SIZE*sizeof(double)) == 0) == false)
+            testFailed = true;
+    }
+
+    // The workers exit with the pool
+    {
+        vector<int> pids;
+        {
+            ProcessPool small(2);
+            vector<double> results(SIZE);
+            small.calculateBatch(program, columns, results.data(), SIZE);
+            pids = small.processIds();
+        }
+        bool passed = true;
+        for (int pid : pids) {
+            if (pid <= 0 || kill(pid, 0) == 0)
+                passed = false;
+        }
+        if (report("workers stopped", passed) == false)
+            testFailed = true;
+    }
+    delete mp;
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
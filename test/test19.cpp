@@ -0,0 +1,135 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include "pssmathparser.h"
+#include "pssmathcache.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Prints the result of one test
+bool report(const string &a_name, bool a_passed)
+{
+    cout << a_name << (a_passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+    return a_passed;
+}
+
+// Value of a compiled expression of x
+double evaluate(const CompiledExpression &a_compiled, double a_x)
+{
+    EvaluationContext context(a_compiled.program);
+    if (a_compiled.variableNames.empty() == false)
+        context.setVariable(0, a_x);
+    return context.calculate();
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 19 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+
+    // The text is normalized as the parser reads it
+    if (report("normalize", ProgramCache::normalize(" x -\t- y") == "x+y"
+               && ProgramCache::normalize("2*-+-x") == "2*+x"
+               && ProgramCache::normalize("a + - b") == "a-b") == false)
+        testFailed = true;
+
+    // Equivalent texts share one program
+    {
+        ProgramCache cache(3);
+        CompiledExpression first = cache.compile("sin(x) * 2 - -1");
+        CompiledExpression second = cache.compile("sin(x)*2+1");
+        ProgramCache::Statistics statistics = cache.statistics();
+        if (report("hit", first.program != nullptr
+                   && first.program == second.program
+                   && second.variableNames == first.variableNames
+                   && evaluate(second, 0.5) == sin(0.5)*2+1
+                   && statistics.hits == 1 && statistics.misses == 1
+                   && statistics.size == 1) == false)
+            testFailed = true;
+
+        // The least recently used is evicted
+        cache.compile("x+1");
+        cache.compile("x+2");
+        cache.compile("sin(x)*2+1");
+        cache.compile("x+3");
+        statistics = cache.statistics();
+        CompiledExpression again = cache.compile("sin(x)*2+1");
+        bool kept = cache.statistics().hits == statistics.hits + 1;
+        cache.compile("x+1");
+        if (report("eviction", kept && statistics.evictions == 1
+                   && statistics.size == 3 && again.program == first.program
+                   && cache.statistics().misses == statistics.misses + 1)
+                == false)
+            testFailed = true;
+
+        // Errors are cached too
+        CompiledExpression error = cache.compile("(x+1");
+        CompiledExpression errorAgain = cache.compile("( x + 1");
+        if (report("error", error.program == nullptr
+                   && errorAgain.program == nullptr
+                   && error.expressionError != 0
+                   && errorAgain.expressionError == error.expressionError
+                   && errorAgain.errorString == error.errorString
+                   && cache.statistics().hits == statistics.hits + 2)
+                == false)
+            testFailed = true;
+
+        // A smaller capacity evicts at once
+        cache.setCapacity(1);
+        statistics = cache.statistics();
+        cache.clear();
+        if (report("capacity", cache.capacity() == 1 && statistics.size == 1
+                   && cache.statistics().size == 0
+                   && cache.statistics().hits == 0) == false)
+            testFailed = true;
+    }
+
+    // Many threads look up a working set bigger than the cache
+    {
+        ProgramCache &cache = ProgramCache::instance();
+        cache.setCapacity(8);
+        atomic<bool> wrong(false);
+        vector<thread> threads;
+        for (int t=0; t<8; t++) {
+            threads.emplace_back([&cache, &wrong, t]() {
+                for (int i=0; i<2000; i++) {
+                    int k = (i * 7 + t) % 12;
+                    ostringstream text;
+                    text << "x * " << k << " + " << k;
+                    CompiledExpression compiled = cache.compile(text.str());
+                    if (compiled.program == nullptr
+                            || evaluate(compiled, 2.0) != 3.0 * k)
+                        wrong = true;
+                }
+            });
+        }
+        for (thread &t : threads)
+            t.join();
+        ProgramCache::Statistics statistics = cache.statistics();
+        if (report("concurrent", wrong == false
+                   && &cache == &ProgramCache::instance()
+                   && statistics.hits + statistics.misses == 16000
+                   && statistics.size <= 8 && statistics.evictions > 0
+                   && statistics.misses >= statistics.evictions) == false)
+            testFailed = true;
+    }
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
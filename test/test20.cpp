@@ -0,0 +1,168 @@
+#include <iostream>
+#include <string>
+#include <cmath>
+#include "pssmathparser.h"
+#include "pssmathshare.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Prints the result of one test
+bool report(const string &a_name, bool a_passed)
+{
+    cout << a_name << (a_passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+    return a_passed;
+}
+
+// Instructions of the expression
+InstructionStream stream(MathExpression &a_parser)
+{
+    return a_parser.program()->instructionStream();
+}
+
+// Value of the expression for the variables in order
+double value(MathExpression &a_parser, double a_x, double a_y = 0.0)
+{
+    if (a_parser.getVariableSize() > 0)
+        a_parser.setVariableDouble(a_parser.getVariableName(0), a_x);
+    if (a_parser.getVariableSize() > 1)
+        a_parser.setVariableDouble(a_parser.getVariableName(1), a_y);
+    return a_parser.calculateExpression();
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 20 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+
+    // Commuted operands and other constants give the same instructions
+    {
+        MathExpression a, b, c, d;
+        a.setMath("2.0*x");
+        b.setMath("x*2");
+        c.setMath("x * 3");
+        d.setMath("x+2");
+        if (report("commutative", stream(a) == stream(b)
+                   && stream(a) == stream(c) && stream(a) != stream(d)
+                   && value(a, 1.5) == 3.0 && value(b, 1.5) == 3.0
+                   && value(c, 1.5) == 4.5 && value(d, 1.5) == 3.5)
+                == false)
+            testFailed = true;
+    }
+
+    // Deeper trees and the order of the variables
+    {
+        MathExpression a, b, c, d;
+        a.setMath("sin(x)*y+1");
+        b.setMath("1+y*sin(x)");
+        c.setMath("x-2");
+        d.setMath("2-x");
+        double x = 0.7, y = -1.3;
+        bool passed = stream(a) != stream(b) && stream(c) != stream(d)
+                && value(a, x, y) == sin(x)*y+1
+                && value(b, y, x) == 1+y*sin(x)
+                && value(c, x) == x-2 && value(d, x) == 2-x;
+        // Same variables in the same order
+        MathExpression e;
+        e.setMath("1+sin(x)*y");
+        passed = passed && stream(a) == stream(e)
+                && value(e, x, y) == sin(x)*y+1;
+        if (report("structure", passed) == false)
+            testFailed = true;
+    }
+
+    // The canonical program calculates like the parsed one
+    {
+        const char *formulas[] = { "x*y+y*x", "(x+1)*(1+x)-x/y",
+                                   "x^y+2^x*3", "exp(-x)*cos(y)/2" };
+        bool passed = true;
+        for (const char *formula : formulas) {
+            MathExpression parser;
+            parser.setMath(formula);
+            shared_ptr<const Program> program = parser.program();
+            vector<Instruction> instructions = program->instructions();
+            vector<uint32_t> slots;
+            uint32_t resultSlot = program->resultSlot();
+            passed = passed && InstructionPool::canonicalize(
+                        instructions, slots,
+                        uint32_t(program->values().size()),
+                        program->variableSize(), resultSlot)
+                    && InstructionPool::structuralHash(instructions)
+                    == InstructionPool::structuralHash(
+                        program->instructions());
+            EvaluationContext context(program);
+            for (double x = 0.1; x < 4.0; x += 0.37) {
+                double y = 0.5 + x * x;
+                context.setVariable(0, x);
+                context.setVariable(1, y);
+                if (context.calculate() != value(parser, x, y))
+                    passed = false;
+            }
+        }
+        // A slot written twice is not canonical
+        vector<Instruction> twice = {
+            { OpCode::Add, 0, 1, 2, nullptr, nullptr },
+            { OpCode::Add, 2, 1, 2, nullptr, nullptr } };
+        vector<uint32_t> slots;
+        passed = passed && InstructionPool::canonicalize(twice, slots, 3, 1,
+                                                         2) == false
+                && twice[1].arg1 == 2 && slots.empty();
+        if (report("canonical", passed) == false)
+            testFailed = true;
+    }
+
+    // Thousands of parsers keep one copy of the instructions
+    {
+        InstructionPool::Statistics before =
+                InstructionPool::instance().statistics();
+        vector<MathExpression> parsers(2000);
+        for (size_t i = 0; i < parsers.size(); i++) {
+            parsers[i].setMath(to_string(i % 7) + ".5*x+sin(y)*"
+                               + to_string(i));
+        }
+        InstructionStream shared = stream(parsers[0]);
+        bool passed = true;
+        for (size_t i = 0; i < parsers.size(); i++) {
+            if (stream(parsers[i]) != shared
+                    || value(parsers[i], 0.25, 2.0)
+                    != (double(i % 7) + 0.5)*0.25 + sin(2.0)*double(i))
+                passed = false;
+        }
+        MathExpression copy(parsers[1]);
+        InstructionPool::Statistics after =
+                InstructionPool::instance().statistics();
+        size_t bytes = shared->size() * sizeof(Instruction);
+        if (report("shared", passed && stream(copy) == shared
+                   && after.streams == before.streams + 1
+                   && after.bytesSaved >= before.bytesSaved + 2000 * bytes)
+                == false)
+            testFailed = true;
+        cout << "  - " << after.streams << " streams, " << after.references
+             << " owners, " << after.bytes << " bytes, " << after.bytesSaved
+             << " bytes saved" << endl;
+    }
+
+    // The streams are freed with the programs
+    {
+        InstructionPool::Statistics statistics =
+                InstructionPool::instance().statistics();
+        if (report("freed", statistics.streams == 0
+                   && statistics.bytesSaved == 0) == false)
+            testFailed = true;
+    }
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
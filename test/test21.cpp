@@ -0,0 +1,170 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <random>
+#include <string.h>
+#include "pssmathparser.h"
+#include "pssmathincremental.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Prints the result of one test
+bool report(const string &a_name, bool a_passed)
+{
+    cout << a_name << (a_passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+    return a_passed;
+}
+
+// Expression of twenty variables, every one in its own terms
+string twentyVariables()
+{
+    string expression;
+    for (char c = 'a'; c < 'a' + 20; c++) {
+        string v = string("x") + c;
+        if (expression.empty() == false)
+            expression += "+";
+        expression += "sin(" + v + ")*cos(" + v + "/2)^2+exp(" + v + "/7)"
+                + "-sqrt(" + v + "*" + v + "+1)/3";
+    }
+    return expression + "*xa";
+}
+
+// Bitwise comparison of two results
+bool same(double a_first, double a_second)
+{
+    return memcmp(&a_first, &a_second, sizeof(double)) == 0;
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 21 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+    const string expression = twentyVariables();
+
+    MathExpression full, incremental;
+    full.setMath(expression);
+    incremental.setMath(expression);
+    const uint16_t variableSize = incremental.getVariableSize();
+    if (report("backend", variableSize == 20
+               && incremental.setBackend(EvaluationBackend::Incremental)
+               && incremental.backend() == EvaluationBackend::Incremental)
+            == false)
+        testFailed = true;
+
+    // Few instructions depend on one variable, its terms and the sums after
+    {
+        shared_ptr<const Program> program = full.program();
+        IncrementalSchedule schedule(program->instructionStream(),
+                                     program->variableSize(),
+                                     program->resultSlot());
+        size_t size = program->instructions().size();
+        bool passed = schedule.variableSize() == 20;
+        for (uint32_t v = 1; v < 20; v++) {
+            if (schedule.dependentSize(v) == 0
+                    || schedule.dependentSize(v) * 3 > size)
+                passed = false;
+        }
+        // The first variable is also in the last product
+        passed = passed && schedule.dependentSize(0) > schedule.dependentSize(1);
+        cout << "  - " << size << " instructions, " << schedule.dependentSize(1)
+             << " depend on " << full.getVariableName(1) << endl;
+        if (report("dependents", passed) == false)
+            testFailed = true;
+    }
+
+    // Random updates give the results of the whole program
+    {
+        mt19937 random(7);
+        uniform_real_distribution<double> value(-3.0, 3.0);
+        uniform_int_distribution<int> variable(0, variableSize - 1);
+        uniform_int_distribution<int> count(0, 3);
+        vector<double> values(variableSize, 0.0);
+        bool passed = true;
+        for (int step = 0; step < 2000; step++) {
+            int changes = step % 10 == 0 ? count(random) : 1;
+            for (int c = 0; c < changes; c++) {
+                uint16_t v = uint16_t(variable(random));
+                string name = full.getVariableName(v);
+                double x = value(random);
+                values[v] = x;
+                full.setVariableDouble(name, x);
+                incremental.setVariableDouble(name, x);
+            }
+            // The same value doesn't make the variable changed
+            if (step % 7 == 0) {
+                incremental.setVariableDouble(full.getVariableName(3),
+                                              values[3]);
+            }
+            if (same(full.calculateExpression(),
+                     incremental.calculateExpression()) == false)
+                passed = false;
+
+            // A copy keeps the previous calculation
+            if (step == 1000) {
+                MathExpression copy(incremental);
+                copy.setVariableDouble("xc", 0.25);
+                full.setVariableDouble("xc", 0.25);
+                passed = passed && same(copy.calculateExpression(),
+                                        full.calculateExpression());
+                incremental.setVariableDouble("xc", 0.25);
+                values[2] = 0.25;
+            }
+        }
+        if (report("updates", passed) == false)
+            testFailed = true;
+    }
+
+    // Negative zero after zero changes the sign of 1/x
+    {
+        MathExpression reciprocal;
+        reciprocal.setMath("1/x");
+        reciprocal.setBackend(EvaluationBackend::Incremental);
+        reciprocal.setVariableDouble("x", 0.0);
+        double positive = reciprocal.calculateExpression();
+        reciprocal.setVariableDouble("x", -0.0);
+        double negative = reciprocal.calculateExpression();
+        if (report("negative zero", positive > 0.0 && negative < 0.0) == false)
+            testFailed = true;
+    }
+
+    // One fast input, the others rarely change
+    {
+        const int calculations = 20000;
+        double fullSum = 0.0, incrementalSum = 0.0;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < calculations; i++) {
+            full.setVariableDouble("xk", 1.0e-4 * i);
+            fullSum += full.calculateExpression();
+        }
+        auto middle = chrono::steady_clock::now();
+        for (int i = 0; i < calculations; i++) {
+            incremental.setVariableDouble("xk", 1.0e-4 * i);
+            incrementalSum += incremental.calculateExpression();
+        }
+        auto end = chrono::steady_clock::now();
+        double fullTime = chrono::duration<double>(middle - start).count();
+        double incrementalTime = chrono::duration<double>(end - middle).count();
+        cout << "  - whole program " << fullTime * 1.0e9 / calculations
+             << " ns, incremental " << incrementalTime * 1.0e9 / calculations
+             << " ns" << endl;
+        if (report("speedup", same(fullSum, incrementalSum)
+                   && incrementalTime * 2 < fullTime) == false)
+            testFailed = true;
+    }
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
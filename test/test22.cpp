@@ -0,0 +1,190 @@
+#include <iostream>
+#include <string>
+#include <cmath>
+#include "pssmathparser.h"
+#include "pssmathgraph.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Prints the result of one test
+bool report(const string &a_name, bool a_passed)
+{
+    cout << a_name << (a_passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+    return a_passed;
+}
+
+// Thermal voltage calculated by one parser
+double thermalVoltage(double a_tc)
+{
+    MathExpression parser;
+    parser.setMath("kBJ*(ToK+TC)/qe");
+    parser.setVariableDouble("TC", a_tc);
+    return parser.calculateExpression();
+}
+
+// Power of the diode from the thermal voltage
+double power(double a_io, double a_v, double a_tc)
+{
+    return a_io * (exp(a_v / thermalVoltage(a_tc)) - 1) * a_v;
+}
+
+// Name made of letters, the parser reads digits as numbers
+string letters(int a_index)
+{
+    string name;
+    do {
+        name.insert(name.begin(), char('a' + a_index % 26));
+        a_index /= 26;
+    } while (a_index > 0);
+    return name;
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 22 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+
+    // Expressions read the results of the expressions defined before
+    ExpressionGraph graph;
+    bool defined = graph.define("Vt", "kBJ*(ToK+TC)/qe")
+            && graph.define("I", "Io*(exp(V/Vt)-1)")
+            && graph.define("P", "I*V");
+    graph.setVariables({ { "Io", 1.0e-12 }, { "V", 0.6 }, { "TC", 25.0 } });
+    if (report("define", defined && graph.isExpression("Vt")
+               && graph.isExpression("TC") == false
+               && graph.value("Vt") == thermalVoltage(25.0)
+               && graph.value("P") == power(1.0e-12, 0.6, 25.0)
+               && graph.readers("Vt") == vector<string>{ "I" }
+               && graph.readers("V") == vector<string>({ "I", "P" })
+               && graph.define("ToK", "300") == false)
+            == false)
+        testFailed = true;
+
+    // Names that can't be defined
+    {
+        ExpressionGraph other;
+        bool passed = other.define("a", "b+1")
+                && other.define("a", "2") == false
+                && other.errorString().empty() == false
+                && other.define("b", "3") == false
+                && other.define("c", "c*2") == false
+                && other.define("d", "(1+") == false
+                && other.setVariable("a", 1.0) == false
+                && other.define("e", "a*2") && other.value("e") == 2.0;
+        if (report("errors", passed) == false)
+            testFailed = true;
+    }
+
+    // Only the readers of the variable are calculated and notified
+    {
+        vector<pair<string, double>> notified;
+        size_t id = graph.subscribe("P", [&notified](const string &a_name,
+                                                      double a_value) {
+            notified.emplace_back(a_name, a_value);
+        });
+        ExpressionGraph::Statistics before = graph.statistics();
+        graph.setVariable("V", 0.65);
+        ExpressionGraph::Statistics after = graph.statistics();
+        double p = power(1.0e-12, 0.65, 25.0);
+        bool passed = id != 0 && after.calculations == before.calculations + 2
+                && notified.size() == 1 && notified[0].first == "P"
+                && notified[0].second == p;
+
+        // The same value changes nothing
+        graph.setVariable("V", 0.65);
+        passed = passed && graph.statistics().calculations
+                == after.calculations && notified.size() == 1;
+
+        // A change of TC goes through Vt and I to P
+        graph.setVariable("TC", 30.0);
+        p = power(1.0e-12, 0.65, 30.0);
+        passed = passed && notified.size() == 2 && notified[1].second == p
+                && graph.statistics().calculations == after.calculations + 3;
+
+        // Many changes at once notify once
+        graph.beginUpdate();
+        graph.setVariable("TC", 35.0);
+        graph.setVariable("V", 0.7);
+        graph.setVariable("Io", 2.0e-12);
+        bool deferred = notified.size() == 2;
+        graph.endUpdate();
+        passed = passed && deferred && notified.size() == 3
+                && notified[2].second == power(2.0e-12, 0.7, 35.0)
+                && graph.statistics().calculations == after.calculations + 6;
+
+        graph.unsubscribe(id);
+        graph.setVariable("V", 0.5);
+        passed = passed && notified.size() == 3
+                && graph.statistics().notifications == 3;
+        if (report("propagation", passed) == false)
+            testFailed = true;
+    }
+
+    // Thousands of expressions share one input
+    {
+        ExpressionGraph big;
+        bool passed = big.define("k", "TC*2");
+        for (int i = 0; i < 2000; i++) {
+            string name = "r" + letters(i);
+            string input = i % 100 == 0 ? string("k") : "u" + letters(i);
+            passed = passed && big.define(name, input + "*" + to_string(i)
+                                          + "+sin(" + input + ")");
+        }
+        size_t notified = 0;
+        for (int i = 0; i < 2000; i += 100) {
+            big.subscribe("r" + letters(i),
+                          [&notified](const string &, double) { notified++; });
+        }
+        ExpressionGraph::Statistics before = big.statistics();
+        big.setVariable("TC", 1.5);
+        ExpressionGraph::Statistics after = big.statistics();
+        passed = passed && after.calculations == before.calculations + 21
+                && notified == 20
+                && big.value("r" + letters(300)) == 3.0 * 300 + sin(3.0)
+                && big.value("r" + letters(301)) == 0.0;
+        if (report("shared input", passed) == false)
+            testFailed = true;
+    }
+
+    // A subscriber sets a variable during the propagation
+    {
+        ExpressionGraph loop;
+        loop.define("a", "x+1");
+        loop.define("b", "y*2");
+        loop.subscribe("a", [&loop](const string &, double a_value) {
+            loop.setVariable("y", a_value);
+        });
+        loop.setVariable("x", 4.0);
+        if (report("reentrant", loop.value("b") == 10.0) == false)
+            testFailed = true;
+    }
+
+    // Negative zero is a change, of the sign of the readers
+    {
+        ExpressionGraph sign;
+        sign.define("r", "1/x");
+        sign.define("s", "r*2");
+        sign.setVariable("x", 0.0);
+        bool passed = sign.value("s") > 0.0;
+        sign.setVariable("x", -0.0);
+        passed = passed && sign.value("s") < 0.0;
+        if (report("negative zero", passed) == false)
+            testFailed = true;
+    }
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
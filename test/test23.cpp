@@ -0,0 +1,160 @@
+#include <iostream>
+#include <string>
+#include <cmath>
+#include "pssmathparser.h"
+#include "pssmathlink.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Prints the result of one test
+bool report(const string &a_name, bool a_passed)
+{
+    cout << a_name << (a_passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+    return a_passed;
+}
+
+// Value of a linked expression with the values of its variables in order
+double evaluate(const CompiledExpression &a_compiled,
+                const vector<double> &a_values)
+{
+    EvaluationContext context(a_compiled.program);
+    for (size_t v = 0; v < a_values.size(); v++)
+        context.setVariable(uint32_t(v), a_values[v]);
+    return context.calculate();
+}
+
+// Value of the expression calculated by one parser
+double parse(const string &a_expression,
+             const vector<pair<string, double>> &a_values)
+{
+    MathExpression parser;
+    parser.setMath(a_expression);
+    for (const auto &ivalue : a_values)
+        parser.setVariableDouble(ivalue.first, ivalue.second);
+    return parser.calculateExpression();
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 23 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+
+    // The definition is inlined, its variables follow the ones before it
+    ExpressionLinker linker;
+    bool passed = linker.define("Vt", "kBJ*(ToK+TC)/qe")
+            && linker.isDefined("Vt") && linker.isDefined("TC") == false;
+    CompiledExpression diode = linker.link("Io*(exp(V/Vt)-1)");
+    passed = passed && diode.program != nullptr
+            && diode.variableNames
+            == vector<string>({ "Io", "V", "TC" })
+            && linker.statistics().inlined == 1;
+    for (double tc = -40.0; passed && tc < 125.0; tc += 7.5) {
+        double linked = evaluate(diode, { 1.0e-12, 0.6, tc });
+        double pasted = parse("Io*(exp(V/(kBJ*(ToK+TC)/qe))-1)",
+                              { { "Io", 1.0e-12 }, { "V", 0.6 },
+                                { "TC", tc } });
+        passed = linked == pasted;
+    }
+    if (report("inline", passed) == false)
+        testFailed = true;
+
+    // Constants are calculated when linking, also across definitions
+    {
+        ExpressionLinker folding;
+        folding.define("two", "1+1");
+        folding.define("half", "1/two");
+        CompiledExpression linked = folding.link("x*two+half");
+        bool passed = linked.program != nullptr
+                && folding.statistics().folded == 2
+                && evaluate(linked, { 3.0 }) == 6.5;
+        MathExpression parser;
+        CompiledExpression plain = parser.compile("y*5");
+        CompiledExpression product = folding.link("x*two");
+        passed = passed && folding.link("x*half").program != nullptr
+                && folding.statistics().inlined == 2;
+        passed = passed && product.program->instructions().size() == 1
+                && product.program->instructionStream()
+                == plain.program->instructionStream();
+        if (report("folding", passed) == false)
+            testFailed = true;
+    }
+
+    // Equal instructions in the definitions are calculated once
+    {
+        ExpressionLinker common;
+        common.define("s", "sin(x)*a");
+        common.define("c", "sin(x)*b");
+        CompiledExpression linked = common.link("s+c+sin(x)");
+        bool passed = linked.program != nullptr
+                && common.statistics().merged == 2
+                && linked.program->instructions().size() == 5
+                && evaluate(linked, { 0.5, 2.0, 3.0 })
+                == parse("sin(x)*a+sin(x)*b+sin(x)",
+                         { { "x", 0.5 }, { "a", 2.0 }, { "b", 3.0 } });
+        if (report("common", passed) == false)
+            testFailed = true;
+    }
+
+    // Definitions may come in any order and may change
+    {
+        ExpressionLinker order;
+        order.define("y", "z*2");
+        CompiledExpression before = order.link("y+x");
+        order.define("z", "3");
+        CompiledExpression after = order.link("y+x");
+        order.define("z", "4");
+        CompiledExpression changed = order.link("y+x");
+        bool passed = before.variableNames
+                == vector<string>({ "z", "x" })
+                && after.variableNames == vector<string>{ "x" }
+                && evaluate(after, { 1.0 }) == 7.0
+                && evaluate(changed, { 1.0 }) == 9.0
+                && evaluate(order.link("y"), {}) == 8.0;
+        order.undefine("z");
+        passed = passed && order.link("y").variableNames
+                == vector<string>{ "z" };
+        if (report("order", passed) == false)
+            testFailed = true;
+    }
+
+    // Cycles and errors
+    {
+        ExpressionLinker cycle;
+        cycle.define("a", "b+1");
+        cycle.define("b", "c*2");
+        cycle.define("c", "a-1");
+        cycle.define("d", "d+1");
+        CompiledExpression loop = cycle.link("x+a");
+        CompiledExpression self = cycle.link("d");
+        bool passed = loop.program == nullptr
+                && loop.errorString
+                == "The definitions have a cycle: a -> b -> c -> a"
+                && self.program == nullptr
+                && self.errorString == "The definitions have a cycle: d -> d";
+        cycle.undefine("c");
+        passed = passed && cycle.link("x+a").program != nullptr
+                && cycle.define("pi", "3") == false
+                && cycle.define("sin", "3") == false
+                && cycle.define("e", "1+") == false
+                && cycle.errorString().empty() == false
+                && cycle.link("(1+").program == nullptr;
+        if (report("cycles", passed) == false)
+            testFailed = true;
+    }
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
@@ -0,0 +1,178 @@
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include "pssmathparser.h"
+#include "pssmathedit.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Prints the result of one test
+bool report(const string &a_name, bool a_passed)
+{
+    cout << a_name << (a_passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+    return a_passed;
+}
+
+// Value of the edited expression, the variables are found by name
+double evaluate(const CompiledExpression &a_compiled,
+                const unordered_map<string, double> &a_values)
+{
+    EvaluationContext context(a_compiled.program);
+    for (size_t v = 0; v < a_compiled.variableNames.size(); v++) {
+        auto ivalue = a_values.find(a_compiled.variableNames[v]);
+        if (ivalue != a_values.end())
+            context.setVariable(uint32_t(v), ivalue->second);
+    }
+    return context.calculate();
+}
+
+// Value of the expression compiled by one parser
+double parse(const string &a_expression,
+             const unordered_map<string, double> &a_values)
+{
+    MathExpression parser;
+    CompiledExpression compiled = parser.compile(a_expression);
+    if (compiled.program == nullptr)
+        return NAN;
+    return evaluate(compiled, a_values);
+}
+
+// Index of the variable in the edited expression
+size_t indexOf(const ExpressionEditor &a_editor, const string &a_name)
+{
+    const vector<string> &names = a_editor.compiled().variableNames;
+    return size_t(find(names.begin(), names.end(), a_name) - names.begin());
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 24 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+    unordered_map<string, double> values = {
+        { "Io", 1.0e-12 }, { "V", 0.6 }, { "TC", 25.0 }, { "Tj", 40.0 },
+        { "x", 0.75 }, { "y", -1.25 }, { "z", 2.5 }, { "w", 0.125 }
+    };
+
+    // Only the innermost group of the edit is compiled again
+    {
+        ExpressionEditor editor;
+        bool passed = editor.setText("Io*(exp(V/(kBJ*(ToK+TC)/qe))-1)")
+                && editor.statistics().groups == 5
+                && editor.statistics().compiledGroups == 5;
+        size_t tc = indexOf(editor, "TC");
+        passed = passed && editor.edit(20, 2, "Tj")
+                && editor.text() == "Io*(exp(V/(kBJ*(ToK+Tj)/qe))-1)"
+                && editor.statistics().compiledGroups == 1
+                && editor.statistics().compiledLength == 6
+                && indexOf(editor, "TC") == tc
+                && evaluate(editor.compiled(), values)
+                == parse(editor.text(), values);
+        passed = passed && editor.edit(0, 2, "(x+y)")
+                && editor.statistics().compiledGroups == 2
+                && editor.statistics().groups == 6
+                && indexOf(editor, "TC") == tc
+                && evaluate(editor.compiled(), values)
+                == parse(editor.text(), values);
+        if (report("innermost", passed) == false)
+            testFailed = true;
+    }
+
+    // Random edits of a long expression against the parser
+    {
+        string text;
+        for (int i = 0; i < 300; i++) {
+            text += i == 0 ? "(" : "+(";
+            text += i % 3 == 0 ? "x*" : i % 3 == 1 ? "sin(y)*" : "z/";
+            text += to_string(i + 1) + ".5-exp(w*(" + to_string(i % 7)
+                    + "+x)))";
+        }
+        ExpressionEditor editor;
+        bool passed = editor.setText(text);
+        mt19937 random(24);
+        size_t x = indexOf(editor, "x");
+        double fullTime = 0.0;
+        double editTime = 0.0;
+        for (int i = 0; passed && i < 40; i++) {
+            // A number of some term changes
+            size_t position = editor.text().find(".5-", random()
+                                                 % editor.text().size());
+            if (position == string::npos)
+                position = editor.text().find(".5-");
+            string digit = to_string(random() % 10);
+            auto start = chrono::steady_clock::now();
+            bool edited = editor.edit(position + 1, 1, digit);
+            auto middle = chrono::steady_clock::now();
+            MathExpression parser;
+            parser.compile(editor.text());
+            auto stop = chrono::steady_clock::now();
+            editTime += chrono::duration<double>(middle - start).count();
+            fullTime += chrono::duration<double>(stop - middle).count();
+            passed = edited && editor.statistics().compiledGroups == 1
+                    && indexOf(editor, "x") == x
+                    && evaluate(editor.compiled(), values)
+                    == parse(editor.text(), values);
+        }
+        cout << "Compile: " << fullTime * 1000.0 << " ms, edits: "
+             << editTime * 1000.0 << " ms" << endl;
+        if (report("random edits", passed && editTime * 2.0 < fullTime)
+                == false)
+            testFailed = true;
+    }
+
+    // Errors while typing are fixed by the next edits
+    {
+        ExpressionEditor editor;
+        bool passed = editor.setText("x*(y+z)");
+        passed = passed && editor.edit(7, 0, "+(") == false
+                && editor.errorString().empty() == false
+                && editor.compiled().program == nullptr
+                && editor.edit(9, 0, "w") == false
+                && editor.edit(10, 0, ")")
+                && editor.text() == "x*(y+z)+(w)"
+                && editor.compiled().variableNames
+                == vector<string>({ "x", "y", "z", "w" })
+                && evaluate(editor.compiled(), values)
+                == parse(editor.text(), values);
+        passed = passed && editor.edit(4, 1, "+*") == false
+                && editor.edit(4, 2, "-") && editor.text() == "x*(y-z)+(w)"
+                && evaluate(editor.compiled(), values)
+                == parse(editor.text(), values);
+        passed = passed && editor.edit(20, 1, "") == false
+                && editor.text() == "x*(y-z)+(w)";
+        if (report("errors", passed) == false)
+            testFailed = true;
+    }
+
+    // Names of the text that look like the names of the groups
+    {
+        ExpressionEditor editor;
+        values["groupa"] = 3.0;
+        values["groupzb"] = 5.0;
+        bool passed = editor.setText("groupa*(x+1)")
+                && editor.edit(10, 1, "groupzb")
+                && editor.text() == "groupa*(x+groupzb)"
+                && editor.compiled().variableNames
+                == vector<string>({ "groupa", "x", "groupzb" })
+                && evaluate(editor.compiled(), values) == 3.0 * (0.75 + 5.0);
+        if (report("names", passed) == false)
+            testFailed = true;
+    }
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
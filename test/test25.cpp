@@ -0,0 +1,230 @@
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <chrono>
+#include <string.h>
+#include "pssmathparser.h"
+#include "pssmathmemo.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Prints the result of one test
+bool report(const string &a_name, bool a_passed)
+{
+    cout << a_name << (a_passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+    return a_passed;
+}
+
+// Tells if the doubles are equal bit by bit
+bool same(double a_first, double a_second)
+{
+    return memcmp(&a_first, &a_second, sizeof(double)) == 0;
+}
+
+// Value of the expression of x and y calculated by a new parser
+double value(const string &a_expression, double a_x, double a_y)
+{
+    MathExpression parser;
+    parser.setMath(a_expression);
+    parser.setVariableDouble("x", a_x);
+    parser.setVariableDouble("y", a_y);
+    return parser.calculateExpression();
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 25 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+
+    // The table compares the bits, a full bucket drops its oldest key
+    {
+        MemoTable table(2, 3);
+        double key[2] = { 1.5, -2.0 };
+        double found = 0.0;
+        bool passed = table.statistics().capacity == 4
+                && table.find(key, found) == false;
+        table.insert(key, 7.0);
+        passed = passed && table.find(key, found) && found == 7.0;
+        key[0] = -0.0;
+        double zero[2] = { 0.0, -2.0 };
+        table.insert(zero, 1.0);
+        passed = passed && table.find(key, found) == false;
+        MemoTable::Statistics statistics = table.statistics();
+        passed = passed && statistics.hits == 1 && statistics.misses == 2
+                && statistics.size >= 1 && statistics.size <= 2;
+
+        MemoTable one(1, 1);
+        double a = 1.0;
+        double b = 2.0;
+        one.insert(&a, 10.0);
+        one.insert(&b, 20.0);
+        passed = passed && one.find(&a, found) == false
+                && one.find(&b, found) && found == 20.0
+                && one.statistics().evictions == 1
+                && one.statistics().size == 1;
+        one.clear();
+        passed = passed && one.find(&b, found) == false
+                && one.statistics().size == 0;
+        if (report("table", passed) == false)
+            testFailed = true;
+    }
+
+    // The memoized exp gives the same results and counts the repeats
+    {
+        const string expression = "exp(x)*exp(x/2)+y";
+        bool passed = OperatorMemo::isEnabled("exp") == false
+                && OperatorMemo::enable("exp", 1024)
+                && OperatorMemo::isEnabled("exp")
+                && OperatorMemo::enable("+") == false
+                && OperatorMemo::enable("none") == false
+                && OperatorMemo::enable("sin", 0) == false;
+        MathExpression parser;
+        parser.setMath(expression);
+        parser.setVariableDouble("y", 0.5);
+        for (int repeat = 0; repeat < 10; repeat++) {
+            for (int i = 0; passed && i < 100; i++) {
+                double x = i * 0.0625 - 3.0;
+                parser.setVariableDouble("x", x);
+                passed = same(parser.calculateExpression(),
+                              exp(x) * exp(x / 2) + 0.5);
+            }
+        }
+        MemoTable::Statistics statistics = OperatorMemo::statistics("exp");
+        passed = passed && statistics.hits + statistics.misses == 2000
+                && statistics.hits >= 1600 && statistics.capacity == 1024;
+
+        // The wrapper has the name of its function in the generated code
+        passed = passed
+                && parser.batchSource("f").find("exp(") != string::npos;
+
+        // After disable() the compiled wrapper calls exp directly
+        OperatorMemo::disable("exp");
+        parser.setVariableDouble("x", 0.25);
+        passed = passed && same(parser.calculateExpression(),
+                                exp(0.25) * exp(0.125) + 0.5)
+                && OperatorMemo::isEnabled("exp") == false
+                && OperatorMemo::statistics("exp").hits == statistics.hits;
+        if (report("operator", passed) == false)
+            testFailed = true;
+    }
+
+    // The functions are memoized, "^" and "pow" share one
+    {
+        bool passed = OperatorMemo::enable("^");
+        passed = passed && OperatorMemo::isEnabled("pow");
+        MathExpression parser;
+        parser.setMath("x^y+y^x");
+        const double *columns[2];
+        vector<double> xs(4096);
+        vector<double> ys(4096);
+        vector<double> results(4096);
+        for (size_t i = 0; i < xs.size(); i++) {
+            xs[i] = 1.0 + (i % 17) * 0.25;
+            ys[i] = 0.5 + (i % 5) * 0.5;
+        }
+        columns[0] = xs.data();
+        columns[1] = ys.data();
+        parser.calculateBatchParallel(columns, results.data(), xs.size());
+        for (size_t i = 0; passed && i < xs.size(); i++) {
+            passed = same(results[i], pow(xs[i], ys[i]) + pow(ys[i], xs[i]));
+        }
+        OperatorMemo::disable("pow");
+        if (report("threads", passed) == false)
+            testFailed = true;
+    }
+
+    // Whole results on the values of the variables
+    {
+        string expression = "x";
+        for (int i = 1; i < 60; i++) {
+            expression += "+sin(x*" + to_string(i) + ".5)*cos(y/"
+                    + to_string(i) + ".25)";
+        }
+        MathExpression plain;
+        plain.setMath(expression);
+        MathExpression memo;
+        memo.setResultMemo(1024);
+        memo.setMath(expression);
+        bool passed = true;
+        double plainTime = 0.0;
+        double memoTime = 0.0;
+        for (int repeat = 0; repeat < 50; repeat++) {
+            for (int i = 0; passed && i < 64; i++) {
+                double x = i * 0.125;
+                double y = (i % 8) * 0.5 + 0.25;
+                plain.setVariableDouble("x", x);
+                plain.setVariableDouble("y", y);
+                memo.setVariableDouble("x", x);
+                memo.setVariableDouble("y", y);
+                auto start = chrono::steady_clock::now();
+                double expected = plain.calculateExpression();
+                auto middle = chrono::steady_clock::now();
+                double result = memo.calculateExpression();
+                auto stop = chrono::steady_clock::now();
+                plainTime += chrono::duration<double>(middle - start)
+                        .count();
+                memoTime += chrono::duration<double>(stop - middle).count();
+                passed = same(result, expected);
+            }
+        }
+        MemoTable::Statistics statistics = memo.resultMemoStatistics();
+        cout << "Plain: " << plainTime * 1000.0 << " ms, memoized: "
+             << memoTime * 1000.0 << " ms, hits: " << statistics.hits
+             << endl;
+        passed = passed && statistics.hits + statistics.misses == 3200
+                && statistics.hits >= 3000 && memoTime * 3.0 < plainTime;
+
+        // A copy has its own memo, a constant change empties it
+        MathExpression copy(memo);
+        passed = passed && copy.resultMemoStatistics().size
+                == statistics.size;
+        MathExpression constant;
+        constant.setResultMemo(16);
+        constant.setMath("x*pi");
+        constant.setVariableDouble("x", 2.0);
+        double before = constant.calculateExpression();
+        constant.setVariableDouble("pi", 3.0);
+        passed = passed && before == 2.0 * M_PI
+                && constant.calculateExpression() == 6.0
+                && MathExpression().resultMemoStatistics().capacity == 0;
+        if (report("results", passed) == false)
+            testFailed = true;
+    }
+
+    // The memo skips calculations of the incremental backend
+    {
+        const string expression = "sin(x)*y+cos(y)";
+        MathExpression parser;
+        parser.setBackend(EvaluationBackend::Incremental);
+        parser.setResultMemo(64);
+        parser.setMath(expression);
+        const double xs[] = { 1.0, 2.0, 1.0, 3.0, 2.0, 3.0 };
+        const double ys[] = { 0.5, 0.5, 0.5, 0.5, 1.5, 1.5 };
+        bool passed = parser.backend() == EvaluationBackend::Incremental;
+        for (int i = 0; passed && i < 6; i++) {
+            parser.setVariableDouble("x", xs[i]);
+            parser.setVariableDouble("y", ys[i]);
+            passed = same(parser.calculateExpression(),
+                          value(expression, xs[i], ys[i]));
+        }
+        passed = passed && parser.resultMemoStatistics().hits == 1;
+        if (report("incremental", passed) == false)
+            testFailed = true;
+    }
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
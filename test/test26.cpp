@@ -0,0 +1,173 @@
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <chrono>
+#include "pssmathparser.h"
+#include "pssmathtable.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Prints the result of one test
+bool report(const string &a_name, bool a_passed)
+{
+    cout << a_name << (a_passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+    return a_passed;
+}
+
+// Program of the expression compiled by a new parser
+shared_ptr<const Program> compile(const string &a_expression)
+{
+    MathExpression parser;
+    parser.setMath(a_expression);
+    return parser.program();
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 26 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+
+    const string curve = "sqrt(x+ToK)*exp(-(x-25)^2/2000)+sin(x/7)*cos(x/3)";
+    const double lower = -40.0;
+    const double upper = 125.0;
+
+    // The table of a curve of the temperature meets the target
+    {
+        shared_ptr<const Program> program = compile(curve);
+        TableFunction table;
+        bool passed = table.build(program, lower, upper, 1.0e-9)
+                && table.errorString().empty()
+                && table.maxError() <= 1.0e-9
+                && table.size() >= 64
+                && table.bytes() >= table.size() * 4 * sizeof(double)
+                && table.lower() == lower && table.upper() == upper;
+        cout << "Intervals: " << table.size() << ", bytes: " << table.bytes()
+             << ", error: " << table.maxError() << endl;
+
+        // The error between the check points is close to the measured one
+        EvaluationContext context(program);
+        double error = 0.0;
+        for (int i = 0; i <= 100000; i++) {
+            double x = lower + (upper - lower) * i / 100000.0;
+            error = max(error, fabs(table(x) - context.calculate(&x)));
+        }
+        cout << "Error at 100001 points: " << error << endl;
+        passed = passed && error <= 2.0e-9;
+
+        // The ends are exact, outside the domain the ends are returned
+        double lowerValue = context.calculate(&lower);
+        double upperValue = context.calculate(&upper);
+        passed = passed && fabs(table(lower) - lowerValue) <= 1.0e-12
+                && fabs(table(upper) - upperValue) <= 1.0e-12
+                && table(-1000.0) == table(lower)
+                && table(1000.0) == table(upper)
+                && isnan(table(NAN));
+
+        // The batch gives the values of calculate()
+        vector<double> xs(1000);
+        vector<double> results(xs.size());
+        for (size_t i = 0; i < xs.size(); i++)
+            xs[i] = lower - 10.0 + i * 0.19;
+        table.calculateBatch(xs.data(), results.data(), xs.size());
+        for (size_t i = 0; passed && i < xs.size(); i++)
+            passed = results[i] == table.calculate(xs[i]);
+        if (report("curve", passed) == false)
+            testFailed = true;
+    }
+
+    // The steep part gets more intervals than the flat part
+    {
+        shared_ptr<const Program> program = compile("exp(x)");
+        TableFunction table;
+        bool passed = table.build(program, 0.0, 10.0, 1.0e-6)
+                && table.size() > 64 && table.size() < 64 * 64;
+        TableFunction flat;
+        passed = passed && flat.build(compile("x*3+1"), 0.0, 10.0, 1.0e-6)
+                && flat.size() == 64 && flat(2.5) == 8.5
+                && flat.maxError() < 1.0e-12;
+        TableFunction constant;
+        passed = passed && constant.build(compile("pi*2"), 0.0, 1.0, 1.0e-9)
+                && fabs(constant(0.3) - 2.0 * M_PI) < 1.0e-15;
+        if (report("adaptive", passed) == false)
+            testFailed = true;
+    }
+
+    // The size is limited, the achieved error is reported
+    {
+        TableFunction table;
+        bool passed = table.build(compile("1/(x*x+0.0001)"), -1.0, 1.0,
+                                  1.0e-12, 256) == false
+                && table.size() <= 256
+                && table.maxError() > 1.0e-12
+                && table.errorString().find("over the target")
+                != string::npos;
+        cout << "Limited: " << table.errorString() << endl;
+        passed = passed && table.build(compile("sqrt(x)"), -1.0, 1.0, 1.0e-6,
+                                       1024) == false
+                && table.errorString().find("finite") != string::npos;
+        passed = passed && table.build(compile("x+y"), 0.0, 1.0, 1.0e-6)
+                == false
+                && table.build(compile("x"), 1.0, 0.0, 1.0e-6) == false
+                && table.build(compile("x"), 0.0, 1.0, 0.0) == false
+                && table.build(nullptr, 0.0, 1.0, 1.0e-6) == false;
+        if (report("limits", passed) == false)
+            testFailed = true;
+    }
+
+    // The table takes a few nanoseconds whatever the program
+    {
+        shared_ptr<const Program> program = compile(curve);
+        TableFunction table;
+        table.build(program, lower, upper, 1.0e-9);
+        EvaluationContext context(program);
+        vector<double> xs(1 << 20);
+        uint64_t state = 12345;
+        for (double &x : xs) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            x = lower + (upper - lower) * double(state >> 11)
+                    / 9007199254740992.0;
+        }
+        // The fastest of 3 runs, the machine may be busy
+        double tableSum = 0.0;
+        double programSum = 0.0;
+        double tableTime = HUGE_VAL;
+        double programTime = HUGE_VAL;
+        for (int repeat = 0; repeat < 3; repeat++) {
+            tableSum = 0.0;
+            programSum = 0.0;
+            auto start = chrono::steady_clock::now();
+            for (double x : xs)
+                tableSum += table(x);
+            auto middle = chrono::steady_clock::now();
+            for (double x : xs)
+                programSum += context.calculate(&x);
+            auto stop = chrono::steady_clock::now();
+            tableTime = min(tableTime, chrono::duration<double>(
+                                middle - start).count() / xs.size() * 1.0e9);
+            programTime = min(programTime, chrono::duration<double>(
+                                  stop - middle).count() / xs.size() * 1.0e9);
+        }
+        cout << "Table: " << tableTime << " ns, program: " << programTime
+             << " ns" << endl;
+        bool passed = fabs(tableSum - programSum) < 1.0e-9 * xs.size()
+                && tableTime * 4.0 < programTime;
+        if (report("speed", passed) == false)
+            testFailed = true;
+    }
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
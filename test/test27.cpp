@@ -0,0 +1,198 @@
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <chrono>
+#include "pssmathparser.h"
+#include "pssmathchebyshev.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Prints the result of one test
+bool report(const string &a_name, bool a_passed)
+{
+    cout << a_name << (a_passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+    return a_passed;
+}
+
+// Program of the expression compiled by a new parser
+shared_ptr<const Program> compile(const string &a_expression)
+{
+    MathExpression parser;
+    parser.setMath(a_expression);
+    return parser.program();
+}
+
+// Largest error of the series against the program at random points
+double randomError(const ChebyshevFunction &a_chebyshev,
+                   const shared_ptr<const Program> &a_program,
+                   const vector<double> &a_lower,
+                   const vector<double> &a_upper,
+                   int a_points)
+{
+    EvaluationContext context(a_program);
+    uint64_t state = 987654321;
+    double error = 0.0;
+    double variables[4];
+    for (int i = 0; i < a_points; i++) {
+        for (size_t v = 0; v < a_lower.size(); v++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            variables[v] = a_lower[v] + (a_upper[v] - a_lower[v])
+                    * double(state >> 11) / 9007199254740992.0;
+        }
+        error = max(error, fabs(a_chebyshev(variables)
+                                - context.calculate(variables)));
+    }
+    return error;
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 27 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+
+    // One variable, the error is verified at random points too
+    {
+        shared_ptr<const Program> program = compile("exp(x)*sin(3*x)");
+        const vector<double> lower = { -1.0 };
+        const vector<double> upper = { 2.0 };
+        ChebyshevFunction chebyshev;
+        bool passed = chebyshev.build(program, lower, upper, 1.0e-10)
+                && chebyshev.errorString().empty()
+                && chebyshev.maxError() <= 1.0e-10
+                && chebyshev.variableSize() == 1
+                && chebyshev.size() == chebyshev.degree() + 1u;
+        double error = randomError(chebyshev, program, lower, upper, 100000);
+        cout << "Degree: " << chebyshev.degree() << ", error: "
+             << chebyshev.maxError() << ", at random points: " << error
+             << endl;
+        passed = passed && error <= 2.0e-10;
+
+        // Outside the bounds the value at the nearest bound
+        double below = -5.0;
+        double above = 7.0;
+        passed = passed && chebyshev(&below) == chebyshev(&lower[0])
+                && chebyshev(&above) == chebyshev(&upper[0]);
+        if (report("one", passed) == false)
+            testFailed = true;
+    }
+
+    // Two and three variables in a tensor product
+    {
+        shared_ptr<const Program> program =
+                compile("sqrt(x+ToK)*exp(-y/50)");
+        const vector<double> lower = { -40.0, 0.0 };
+        const vector<double> upper = { 125.0, 100.0 };
+        ChebyshevFunction chebyshev;
+        bool passed = chebyshev.build(program, lower, upper, 1.0e-9);
+        double error = randomError(chebyshev, program, lower, upper, 100000);
+        cout << "Two variables, degree: " << chebyshev.degree() << ", terms: "
+             << chebyshev.size() << ", error: " << chebyshev.maxError()
+             << ", at random points: " << error << endl;
+        passed = passed && chebyshev.maxError() <= 1.0e-9 && error <= 2.0e-9
+                && chebyshev.size() == (chebyshev.degree() + 1u)
+                * (chebyshev.degree() + 1u);
+
+        shared_ptr<const Program> three = compile("x*y+sin(z)*exp(x/4)");
+        const vector<double> lower3 = { 0.0, -1.0, 0.0 };
+        const vector<double> upper3 = { 2.0, 1.0, 3.0 };
+        passed = passed && chebyshev.build(three, lower3, upper3, 1.0e-8);
+        error = randomError(chebyshev, three, lower3, upper3, 20000);
+        cout << "Three variables, degree: " << chebyshev.degree()
+             << ", terms: " << chebyshev.size() << ", error: "
+             << chebyshev.maxError() << ", at random points: " << error
+             << endl;
+        passed = passed && chebyshev.variableSize() == 3
+                && error <= 2.0e-8;
+        if (report("tensor", passed) == false)
+            testFailed = true;
+    }
+
+    // The batch gives the values of calculate()
+    {
+        shared_ptr<const Program> program = compile("x*y+sin(z)*exp(x/4)");
+        ChebyshevFunction chebyshev;
+        bool passed = chebyshev.build(program, { 0.0, -1.0, 0.0 },
+                                      { 2.0, 1.0, 3.0 }, 1.0e-8);
+        const size_t size = 10003;
+        vector<double> xs(size);
+        vector<double> ys(size);
+        vector<double> zs(size);
+        for (size_t i = 0; i < size; i++) {
+            xs[i] = i * 0.0003 - 0.5;
+            ys[i] = sin(double(i));
+            zs[i] = (i % 31) * 0.1;
+        }
+        const double *columns[3] = { xs.data(), ys.data(), zs.data() };
+        vector<double> results(size);
+        auto start = chrono::steady_clock::now();
+        chebyshev.calculateBatch(columns, results.data(), size);
+        auto middle = chrono::steady_clock::now();
+        double sum = 0.0;
+        for (size_t i = 0; i < size; i++) {
+            double variables[3] = { xs[i], ys[i], zs[i] };
+            double value = chebyshev.calculate(variables);
+            sum += value;
+            passed = passed && fabs(results[i] - value)
+                    <= 1.0e-14 * max(1.0, fabs(value));
+        }
+        auto stop = chrono::steady_clock::now();
+        cout << "Batch: " << chrono::duration<double>(middle - start).count()
+                / size * 1.0e9 << " ns, scalar: "
+             << chrono::duration<double>(stop - middle).count() / size * 1.0e9
+             << " ns, sum: " << sum << endl;
+        if (report("batch", passed) == false)
+            testFailed = true;
+    }
+
+    // The size is limited, the achieved error is reported
+    {
+        ChebyshevFunction chebyshev;
+        bool passed = chebyshev.build(compile("1/(x*x+0.0001)"), { -1.0 },
+                                      { 1.0 }, 1.0e-12, 200) == false
+                && chebyshev.degree() == 128
+                && chebyshev.maxError() > 1.0e-12
+                && chebyshev.errorString().find("over the target")
+                != string::npos;
+        cout << "Limited: " << chebyshev.errorString() << endl;
+        passed = passed && chebyshev.build(compile("sqrt(x)"), { -1.0 },
+                                           { 1.0 }, 1.0e-6, 64) == false
+                && chebyshev.errorString().find("finite") != string::npos;
+        passed = passed && chebyshev.build(compile("x+y"), { 0.0 }, { 1.0 },
+                                           1.0e-6) == false
+                && chebyshev.build(compile("x"), { 1.0 }, { 0.0 }, 1.0e-6)
+                == false
+                && chebyshev.build(compile("a+b+c+d+f"),
+                                   vector<double>(5, 0.0),
+                                   vector<double>(5, 1.0), 1.0e-6) == false
+                && chebyshev.build(compile("x*y*z"), { 0.0, 0.0, 0.0 },
+                                   { 1.0, 1.0, 1.0 }, 1.0e-6, 100) == false
+                && chebyshev.build(nullptr, {}, {}, 1.0e-6) == false;
+        // The error of degree 16 in 4 variables can't be measured on 2^20
+        // points, the size limit isn't reached
+        passed = passed && chebyshev.build(compile("sin(6*a)*b*c*d"),
+                                           vector<double>(4, -1.0),
+                                           vector<double>(4, 1.0), 1.0e-12,
+                                           size_t(1) << 20) == false
+                && chebyshev.degree() == 8;
+        passed = passed && chebyshev.build(compile("pi*2"), {}, {}, 1.0e-9)
+                && chebyshev(nullptr) == 2.0 * M_PI;
+        if (report("limits", passed) == false)
+            testFailed = true;
+    }
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
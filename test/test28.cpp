@@ -0,0 +1,235 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cmath>
+#include <chrono>
+#include <new>
+#include <atomic>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "pssmathparser.h"
+#include "pssmathimage.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Counts the allocations of the test, to see that the calculation has none
+atomic<size_t> allocations(0);
+
+void *operator new(size_t a_size)
+{
+    allocations++;
+    void *memory = malloc(a_size == 0 ? 1 : a_size);
+    if (memory == nullptr)
+        throw bad_alloc();
+    return memory;
+}
+
+void operator delete(void *a_memory) noexcept
+{
+    free(a_memory);
+}
+
+void operator delete(void *a_memory, size_t) noexcept
+{
+    free(a_memory);
+}
+
+// Prints the result of one test
+bool report(const string &a_name, bool a_passed)
+{
+    cout << a_name << (a_passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+    return a_passed;
+}
+
+// Tells if the doubles are equal bit by bit
+bool same(double a_first, double a_second)
+{
+    return memcmp(&a_first, &a_second, sizeof(double)) == 0;
+}
+
+// Copies the file with the bytes at a_offset replaced
+void patch(const string &a_from, const string &a_to, size_t a_offset,
+           const string &a_bytes, size_t a_size = 0)
+{
+    ifstream in(a_from, ios::binary);
+    string bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    bytes.replace(a_offset, a_bytes.size(), a_bytes);
+    if (a_size != 0)
+        bytes.resize(a_size);
+    ofstream out(a_to, ios::binary | ios::trunc);
+    out << bytes;
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 28 ##############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+
+    const string fileName = "test28.pssm";
+    const string brokenName = "test28broken.pssm";
+    vector<string> expressions;
+    vector<string> names;
+    for (int i = 0; i < 500; i++) {
+        expressions.push_back("x*" + to_string(i) + ".5+sin(y/"
+                              + to_string(i + 1) + ")-exp(x/"
+                              + to_string(i + 2) + ")^2+pi");
+        names.push_back("model" + string(1, char('a' + i % 26))
+                        + to_string(i));
+    }
+    expressions.push_back("Io*(exp(V/(kBJ*(ToK+TC)/qe))-1)");
+    names.push_back("diode");
+    expressions.push_back("2*pi");
+    names.push_back("constant");
+    vector<CompiledExpression> compiled = MathParser::compileAll(expressions);
+
+    // The loaded programs give the results of the compiled ones
+    {
+        ProgramImage image;
+        bool passed = image.save(fileName, compiled, names,
+                                 EvaluationBackend::Jit);
+        ProgramImage loaded;
+        passed = passed && loaded.load(fileName)
+                && loaded.size() == expressions.size()
+                && loaded.find("diode") == expressions.size() - 2
+                && loaded.find("none") == loaded.size()
+                && string(loaded.name(3)) == names[3]
+                && loaded.level(0) == EvaluationBackend::Jit;
+        vector<double> slots(loaded.maxSlotSize());
+        for (size_t p = 0; passed && p < compiled.size(); p++) {
+            const CompiledExpression &expression = compiled[p];
+            passed = loaded.variableSize(p) == expression.variableNames.size()
+                    && loaded.slotSize(p) <= loaded.maxSlotSize();
+            for (uint32_t v = 0; passed && v < loaded.variableSize(p); v++) {
+                passed = expression.variableNames[v]
+                        == loaded.variableName(p, v);
+            }
+            EvaluationContext context(expression.program);
+            EvaluationContext copy(loaded.program(p));
+            for (int i = 0; passed && i < 5; i++) {
+                double variables[4] = { 0.5 + i, 1.25 * i, 0.1, 25.0 };
+                double expected = context.calculate(variables);
+                passed = same(loaded.calculate(p, variables, slots.data()),
+                              expected)
+                        && same(copy.calculate(variables), expected);
+            }
+        }
+        double none[1] = { 0.0 };
+        passed = passed && isnan(loaded.calculate(loaded.size(), none,
+                                                  slots.data()))
+                && loaded.program(loaded.size()) == nullptr;
+        if (report("round trip", passed) == false)
+            testFailed = true;
+    }
+
+    // The calculation doesn't allocate, the load is faster than the parsing
+    {
+        auto start = chrono::steady_clock::now();
+        vector<double> results(expressions.size());
+        for (size_t p = 0; p < expressions.size(); p++) {
+            MathExpression parser;
+            parser.setMath(expressions[p]);
+            parser.setVariableDouble("x", 1.5);
+            parser.setVariableDouble("y", 2.5);
+            results[p] = parser.calculateExpression();
+        }
+        auto middle = chrono::steady_clock::now();
+        ProgramImage loaded;
+        bool passed = loaded.load(fileName);
+        vector<double> slots(loaded.maxSlotSize());
+        vector<double> loadedResults(expressions.size());
+        size_t before = allocations;
+        for (size_t p = 0; p < loaded.size(); p++) {
+            double variables[2] = { 1.5, 2.5 };
+            if (loaded.variableSize(p) == 2
+                    && string(loaded.variableName(p, 0)) == "y")
+                swap(variables[0], variables[1]);
+            loadedResults[p] = loaded.calculate(p, variables, slots.data());
+        }
+        size_t calculationAllocations = allocations - before;
+        auto stop = chrono::steady_clock::now();
+        double parseTime = chrono::duration<double>(middle - start).count();
+        double loadTime = chrono::duration<double>(stop - middle).count();
+        cout << "Parsing: " << parseTime * 1000.0 << " ms, loading: "
+             << loadTime * 1000.0 << " ms, allocations: "
+             << calculationAllocations << endl;
+        for (size_t p = 0; passed && p < expressions.size() - 2; p++)
+            passed = same(results[p], loadedResults[p]);
+        passed = passed && calculationAllocations == 0
+                && loadTime * 5.0 < parseTime;
+        if (report("cold start", passed) == false)
+            testFailed = true;
+    }
+
+    // Another version, byte order or a broken file is rejected
+    {
+        ProgramImage loaded;
+        uint32_t version = ProgramImage::Version + 1;
+        patch(fileName, brokenName, 8, string((char *)&version, 4));
+        bool passed = loaded.load(brokenName) == false
+                && loaded.errorString().find("version") != string::npos
+                && loaded.size() == 0;
+        patch(fileName, brokenName, 12, string("\x01\x02\x03\x04", 4));
+        passed = passed && loaded.load(brokenName) == false
+                && loaded.errorString().find("byte order") != string::npos;
+        patch(fileName, brokenName, 0, "PSSMATX");
+        passed = passed && loaded.load(brokenName) == false
+                && loaded.errorString().find("isn't a program image")
+                != string::npos;
+        patch(fileName, brokenName, 0, "", 4096);
+        passed = passed && loaded.load(brokenName) == false;
+        passed = passed && loaded.load("test28none.pssm") == false
+                && loaded.errorString().find("can't be read") != string::npos;
+        cout << "Rejected: " << loaded.errorString() << endl;
+
+        // A program with an error or a missing name can't be saved
+        ProgramImage image;
+        vector<CompiledExpression> wrong =
+                MathParser::compileAll(vector<string>(1, "x+*y"));
+        passed = passed && image.save(brokenName, wrong) == false
+                && image.save(brokenName, compiled, vector<string>(2, "a"))
+                == false;
+
+        // A file without programs is valid
+        passed = passed && image.save(brokenName,
+                                      vector<CompiledExpression>())
+                && loaded.load(brokenName) && loaded.size() == 0
+                && loaded.maxSlotSize() == 0;
+        if (report("rejected", passed) == false)
+            testFailed = true;
+    }
+    // A loaded file that is saved again keeps its programs
+    {
+        ProgramImage loaded;
+        bool passed = loaded.load(fileName);
+        vector<double> slots(loaded.maxSlotSize());
+        double variables[2] = { 1.5, 2.5 };
+        double before = loaded.calculate(1, variables, slots.data());
+        ProgramImage image;
+        passed = passed && image.save(fileName, vector<CompiledExpression>(
+                                          1, compiled.back()));
+        passed = passed && same(loaded.calculate(1, variables, slots.data()),
+                                before)
+                && image.load(fileName) && image.size() == 1;
+        if (report("replaced", passed) == false)
+            testFailed = true;
+    }
+    remove(fileName.c_str());
+    remove(brokenName.c_str());
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
@@ -0,0 +1,258 @@
+#define TESTFILE "../test/input6.txt"
+#define BATCHSIZE 1000
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <fstream>
+#include <iomanip>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include "pssmathparser.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Calculates the loaded expression with the given backend, once and in batch,
+// and compares with the interpreter bit by bit
+bool testBackend(MathParser *mp, EvaluationBackend backend,
+                 const vector<double> &values, double &dout)
+{
+    uint16_t numVariables = mp->getVariableSize();
+    vector<vector<double>> columns(numVariables);
+    vector<const double *> columnPointers(numVariables);
+    vector<double> expected(BATCHSIZE), results(BATCHSIZE);
+    for (uint16_t j=0; j<numVariables; j++) {
+        for (uint32_t i=0; i<BATCHSIZE; i++) {
+            columns[j].push_back(values[j]*(1.0 + i*1.0e-3));
+        }
+        columnPointers[j] = columns[j].data();
+    }
+
+    // Expected values from the interpreter
+    mp->setBackend(EvaluationBackend::Interpreter);
+    for (uint32_t i=0; i<BATCHSIZE; i++) {
+        for (uint16_t j=0; j<numVariables; j++) {
+            mp->setVariableDouble(mp->getVariableName(j), columns[j][i]);
+        }
+        expected[i] = mp->calculateExpression();
+    }
+
+    // The inlined core must give the same results
+    CompiledFunction function = mp->compiledFunction();
+    vector<double> row(numVariables);
+    for (uint32_t i=0; i<BATCHSIZE; i++) {
+        for (uint16_t j=0; j<numVariables; j++) {
+            row[j] = columns[j][i];
+        }
+        double result = function(row.data());
+        if (memcmp(&result, &expected[i], sizeof(double)) != 0) {
+            cout << "  - compiled function row " << i << " = " << result
+                 << " expected " << expected[i] << endl;
+            return false;
+        }
+    }
+
+    if (mp->setBackend(backend) == false) {
+        cout << "  - backend not available, using interpreter" << endl;
+    }
+    for (uint16_t j=0; j<numVariables; j++) {
+        mp->setVariableDouble(mp->getVariableName(j), values[j]);
+    }
+    dout = mp->calculateExpression();
+
+    mp->calculateBatch(columnPointers.data(), results.data(), BATCHSIZE);
+    for (uint32_t i=0; i<BATCHSIZE; i++) {
+        if (memcmp(&results[i], &expected[i], sizeof(double)) != 0) {
+            cout << "  - batch row " << i << " = " << results[i]
+                 << " expected " << expected[i] << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 6 ###############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool output = false, testFailed = false;
+
+    // Check if file exists
+    ifstream infile(TESTFILE);
+    if (infile.is_open() == false) {
+        testFailed = true;
+        cout << "Error: Could not open input file '" << TESTFILE << "'" << endl;
+        cout << endl;
+        return 1;
+    }
+
+    // Run tests
+    const EvaluationBackend backends[] = {
+        EvaluationBackend::Interpreter,
+        EvaluationBackend::Jit,
+        EvaluationBackend::SystemCompiler
+    };
+    const char *backendNames[] = { "interpreter", "jit", "compiler" };
+    string line, variableName, variableValue;
+    vector<string> outputLines;
+    vector<double> values;
+    double dout;
+    bool readingValue=false;
+    MathParser *mp = MathParser::makeMathParser();
+    uint16_t counter = 1, numVariables=0;
+    while(getline(infile, line)) {
+        if(line[0] != '#') {
+            if(output == false) {
+                // Input
+                cout << counter << ".test line: '" << line << "'" << endl;
+                mp->setMath(line);
+
+                // Get number of variables
+                numVariables = mp->getVariableSize();
+
+                // Read variables, ordered as in the expression
+                values.assign(numVariables, 0.0);
+                for(uint16_t i=0; i<numVariables; i++) {
+                    readingValue = false;
+                    getline(infile, line);
+                    variableName.clear();
+                    variableValue.clear();
+                    for(uint16_t j=0; j<line.size(); j++) {
+                        if(readingValue == true) {
+                            variableValue += line[j];
+                        }
+                        else if (line[j] != '=') {
+                            variableName += line[j];
+                        }
+                        else if (line[j] == '='){
+                            readingValue = true;
+                        }
+                    }
+                    for(uint16_t j=0; j<numVariables; j++) {
+                        if (mp->getVariableName(j) == variableName)
+                            values[j] = atof(variableValue.data());
+                    }
+                }
+
+                // Calculate the expression with every backend
+                outputLines.clear();
+                for (size_t b=0; b<sizeof(backends)/sizeof(backends[0]); b++) {
+                    if (testBackend(mp, backends[b], values, dout) == false) {
+                        cout << "  - " << backendNames[b]
+                             << " batch differs from interpreter" << endl;
+                        testFailed = true;
+                    }
+
+                    ostringstream s;
+                    s.setf(ios::scientific);
+                    s << setprecision(7) << dout;
+
+                    // Here we add another digit in the exponent if it has
+                    // only two
+                    string stmp = s.str();
+                    if(stmp.size() - stmp.find('e') == 4)
+                        stmp.insert(stmp.find('e') + 2, "0");
+                    outputLines.push_back(stmp);
+                    cout << "  - result (" << backendNames[b] << ") = "
+                         << stmp.data() << endl;
+                }
+                output = true;
+            }
+            else {
+                // Output
+                cout << counter << ".expected output: '" << line
+                     << "'" << endl;
+                for (const string &outputLine : outputLines) {
+                    if (outputLine != line)
+                        testFailed = true;
+                }
+                if (testFailed == false) {
+                    cout << counter << ".TEST PASSED" << endl;
+                }
+                else {
+                    cout << counter << ".TEST FAILED" << endl;
+                    break;
+                }
+                cout << endl;
+                counter++;
+                output = false;
+                mp->clear();
+            }
+        }
+    }
+
+    // A changed constant is used by every backend, in calculateBatch() too
+    const EvaluationBackend allBackends[] = {
+        EvaluationBackend::Interpreter,
+        EvaluationBackend::Jit,
+        EvaluationBackend::SystemCompiler,
+        EvaluationBackend::Parallel,
+        EvaluationBackend::Incremental
+    };
+    bool constantPassed = true;
+    for (EvaluationBackend backend : allBackends) {
+        MathExpression parser;
+        parser.setBackend(backend);
+        parser.setMath("x*pi");
+        parser.setVariableDouble("x", 2.0);
+        double before = parser.calculateExpression();
+        parser.setVariableDouble("pi", 1.0);
+        double after = parser.calculateExpression();
+        double column[1] = { 3.0 };
+        const double *columns[1] = { column };
+        double batch = 0.0;
+        parser.calculateBatch(columns, &batch, 1);
+        if (before != 2.0 * M_PI || after != 2.0 || batch != 3.0) {
+            cout << "  - constant change: " << before << " " << after << " "
+                 << batch << endl;
+            constantPassed = false;
+        }
+    }
+    cout << "changed constant" << (constantPassed ? ": TEST PASSED"
+                                                  : ": TEST FAILED") << endl;
+    if (constantPassed == false)
+        testFailed = true;
+
+    // A cache directory that others can write to isn't used
+    {
+        const char *cacheDirectory = "test6cache";
+        mkdir(cacheDirectory, 0700);
+        chmod(cacheDirectory, 0777);
+        setenv("PSSMATHPARSER_CACHE", cacheDirectory, 1);
+        MathExpression shared;
+        shared.setMath("x*3+1");
+        bool passed = shared.setBackend(EvaluationBackend::SystemCompiler)
+                == false
+                && shared.backend() == EvaluationBackend::Interpreter;
+        chmod(cacheDirectory, 0700);
+        MathExpression own;
+        own.setMath("x*3+1");
+        passed = passed
+                && own.setBackend(EvaluationBackend::SystemCompiler);
+        unsetenv("PSSMATHPARSER_CACHE");
+        system("rm -rf test6cache");
+        cout << "shared cache directory"
+             << (passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+        if (passed == false)
+            testFailed = true;
+    }
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+
+    // Clear used data
+    infile.close();
+    delete mp;
+    return 0;
+}
@@ -0,0 +1,201 @@
+#define TESTFILE "../test/input7.txt"
+#define BATCHSIZE 1000
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <fstream>
+#include <iomanip>
+#include <string.h>
+#include "pssmathparser.h"
+#include "aot7.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+typedef void (*BatchFunction)(const double *const *variables,
+                              double *results,
+                              const size_t size);
+
+// Functions generated by pssmathaot from the input file
+const BatchFunction functions[] = {
+    aot::expression1, aot::expression2, aot::expression3, aot::expression4,
+    aot::expression5, aot::expression6, aot::expression7, aot::expression8
+};
+
+// Calculates the generated function and the parser in batch and compares the
+// results bit by bit, the first row has the given values of the variables
+bool testFunction(MathParser *mp, BatchFunction function,
+                  const vector<double> &values, double &dout)
+{
+    uint16_t numVariables = mp->getVariableSize();
+    vector<vector<double>> columns(numVariables);
+    vector<const double *> columnPointers(numVariables);
+    vector<double> expected(BATCHSIZE), results(BATCHSIZE);
+    for (uint16_t j=0; j<numVariables; j++) {
+        for (uint32_t i=0; i<BATCHSIZE; i++) {
+            columns[j].push_back(values[j]*(1.0 + i*1.0e-3));
+        }
+        columnPointers[j] = columns[j].data();
+    }
+
+    mp->calculateBatch(columnPointers.data(), expected.data(), BATCHSIZE);
+    function(columnPointers.data(), results.data(), BATCHSIZE);
+    dout = results[0];
+    for (uint32_t i=0; i<BATCHSIZE; i++) {
+        if (memcmp(&results[i], &expected[i], sizeof(double)) != 0) {
+            cout << "  - batch row " << i << " = " << results[i]
+                 << " expected " << expected[i] << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 7 ###############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool output = false, testFailed = false;
+
+    // Check if file exists
+    ifstream infile(TESTFILE);
+    if (infile.is_open() == false) {
+        testFailed = true;
+        cout << "Error: Could not open input file '" << TESTFILE << "'" << endl;
+        cout << endl;
+        return 1;
+    }
+
+    // Run tests
+    string line, outputLine, variableName, variableValue;
+    vector<double> values;
+    double dout;
+    bool readingValue=false;
+    MathParser *mp = MathParser::makeMathParser();
+    uint16_t counter = 1, numVariables=0;
+    const uint16_t numFunctions = sizeof(functions)/sizeof(functions[0]);
+    while(getline(infile, line)) {
+        if(line[0] != '#') {
+            if(output == false) {
+                // Input
+                cout << counter << ".test line: '" << line << "'" << endl;
+                mp->setMath(line);
+
+                // Get number of variables
+                numVariables = mp->getVariableSize();
+
+                // Read variables, ordered as in the expression
+                values.assign(numVariables, 0.0);
+                for(uint16_t i=0; i<numVariables; i++) {
+                    readingValue = false;
+                    getline(infile, line);
+                    variableName.clear();
+                    variableValue.clear();
+                    for(uint16_t j=0; j<line.size(); j++) {
+                        if(readingValue == true) {
+                            variableValue += line[j];
+                        }
+                        else if (line[j] != '=') {
+                            variableName += line[j];
+                        }
+                        else if (line[j] == '='){
+                            readingValue = true;
+                        }
+                    }
+                    for(uint16_t j=0; j<numVariables; j++) {
+                        if (mp->getVariableName(j) == variableName)
+                            values[j] = atof(variableValue.data());
+                    }
+                }
+
+                // Calculate with the generated function
+                if (counter > numFunctions) {
+                    cout << "  - no generated function" << endl;
+                    testFailed = true;
+                    dout = 0.0;
+                }
+                else if (testFunction(mp, functions[counter-1],
+                                      values, dout) == false) {
+                    cout << "  - generated function differs from parser"
+                         << endl;
+                    testFailed = true;
+                }
+
+                ostringstream s;
+                s.setf(ios::scientific);
+                s << setprecision(7) << dout;
+
+                // Here we add another digit in the exponent if it has only two
+                outputLine = s.str();
+                if(outputLine.size() - outputLine.find('e') == 4)
+                    outputLine.insert(outputLine.find('e') + 2, "0");
+                cout << counter << ".output: '" << outputLine << "'" << endl;
+                output = true;
+            }
+            else {
+                // Output
+                cout << counter << ".expected output: '" << line
+                     << "'" << endl;
+                if (outputLine != line)
+                    testFailed = true;
+                if (testFailed == false) {
+                    cout << counter << ".TEST PASSED" << endl;
+                }
+                else {
+                    cout << counter << ".TEST FAILED" << endl;
+                    break;
+                }
+                cout << endl;
+                counter++;
+                output = false;
+                mp->clear();
+            }
+        }
+    }
+
+    // A broken expression gives no source and stops the tool
+    {
+        CompiledExpression compiled = mp->compile("x*(y+");
+        bool passed = compiled.expressionError == 4
+                && mp->batchSource("broken").empty();
+        mp->clear();
+        const string brokenPath = "test7broken.txt";
+        {
+            ofstream broken(brokenPath);
+            broken << "# Broken" << endl << "x*(y+" << endl;
+        }
+        string command = "./pssmathaot " + brokenPath
+                + " test7broken.h 2> test7broken.log";
+        passed = passed && system(command.data()) != 0;
+        ifstream log("test7broken.log");
+        string message;
+        getline(log, message);
+        cout << "  - " << message << endl;
+        passed = passed && message.find(":2: Error:") != string::npos;
+        remove(brokenPath.data());
+        remove("test7broken.h");
+        remove("test7broken.log");
+        cout << "broken expression"
+             << (passed ? ": TEST PASSED" : ": TEST FAILED") << endl;
+        if (passed == false)
+            testFailed = true;
+    }
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+
+    // Clear used data
+    infile.close();
+    delete mp;
+    return 0;
+}
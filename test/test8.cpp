@@ -0,0 +1,181 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <string.h>
+#include "pssmathparser.h"
+#include "pssmathliteral.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// The literals are parsed when compiling, so the expressions are here and not
+// in an input file. Every literal is compared with the runtime parser.
+#define TEST_LITERAL(a_expression, ...) \
+    testLiteral(PSSMATHPARSER_LITERAL(a_expression), a_expression, \
+                vector<double>({__VA_ARGS__}))
+
+// Syntax errors are found at compile time
+static_assert(literalError<64>("2*sin(x)+y") == LiteralError::None, "");
+static_assert(literalError<64>("") == LiteralError::EmptyExpression, "");
+static_assert(literalError<64>("2*(x+1") == LiteralError::MissingParenthesis,
+              "");
+static_assert(literalError<64>("2*x)") == LiteralError::UnmatchedParenthesis,
+              "");
+static_assert(literalError<64>("2*") == LiteralError::MissingOperand, "");
+static_assert(literalError<64>("2x") == LiteralError::UnexpectedCharacter, "");
+static_assert(literalError<64>("foo(x)") == LiteralError::UnknownFunction, "");
+static_assert(literalError<64>("sin*x")
+              == LiteralError::MissingFunctionArgument, "");
+static_assert(parseLiteral<64>("x*(y+1)").errorPosition == 0, "");
+static_assert(parseLiteral<64>("x * (y+").errorPosition == 7, "");
+static_assert(PSSMATHPARSER_LITERAL("a*b+a").variableSize == 2, "");
+static_assert(PSSMATHPARSER_LITERAL("t*f+g").variableName(1) == "f", "");
+
+uint16_t counter = 1;
+
+// Compares the literal with the runtime parser bit by bit
+template <class Literal>
+bool testLiteral(const Literal &literal, const string &expression,
+                 const vector<double> &values)
+{
+    cout << counter << ".test line: '" << expression << "'" << endl;
+    counter++;
+    MathParser *mp = MathParser::makeMathParser();
+    mp->setMath(expression);
+    bool passed = true;
+    if (mp->getVariableSize() != literal.variableSize
+            || values.size() != literal.variableSize) {
+        cout << "  - number of variables differs" << endl;
+        passed = false;
+    }
+    for (size_t i = 0; passed && i < values.size(); i++) {
+        if (mp->getVariableName(uint16_t(i))
+                != string(literal.variableName(i))) {
+            cout << "  - variable " << i << " differs" << endl;
+            passed = false;
+        }
+        mp->setVariableDouble(mp->getVariableName(uint16_t(i)), values[i]);
+    }
+    if (passed) {
+        double expected = mp->calculateExpression();
+        double result = literal.calculate(values.data());
+        cout << "  - result = " << result << " expected " << expected << endl;
+        if (memcmp(&result, &expected, sizeof(double)) != 0)
+            passed = false;
+
+        // One row in batch
+        vector<const double *> columns;
+        for (size_t i = 0; i < values.size(); i++)
+            columns.push_back(&values[i]);
+        literal.calculateBatch(columns.data(), &result, 1);
+        if (memcmp(&result, &expected, sizeof(double)) != 0) {
+            cout << "  - batch differs" << endl;
+            passed = false;
+        }
+    }
+    delete mp;
+    cout << (passed ? "  TEST PASSED" : "  TEST FAILED") << endl << endl;
+    return passed;
+}
+
+// Every function and constant of the runtime parser must be in the literal
+// tables, with the same value
+bool testTables()
+{
+    bool passed = true;
+    for (const auto &iop : MathExpression::operatorMap) {
+        if (iop.second.ddFunction() == nullptr)
+            continue;
+        bool found = false;
+        for (const LiteralFunctionName &function : literalFunctions)
+            found = found || function.name == iop.first;
+        if (found == false) {
+            cout << "  - function '" << iop.first << "' missing" << endl;
+            passed = false;
+        }
+    }
+    for (const LiteralFunctionName &function : literalFunctions) {
+        auto iop = MathExpression::operatorMap.find(string(function.name));
+        if (iop == MathExpression::operatorMap.end()
+                || iop->second.ddFunction() == nullptr) {
+            cout << "  - function '" << function.name << "' unknown" << endl;
+            passed = false;
+        }
+    }
+    for (const auto &iconst : MathExpression::constantMap) {
+        bool found = false;
+        for (const LiteralConstant &constant : literalConstants) {
+            double value = iconst.second.getDoubleValue();
+            found = found || (constant.name == iconst.first
+                              && memcmp(&constant.value, &value,
+                                        sizeof(double)) == 0);
+        }
+        if (found == false) {
+            cout << "  - constant '" << iconst.first << "' differs" << endl;
+            passed = false;
+        }
+    }
+    if (MathExpression::constantMap.size()
+            != sizeof(literalConstants)/sizeof(literalConstants[0])) {
+        cout << "  - number of constants differs" << endl;
+        passed = false;
+    }
+    return passed;
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 8 ###############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool testFailed = false;
+
+    cout << "Functions and constants of the runtime parser" << endl;
+    if (testTables() == false)
+        testFailed = true;
+    cout << endl;
+
+    bool results[] = {
+        TEST_LITERAL("2 * sin( 2*pi*f*t + phi )", 50, 0.001, 0.785398),
+        TEST_LITERAL("sin(x)*cos(y)+tan(x/y)", 0.5, 1.5),
+        TEST_LITERAL("sqrt(a^2+b^2)", 3, 4),
+        TEST_LITERAL("cos(2*pi*3*t)*exp(-pi*t^2)", 0.1),
+        TEST_LITERAL("kBJ*(ToK+TC)/qe-kBeV*(ToK+TC)", 25),
+        TEST_LITERAL("3.5e-3*x^-2/(x-y)", 0.5, 0.25),
+        TEST_LITERAL("a*(b+c*(d-e*(f+g*(h-i))))",
+                     1.0, 1.1, 1.2, 1.3, 1.4, 1.5, 1.6, 1.7, 1.8),
+        TEST_LITERAL("a*-b", 2, 3),
+        TEST_LITERAL("-x^2", 2),
+        TEST_LITERAL("(-x*y)", 2, 3),
+        TEST_LITERAL("a/-2*b", 2, 3),
+        TEST_LITERAL("x^2^y", 2, 3),
+        TEST_LITERAL("x^-2^2", 2),
+        TEST_LITERAL("a-b-c", 2, 3, 4),
+        TEST_LITERAL("a/b/c", 2, 3, 4),
+        TEST_LITERAL("x--y", 2, 3),
+        TEST_LITERAL("x*(-2)", 2),
+        TEST_LITERAL("-sin(x)*invPi", 2),
+        TEST_LITERAL("1.5e+2*x+.5", 2),
+        TEST_LITERAL("0.1+0.2*x", 3),
+        TEST_LITERAL("x", 2.5),
+        TEST_LITERAL("42")
+    };
+    for (bool result : results) {
+        if (result == false)
+            testFailed = true;
+    }
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+    return 0;
+}
@@ -0,0 +1,223 @@
+#define TESTFILE "../test/input9.txt"
+#define BATCHSIZE 4000
+#define NUMTHREADS 4
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+#include <string.h>
+#include "pssmathparser.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Calculates the rows of one thread with its own context, the first half of
+// the rows one by one and the rest in one batch
+void calculateRows(shared_ptr<const Program> program,
+                   const vector<vector<double>> *columns,
+                   vector<double> *results,
+                   size_t begin, size_t end)
+{
+    EvaluationContext context(program);
+    size_t middle = (begin + end) / 2;
+    vector<double> row(columns->size());
+    for (size_t i = begin; i < middle; i++) {
+        for (size_t j = 0; j < columns->size(); j++) {
+            row[j] = (*columns)[j][i];
+        }
+        (*results)[i] = context.calculate(row.data());
+    }
+    vector<const double *> columnPointers;
+    for (size_t j = 0; j < columns->size(); j++) {
+        columnPointers.push_back((*columns)[j].data() + middle);
+    }
+    context.calculateBatch(columnPointers.data(), results->data() + middle,
+                           end - middle);
+}
+
+// Calculates the loaded expression in many threads with the given backend
+// and compares with the interpreter in one thread bit by bit
+bool testThreads(MathParser *mp, EvaluationBackend backend,
+                 const vector<double> &values, double &dout)
+{
+    uint16_t numVariables = mp->getVariableSize();
+    vector<vector<double>> columns(numVariables);
+    for (uint16_t j=0; j<numVariables; j++) {
+        for (uint32_t i=0; i<BATCHSIZE; i++) {
+            columns[j].push_back(values[j]*(1.0 + i*1.0e-4));
+        }
+    }
+
+    // Expected values from the interpreter
+    mp->setBackend(EvaluationBackend::Interpreter);
+    vector<double> expected(BATCHSIZE), results(BATCHSIZE);
+    for (uint32_t i=0; i<BATCHSIZE; i++) {
+        for (uint16_t j=0; j<numVariables; j++) {
+            mp->setVariableDouble(mp->getVariableName(j), columns[j][i]);
+        }
+        expected[i] = mp->calculateExpression();
+    }
+
+    if (mp->setBackend(backend) == false) {
+        cout << "  - backend not available, using interpreter" << endl;
+    }
+    for (uint16_t j=0; j<numVariables; j++) {
+        mp->setVariableDouble(mp->getVariableName(j), values[j]);
+    }
+    shared_ptr<const Program> program = mp->program();
+    if (mp->program() != program) {
+        cout << "  - program is not shared" << endl;
+        return false;
+    }
+    EvaluationContext context(program);
+    dout = context.calculate();
+
+    vector<thread> threads;
+    for (size_t t=0; t<NUMTHREADS; t++) {
+        threads.push_back(thread(calculateRows, program, &columns, &results,
+                                 t*BATCHSIZE/NUMTHREADS,
+                                 (t+1)*BATCHSIZE/NUMTHREADS));
+    }
+    for (thread &th : threads) {
+        th.join();
+    }
+    for (uint32_t i=0; i<BATCHSIZE; i++) {
+        if (memcmp(&results[i], &expected[i], sizeof(double)) != 0) {
+            cout << "  - row " << i << " = " << results[i]
+                 << " expected " << expected[i] << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    cout << "######################################" << endl;
+    cout << "############### TEST 9 ###############" << endl;
+    cout << "######################################" << endl;
+    cout << endl;
+    bool output = false, testFailed = false;
+
+    // Check if file exists
+    ifstream infile(TESTFILE);
+    if (infile.is_open() == false) {
+        testFailed = true;
+        cout << "Error: Could not open input file '" << TESTFILE << "'" << endl;
+        cout << endl;
+        return 1;
+    }
+
+    // Run tests
+    const EvaluationBackend backends[] = {
+        EvaluationBackend::Interpreter,
+        EvaluationBackend::Jit,
+        EvaluationBackend::SystemCompiler
+    };
+    const char *backendNames[] = { "interpreter", "jit", "compiler" };
+    string line, variableName, variableValue;
+    vector<string> outputLines;
+    vector<double> values;
+    double dout;
+    bool readingValue=false;
+    MathParser *mp = MathParser::makeMathParser();
+    uint16_t counter = 1, numVariables=0;
+    while(getline(infile, line)) {
+        if(line[0] != '#') {
+            if(output == false) {
+                // Input
+                cout << counter << ".test line: '" << line << "'" << endl;
+                mp->setMath(line);
+
+                // Get number of variables
+                numVariables = mp->getVariableSize();
+
+                // Read variables, ordered as in the expression
+                values.assign(numVariables, 0.0);
+                for(uint16_t i=0; i<numVariables; i++) {
+                    readingValue = false;
+                    getline(infile, line);
+                    variableName.clear();
+                    variableValue.clear();
+                    for(uint16_t j=0; j<line.size(); j++) {
+                        if(readingValue == true) {
+                            variableValue += line[j];
+                        }
+                        else if (line[j] != '=') {
+                            variableName += line[j];
+                        }
+                        else if (line[j] == '='){
+                            readingValue = true;
+                        }
+                    }
+                    for(uint16_t j=0; j<numVariables; j++) {
+                        if (mp->getVariableName(j) == variableName)
+                            values[j] = atof(variableValue.data());
+                    }
+                }
+
+                // Calculate the expression with every backend
+                outputLines.clear();
+                for (size_t b=0; b<sizeof(backends)/sizeof(backends[0]); b++) {
+                    if (testThreads(mp, backends[b], values, dout) == false) {
+                        cout << "  - " << backendNames[b]
+                             << " threads differ from interpreter" << endl;
+                        testFailed = true;
+                    }
+
+                    ostringstream s;
+                    s.setf(ios::scientific);
+                    s << setprecision(7) << dout;
+
+                    // Here we add another digit in the exponent if it has
+                    // only two
+                    string stmp = s.str();
+                    if(stmp.size() - stmp.find('e') == 4)
+                        stmp.insert(stmp.find('e') + 2, "0");
+                    outputLines.push_back(stmp);
+                    cout << "  - result (" << backendNames[b] << ") = "
+                         << stmp.data() << endl;
+                }
+                output = true;
+            }
+            else {
+                // Output
+                cout << counter << ".expected output: '" << line
+                     << "'" << endl;
+                for (const string &outputLine : outputLines) {
+                    if (outputLine != line)
+                        testFailed = true;
+                }
+                if (testFailed == false) {
+                    cout << counter << ".TEST PASSED" << endl;
+                }
+                else {
+                    cout << counter << ".TEST FAILED" << endl;
+                    break;
+                }
+                cout << endl;
+                counter++;
+                output = false;
+                mp->clear();
+            }
+        }
+    }
+
+    // Test summary
+    cout << endl;
+    cout << "######################################" << endl;
+    if (testFailed) {
+        cout << "#### TEST SUMMARY: TESTING FAILED ####" << endl;
+    }
+    else {
+        cout << "### TEST SUMMARY: ALL TESTS PASSED ###" << endl;
+    }
+    cout << "######################################" << endl << endl;
+
+    // Clear used data
+    infile.close();
+    delete mp;
+    return 0;
+}
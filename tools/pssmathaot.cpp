@@ -0,0 +1,176 @@
+/**
+ *  @file pssmathaot.cpp
+ *  @brief Ahead-of-time compiler of PssMathParser expressions
+ *  @details Reads an expression file in the style of test/inputN.txt and
+ *  writes a C++ header with one inline function per expression. The functions
+ *  have the signature of MathParser::calculateBatch():
+ *
+ *  ```
+ *  pssmathaot [-n namespace] [-p prefix] input.txt [output.h]
+ *  ```
+ *
+ *  Lines starting with `#` are comments. Every expression is followed by one
+ *  `name=value` line per variable and by the expected output line, both are
+ *  skipped here. The functions are named prefix1, prefix2... (default prefix
+ *  is `expression`). Without the output file the header goes to stdout.
+ *  @date  Oct 18 2026
+ *  @author Ginko Balboa
+ *  @copyright
+ *  This file is part of PssMathParser.
+ *
+ *  PssMathParser is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PssMathParser is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with PssMathParser.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <fstream>
+#include <ctype.h>
+#include "pssmathparser.h"
+
+using namespace std;
+using namespace PssMathParser;
+
+// Prints how to call the tool
+void printUsage(const char *a_name)
+{
+    cerr << "Usage: " << a_name
+         << " [-n namespace] [-p prefix] input.txt [output.h]" << endl;
+}
+
+// Makes the name of the include guard from the output path
+string includeGuard(const string &a_path)
+{
+    string guard;
+    size_t start = a_path.find_last_of('/');
+    start = (start == string::npos) ? 0 : start + 1;
+    for (size_t i = start; i < a_path.size(); i++) {
+        char c = a_path[i];
+        guard += isalnum((unsigned char)c) ? char(toupper(c)) : '_';
+    }
+    if (guard.empty() || isdigit((unsigned char)guard[0]))
+        guard.insert(0, "PSSMATHAOT_");
+    return guard;
+}
+
+int main(int argc, char *argv[])
+{
+    string nameSpace, prefix("expression"), inputPath, outputPath;
+    for (int i = 1; i < argc; i++) {
+        string arg(argv[i]);
+        if ((arg == "-n" || arg == "-p") && i + 1 < argc) {
+            (arg == "-n" ? nameSpace : prefix) = argv[++i];
+        }
+        else if (arg[0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        }
+        else if (inputPath.empty()) {
+            inputPath = arg;
+        }
+        else if (outputPath.empty()) {
+            outputPath = arg;
+        }
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (inputPath.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    ifstream infile(inputPath);
+    if (infile.is_open() == false) {
+        cerr << "Error: Could not open input file '" << inputPath << "'"
+             << endl;
+        return 1;
+    }
+
+    // Translate the expressions
+    ostringstream functions;
+    string line;
+    MathParser *mp = MathParser::makeMathParser();
+    uint16_t counter = 1;
+    size_t lineNumber = 0;
+    while (getline(infile, line)) {
+        lineNumber++;
+        if (line.empty() == false && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || line[0] == '#')
+            continue;
+        // Loads the expression as setMath() does and tells its error
+        CompiledExpression compiled = mp->compile(line);
+        if (compiled.program == nullptr) {
+            cerr << inputPath << ":" << lineNumber << ": Error: "
+                 << (compiled.errorString.empty()
+                     ? string("The expression can't be compiled")
+                     : compiled.errorString)
+                 << " '" << line << "'" << endl;
+            delete mp;
+            return 1;
+        }
+        string source = mp->batchSource(prefix + to_string(counter));
+        if (source.empty()) {
+            cerr << "Error: Could not translate expression " << counter
+                 << " '" << line << "'" << endl;
+            delete mp;
+            return 1;
+        }
+        functions << source << endl;
+
+        // Skip the variables and the expected output
+        for (uint16_t i = 0; i <= mp->getVariableSize(); i++) {
+            getline(infile, line);
+            lineNumber++;
+        }
+        mp->clear();
+        counter++;
+    }
+    delete mp;
+
+    // Write the header
+    string guard = includeGuard(outputPath.empty() ? inputPath + ".h"
+                                                   : outputPath);
+    ostringstream header;
+    header << "/**" << endl
+           << " *  @file " << (outputPath.empty() ? string("stdout")
+                                                 : outputPath) << endl
+           << " *  @brief Generated by pssmathaot from " << inputPath << endl
+           << " **/" << endl << endl
+           << "#ifndef " << guard << endl
+           << "#define " << guard << endl << endl
+           << "#include <math.h>" << endl
+           << "#include <stddef.h>" << endl << endl;
+    if (nameSpace.empty() == false)
+        header << "namespace " << nameSpace << " {" << endl << endl;
+    header << functions.str();
+    if (nameSpace.empty() == false)
+        header << "}" << endl << endl;
+    header << "#endif // " << guard << endl;
+
+    if (outputPath.empty()) {
+        cout << header.str();
+        return 0;
+    }
+    ofstream outfile(outputPath);
+    if (outfile.is_open() == false) {
+        cerr << "Error: Could not open output file '" << outputPath << "'"
+             << endl;
+        return 1;
+    }
+    outfile << header.str();
+    return 0;
+}